@@ -0,0 +1,96 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXFormat/Util.h>
+
+#include <MaterialXGenShader/Util.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+std::atomic<size_t> allocationCount(0);
+std::atomic<size_t> allocationBytes(0);
+
+} // anonymous namespace
+
+// Replace the global allocation functions of the benchmark executable, so
+// that benchmarks can report the heap allocations made by library code.
+void* operator new(size_t size)
+{
+    allocationCount++;
+    allocationBytes += size;
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+namespace BenchmarkUtil
+{
+
+size_t getAllocationCount()
+{
+    return allocationCount;
+}
+
+size_t getAllocationBytes()
+{
+    return allocationBytes;
+}
+
+std::vector<mx::FilePath> getLibraryFiles()
+{
+    mx::FilePath librariesPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    std::vector<mx::FilePath> libraryFiles;
+    for (std::string library : { "stdlib", "pbrlib", "bxdf" })
+    {
+        mx::StringVec filenames;
+        mx::getFilesInDirectory(librariesPath / library, filenames, "mtlx");
+        for (const std::string& filename : filenames)
+        {
+            libraryFiles.push_back(librariesPath / library / filename);
+        }
+    }
+    return libraryFiles;
+}
+
+void loadLibraries(const mx::StringVec& libraryNames, mx::DocumentPtr doc)
+{
+    mx::FilePath librariesPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    std::vector<mx::FilePath> libraryFiles;
+    for (const std::string& library : libraryNames)
+    {
+        mx::StringVec libraryPaths;
+        mx::getSubDirectories(librariesPath / library, libraryPaths);
+        for (const std::string& path : libraryPaths)
+        {
+            mx::StringVec filenames;
+            mx::getFilesInDirectory(path, filenames, "mtlx");
+            for (const std::string& filename : filenames)
+            {
+                libraryFiles.push_back(mx::FilePath(path) / filename);
+            }
+        }
+    }
+
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+    mx::loadLibraries(libraryFiles, doc, &copyOptions);
+}
+
+} // namespace BenchmarkUtil
@@ -0,0 +1,71 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef BENCHMARK_UTIL_H
+#define BENCHMARK_UTIL_H
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <cstddef>
+
+namespace mx = MaterialX;
+
+namespace BenchmarkUtil
+{
+    //
+    // Return the stdlib, pbrlib and bxdf data library files, which are
+    // loaded by library benchmarks.
+    //
+    std::vector<mx::FilePath> getLibraryFiles();
+
+    //
+    // Load all data library files below the given library folders,
+    // including their shader generation implementations.
+    //
+    void loadLibraries(const mx::StringVec& libraryNames, mx::DocumentPtr doc);
+
+    //
+    // Return the number of heap allocations made through operator new
+    // since the process started.
+    //
+    size_t getAllocationCount();
+
+    //
+    // Return the total number of bytes requested through operator new
+    // since the process started.
+    //
+    size_t getAllocationBytes();
+
+    //
+    // Records the heap allocations made during its lifetime.
+    //
+    class AllocationCounter
+    {
+      public:
+        AllocationCounter() :
+            _startCount(getAllocationCount()),
+            _startBytes(getAllocationBytes())
+        {
+        }
+
+        size_t getCount() const
+        {
+            return getAllocationCount() - _startCount;
+        }
+
+        size_t getBytes() const
+        {
+            return getAllocationBytes() - _startBytes;
+        }
+
+      private:
+        size_t _startCount;
+        size_t _startBytes;
+    };
+}
+
+#endif
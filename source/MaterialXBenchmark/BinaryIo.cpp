@@ -0,0 +1,67 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Binary load benchmark", "[binaryio]")
+{
+    const int LOAD_COUNT = 10;
+
+    // Write a binary copy of each data library.
+    std::vector<mx::FilePath> libraryFiles = BenchmarkUtil::getLibraryFiles();
+    std::vector<std::string> binaryFiles;
+    for (const mx::FilePath& file : libraryFiles)
+    {
+        mx::DocumentPtr libDoc = mx::createDocument();
+        mx::readFromXmlFile(libDoc, file);
+        binaryFiles.push_back(file.getBaseName() + ".bin");
+        mx::writeToBinaryFile(libDoc, binaryFiles.back());
+    }
+
+    for (bool binary : { false, true })
+    {
+        size_t allocationCount = 0;
+        std::chrono::duration<double> duration(0.0);
+        for (int i = 0; i < LOAD_COUNT; i++)
+        {
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            BenchmarkUtil::AllocationCounter counter;
+            mx::DocumentPtr doc = mx::createDocument();
+            for (size_t j = 0; j < libraryFiles.size(); j++)
+            {
+                if (binary)
+                {
+                    mx::readFromBinaryFile(doc, binaryFiles[j]);
+                }
+                else
+                {
+                    mx::readFromXmlFile(doc, libraryFiles[j]);
+                }
+            }
+            allocationCount += counter.getCount();
+            duration += std::chrono::system_clock::now() - start;
+        }
+
+        std::cout << "Binary load benchmark (" << (binary ? "binary" : "xml") << "): " <<
+                     allocationCount / LOAD_COUNT << " allocations, " <<
+                     duration.count() / LOAD_COUNT << " seconds per load" << std::endl;
+    }
+
+    for (const std::string& binaryFile : binaryFiles)
+    {
+        std::remove(binaryFile.c_str());
+    }
+}
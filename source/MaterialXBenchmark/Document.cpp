@@ -0,0 +1,60 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Document cache benchmark", "[document]")
+{
+    const int NODE_COUNT = 20000;
+    const int EDIT_COUNT = 2000;
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    std::vector<mx::NodePtr> nodes;
+    for (int i = 0; i < NODE_COUNT; i++)
+    {
+        std::string category = "category" + std::to_string(i);
+        mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_" + category, "float", category);
+        nodeDef->addInput("in", "float");
+        doc->addImplementation("IM_" + category)->setNodeDef(nodeDef);
+        mx::NodePtr node = nodeGraph->addNode(category, "node" + std::to_string(i), "float");
+        mx::InputPtr input = node->addInput("in", "float");
+        if (!nodes.empty())
+        {
+            input->setNodeName(nodes.back()->getName());
+        }
+        nodes.push_back(node);
+    }
+
+    // Interleave attribute edits with cache lookups.
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    for (int i = 0; i < EDIT_COUNT; i++)
+    {
+        mx::NodePtr node = nodes[(i * 7919) % NODE_COUNT];
+        mx::InputPtr input = node->getInput("in");
+        if (i % 2)
+        {
+            input->setValue((float) i);
+        }
+        else if (input->hasNodeName())
+        {
+            input->setNodeName(nodes[i % NODE_COUNT]->getName());
+        }
+        REQUIRE(node->getNodeDef() != nullptr);
+        REQUIRE(node->getNodeDef()->getImplementation() != nullptr);
+    }
+    std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+
+    std::cout << "Document cache benchmark: " << EDIT_COUNT << " edits and lookups over " <<
+                 NODE_COUNT << " nodes in " << duration.count() << " seconds" << std::endl;
+}
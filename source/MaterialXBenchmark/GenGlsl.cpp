@@ -0,0 +1,79 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <MaterialXGenGlsl/GlslShaderGenerator.h>
+
+#include <MaterialXGenShader/Util.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+TEST_CASE("GenShader: GLSL source file benchmark", "[genglsl]")
+{
+    const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite/stdlib");
+    const mx::FilePath libSearchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+
+    mx::DocumentPtr libraries = mx::createDocument();
+    BenchmarkUtil::loadLibraries({ "stdlib", "pbrlib" }, libraries);
+
+    // Gather the renderable elements of the stdlib test suite.
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::loadDocuments(testRootPath, { "_options.mtlx" }, documents, documentPaths);
+    mx::XmlReadOptions importOptions;
+    importOptions.skipDuplicateElements = true;
+    std::vector<mx::TypedElementPtr> elements;
+    for (mx::DocumentPtr doc : documents)
+    {
+        doc->importLibrary(libraries, &importOptions);
+        mx::findRenderableElements(doc, elements);
+    }
+
+    // Generate each shader in a new context, as a batch job would, either
+    // clearing the source file cache before each shader to model uncached
+    // reads, or sharing the cache across all shaders.
+    for (bool cached : { false, true })
+    {
+        mx::clearSourceFileCache();
+        size_t readCount = mx::getSourceFileReadCount();
+        size_t shaderCount = 0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (mx::TypedElementPtr element : elements)
+        {
+            if (!cached)
+            {
+                mx::clearSourceFileCache();
+            }
+            mx::GenContext context(mx::GlslShaderGenerator::create());
+            context.registerSourceCodeSearchPath(libSearchPath);
+            try
+            {
+                context.getShaderGenerator().generate(element->getName(), element, context);
+                shaderCount++;
+            }
+            catch (mx::Exception&)
+            {
+            }
+        }
+        std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+        readCount = mx::getSourceFileReadCount() - readCount;
+
+        std::cout << "GLSL source file benchmark (" << (cached ? "cached" : "uncached") << "): " <<
+                     shaderCount << " shaders, " <<
+                     (double) readCount / std::max(shaderCount, (size_t) 1) << " file reads per shader, " <<
+                     duration.count() / std::max(shaderCount, (size_t) 1) << " seconds per shader" << std::endl;
+    }
+}
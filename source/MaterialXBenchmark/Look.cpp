@@ -0,0 +1,136 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// Return the material assignments that bind the given material to the given
+// geometry string, by scanning all looks of the document.
+std::vector<mx::MaterialAssignPtr> scanGeometryBindings(mx::MaterialPtr material, const std::string& geom)
+{
+    std::vector<mx::MaterialAssignPtr> matAssigns;
+    for (mx::LookPtr look : material->getDocument()->getLooks())
+    {
+        for (mx::MaterialAssignPtr matAssign : look->getMaterialAssigns())
+        {
+            if (matAssign->getReferencedMaterial() == material)
+            {
+                mx::CollectionPtr coll = matAssign->getCollection();
+                if (mx::geomStringsMatch(geom, matAssign->getActiveGeom()) ||
+                    (coll && coll->matchesGeomString(geom)))
+                {
+                    matAssigns.push_back(matAssign);
+                }
+            }
+        }
+    }
+    return matAssigns;
+}
+
+// Return a random geometry path with up to the given depth.
+std::string randomGeomPath(std::mt19937& rng, size_t maxDepth, size_t branching)
+{
+    std::string path;
+    size_t depth = 1 + rng() % maxDepth;
+    for (size_t i = 0; i < depth; i++)
+    {
+        path += "/node" + std::to_string(rng() % branching);
+    }
+    return path;
+}
+
+// Add random looks, collections and material assignments to a document.
+void addRandomAssignments(mx::DocumentPtr doc, std::mt19937& rng, size_t assignCount, size_t maxDepth, size_t branching)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        doc->addMaterial("material" + std::to_string(i));
+    }
+    std::vector<mx::CollectionPtr> collections;
+    for (size_t i = 0; i < assignCount / 4 + 1; i++)
+    {
+        mx::CollectionPtr collection = doc->addCollection("collection" + std::to_string(i));
+        collection->setIncludeGeom(randomGeomPath(rng, maxDepth, branching) + ", " + randomGeomPath(rng, maxDepth, branching));
+        if (rng() % 2)
+        {
+            collection->setExcludeGeom(randomGeomPath(rng, maxDepth + 1, branching));
+        }
+        if (!collections.empty() && rng() % 3 == 0)
+        {
+            collection->setIncludeCollection(collections[rng() % collections.size()]);
+        }
+        collections.push_back(collection);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        mx::LookPtr look = doc->addLook("look" + std::to_string(i));
+        for (size_t j = 0; j < assignCount / 2; j++)
+        {
+            mx::MaterialAssignPtr matAssign = look->addMaterialAssign("", "material" + std::to_string(rng() % 3));
+            if (rng() % 2)
+            {
+                matAssign->setGeom(rng() % 50 ? randomGeomPath(rng, maxDepth, branching) : mx::UNIVERSAL_GEOM_NAME);
+            }
+            else
+            {
+                matAssign->setCollection(collections[rng() % collections.size()]);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("Geometry binding benchmark", "[look]")
+{
+    const size_t ASSIGN_COUNT = 1000;
+    const size_t GEOM_COUNT = 5000;
+
+    mx::DocumentPtr doc = mx::createDocument();
+    std::mt19937 rng(1);
+    addRandomAssignments(doc, rng, ASSIGN_COUNT, 8, 4);
+    mx::StringVec geoms;
+    for (size_t i = 0; i < GEOM_COUNT; i++)
+    {
+        geoms.push_back(randomGeomPath(rng, 10, 4));
+    }
+    mx::MaterialPtr material = doc->getMaterial("material0");
+
+    for (bool indexed : { false, true })
+    {
+        size_t bindingCount = 0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        if (indexed)
+        {
+            for (const std::vector<mx::MaterialAssignPtr>& bindings : doc->getGeomBindingIndex()->getMaterialAssigns(geoms, material))
+            {
+                bindingCount += bindings.size();
+            }
+        }
+        else
+        {
+            for (const std::string& geom : geoms)
+            {
+                bindingCount += scanGeometryBindings(material, geom).size();
+            }
+        }
+        std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+
+        std::cout << "Geometry binding benchmark (" << (indexed ? "indexed" : "scan") << "): " <<
+                     GEOM_COUNT << " geometries against " << ASSIGN_COUNT << " assignments, " <<
+                     bindingCount << " bindings, " << duration.count() << " seconds" << std::endl;
+    }
+}
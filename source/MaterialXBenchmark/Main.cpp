@@ -0,0 +1,21 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#define CATCH_CONFIG_RUNNER
+#include <MaterialXTest/Catch/catch.hpp>
+
+int main(int argc, char* const argv[])
+{
+    Catch::Session session;
+    session.configData().showDurations = Catch::ShowDurations::Always;
+
+    int returnCode = session.applyCommandLine(argc, argv);
+    if (returnCode != 0)
+    {
+        return returnCode;
+    }
+
+    return session.run();
+}
@@ -0,0 +1,112 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXCore/Definition.h>
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// Resolve the nodedef of a node by scanning all matching nodedefs.
+mx::NodeDefPtr scanNodeDefs(mx::NodePtr node, const std::string& target = mx::EMPTY_STRING)
+{
+    if (node->hasNodeDefString())
+    {
+        return node->getDocument()->getNodeDef(node->getNodeDefString());
+    }
+    mx::DocumentPtr doc = node->getDocument();
+    std::vector<mx::NodeDefPtr> nodeDefs = doc->getMatchingNodeDefs(node->getQualifiedName(node->getCategory()));
+    std::vector<mx::NodeDefPtr> secondary = doc->getMatchingNodeDefs(node->getCategory());
+    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
+    for (mx::NodeDefPtr nodeDef : nodeDefs)
+    {
+        if (mx::targetStringsMatch(nodeDef->getTarget(), target) &&
+            nodeDef->isVersionCompatible(node) &&
+            node->isTypeCompatible(nodeDef))
+        {
+            return nodeDef;
+        }
+    }
+    return nullptr;
+}
+
+// Add an instance of each nodedef in the library to the given graph, with
+// the node category, type and inputs of the nodedef but no nodedef string.
+void addNodeDefInstances(mx::GraphElementPtr graph, mx::ConstDocumentPtr library)
+{
+    for (mx::NodeDefPtr nodeDef : library->getNodeDefs())
+    {
+        mx::NodePtr node = graph->addNode(nodeDef->getNodeString(), mx::EMPTY_STRING, nodeDef->getType());
+        for (mx::InputPtr input : nodeDef->getActiveInputs())
+        {
+            node->addInput(input->getName(), input->getType());
+        }
+        for (mx::ParameterPtr param : nodeDef->getActiveParameters())
+        {
+            node->addParameter(param->getName(), param->getType());
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("NodeDef resolution benchmark", "[node]")
+{
+    const int RESOLVE_COUNT = 20;
+
+    mx::DocumentPtr library = mx::createDocument();
+    for (const mx::FilePath& file : BenchmarkUtil::getLibraryFiles())
+    {
+        mx::readFromXmlFile(library, file);
+    }
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->importLibrary(library);
+    mx::NodeGraphPtr graph = doc->addNodeGraph();
+    addNodeDefInstances(graph, library);
+    std::vector<mx::NodePtr> nodes = graph->getNodes();
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int i = 0; i < RESOLVE_COUNT; i++)
+        {
+            if (mode == 0)
+            {
+                for (mx::NodePtr node : nodes)
+                {
+                    scanNodeDefs(node);
+                }
+            }
+            else if (mode == 1)
+            {
+                for (mx::NodePtr node : nodes)
+                {
+                    node->getNodeDef();
+                }
+            }
+            else
+            {
+                graph->getNodeDefsForNodes();
+            }
+        }
+        std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+
+        const char* modeNames[] = { "scan", "memoized", "bulk" };
+        std::cout << "NodeDef resolution benchmark (" << modeNames[mode] << "): " <<
+                     nodes.size() << " nodes, " <<
+                     duration.count() / (RESOLVE_COUNT * nodes.size()) << " seconds per node" << std::endl;
+    }
+}
@@ -0,0 +1,131 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXRender/Handlers/TinyObjLoader.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// Load the bundled OBJ assets.
+mx::MeshList loadGeometryAssets()
+{
+    mx::TinyObjLoaderPtr loader = mx::TinyObjLoader::create();
+    mx::MeshList meshes;
+    for (const char* filename : { "plane.obj", "sphere.obj", "teapot.obj", "shaderball.obj" })
+    {
+        loader->load(mx::FilePath("resources/Geometry") / mx::FilePath(filename), meshes);
+    }
+    return meshes;
+}
+
+// Return a mesh holding the given number of copies of the given mesh, with
+// the texture coordinates of each copy offset into a different UDIM.
+mx::MeshPtr createScaledMesh(mx::MeshPtr mesh, size_t copyCount)
+{
+    mx::MeshPtr scaled = mx::Mesh::create(mesh->getIdentifier());
+    size_t vertexCount = mesh->getVertexCount();
+    for (const std::string& type : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE, mx::MeshStream::TEXCOORD_ATTRIBUTE })
+    {
+        mx::MeshStreamPtr stream = mesh->getStream(type, 0);
+        mx::MeshStreamPtr scaledStream = mx::MeshStream::create(stream->getName(), type, 0);
+        scaledStream->setStride(stream->getStride());
+        for (size_t copy = 0; copy < copyCount; copy++)
+        {
+            mx::MeshFloatBuffer& data = scaledStream->getData();
+            data.insert(data.end(), stream->getData().begin(), stream->getData().end());
+            if (type == mx::MeshStream::TEXCOORD_ATTRIBUTE)
+            {
+                for (size_t i = data.size() - stream->getData().size(); i < data.size(); i += stream->getStride())
+                {
+                    data[i] += (float) (copy % 10);
+                }
+            }
+        }
+        scaled->addStream(scaledStream);
+    }
+    for (size_t copy = 0; copy < copyCount; copy++)
+    {
+        for (size_t p = 0; p < mesh->getPartitionCount(); p++)
+        {
+            mx::MeshPartitionPtr part = mesh->getPartition(p);
+            mx::MeshPartitionPtr scaledPart = mx::MeshPartition::create();
+            scaledPart->setIdentifier(part->getIdentifier());
+            for (unsigned int index : part->getIndices())
+            {
+                scaledPart->getIndices().push_back(index + (unsigned int) (copy * vertexCount));
+            }
+            scaledPart->setFaceCount(part->getFaceCount());
+            scaled->addPartition(scaledPart);
+        }
+    }
+    scaled->setVertexCount(vertexCount * copyCount);
+    return scaled;
+}
+
+size_t getTotalFaceCount(mx::MeshPtr mesh)
+{
+    size_t faceCount = 0;
+    for (size_t p = 0; p < mesh->getPartitionCount(); p++)
+    {
+        faceCount += mesh->getPartition(p)->getFaceCount();
+    }
+    return faceCount;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Render: Mesh preprocessing benchmark", "[render]")
+{
+    const int PROCESS_COUNT = 5;
+
+    mx::MeshList meshes = loadGeometryAssets();
+    for (size_t copyCount : { 1, 8, 64 })
+    {
+        size_t faceCount = 0;
+        std::chrono::duration<double> tangentDuration(0.0);
+        std::chrono::duration<double> boundsDuration(0.0);
+        std::chrono::duration<double> partitionDuration(0.0);
+        for (mx::MeshPtr asset : meshes)
+        {
+            mx::MeshPtr mesh = createScaledMesh(asset, copyCount);
+            mx::MeshStreamPtr tangents = mx::MeshStream::create("tangent", mx::MeshStream::TANGENT_ATTRIBUTE, 0);
+            mx::MeshStreamPtr bitangents = mx::MeshStream::create("bitangent", mx::MeshStream::BITANGENT_ATTRIBUTE, 0);
+            faceCount += getTotalFaceCount(mesh) * PROCESS_COUNT;
+            for (int i = 0; i < PROCESS_COUNT; i++)
+            {
+                std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+                mesh->generateTangents(mesh->getStream(mx::MeshStream::POSITION_ATTRIBUTE, 0),
+                                       mesh->getStream(mx::MeshStream::TEXCOORD_ATTRIBUTE, 0),
+                                       mesh->getStream(mx::MeshStream::NORMAL_ATTRIBUTE, 0),
+                                       tangents, bitangents);
+                tangentDuration += std::chrono::system_clock::now() - start;
+
+                start = std::chrono::system_clock::now();
+                mesh->computeBounds();
+                boundsDuration += std::chrono::system_clock::now() - start;
+
+                start = std::chrono::system_clock::now();
+                mesh->splitByUdims();
+                mesh->mergePartitions();
+                partitionDuration += std::chrono::system_clock::now() - start;
+            }
+        }
+
+        double megaFaces = faceCount / 1.0e6;
+        std::cout << "Mesh preprocessing benchmark (" << copyCount << " copies): " <<
+                     faceCount / PROCESS_COUNT << " faces, " <<
+                     tangentDuration.count() / megaFaces << " seconds per million faces for tangents, " <<
+                     boundsDuration.count() / megaFaces << " for bounds, " <<
+                     partitionDuration.count() / megaFaces << " for partitions" << std::endl;
+    }
+}
@@ -0,0 +1,93 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/XmlIo.h>
+
+#include <MaterialXGenShader/Util.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Traversal benchmark", "[traversal]")
+{
+    const int TRAVERSAL_COUNT = 20;
+
+    // Gather the graph outputs of the test suite, with the data libraries
+    // imported so that node graph implementations are traversed as well.
+    mx::DocumentPtr libraries = mx::createDocument();
+    for (const mx::FilePath& file : BenchmarkUtil::getLibraryFiles())
+    {
+        mx::readFromXmlFile(libraries, file);
+    }
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::loadDocuments(mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite"), {}, documents, documentPaths);
+    documents.push_back(libraries);
+    std::vector<mx::OutputPtr> outputs;
+    for (mx::DocumentPtr doc : documents)
+    {
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            mx::OutputPtr output = elem->asA<mx::Output>();
+            if (output && !output->hasUpstreamCycle())
+            {
+                outputs.push_back(output);
+            }
+        }
+    }
+
+    // Traverse each output either through edges, as a range-based for loop
+    // would, or through the raw element accessors of the iterator.
+    for (bool raw : { false, true })
+    {
+        size_t edgeCount = 0;
+        size_t nodeCount = 0;
+        BenchmarkUtil::AllocationCounter allocations;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int i = 0; i < TRAVERSAL_COUNT; i++)
+        {
+            for (mx::OutputPtr output : outputs)
+            {
+                for (mx::GraphIterator it = output->traverseGraph().begin(); it != mx::GraphIterator::end(); ++it)
+                {
+                    edgeCount++;
+                    if (raw)
+                    {
+                        mx::Element* upstreamElem = it.getUpstreamElementRaw();
+                        if (upstreamElem && upstreamElem->isA<mx::Node>())
+                        {
+                            nodeCount++;
+                        }
+                    }
+                    else
+                    {
+                        mx::Edge edge = *it;
+                        mx::ElementPtr upstreamElem = edge.getUpstreamElement();
+                        if (upstreamElem && upstreamElem->isA<mx::Node>())
+                        {
+                            nodeCount++;
+                        }
+                    }
+                }
+            }
+        }
+        std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+        REQUIRE(nodeCount <= edgeCount);
+
+        std::cout << "Traversal benchmark (" << (raw ? "raw" : "edges") << "): " <<
+                     outputs.size() << " outputs, " <<
+                     edgeCount / TRAVERSAL_COUNT << " edges, " <<
+                     duration.count() / std::max(edgeCount, (size_t) 1) << " seconds per edge, " <<
+                     allocations.getCount() / (double) std::max(edgeCount, (size_t) 1) << " allocations per edge" << std::endl;
+    }
+}
@@ -0,0 +1,115 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXCore/Document.h>
+#include <MaterialXCore/Value.h>
+
+#include <MaterialXFormat/XmlIo.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Value string benchmark", "[value]")
+{
+    const int VALUE_COUNT = 100000;
+
+    std::vector<mx::ValuePtr> values;
+    for (int i = 0; i < VALUE_COUNT; i++)
+    {
+        float f = (float) i / VALUE_COUNT;
+        values.push_back(mx::Value::createValue(mx::Color3(f, f * 0.5f, f * 0.25f)));
+    }
+
+    BenchmarkUtil::AllocationCounter allocations;
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    size_t length = 0;
+    for (mx::ValuePtr value : values)
+    {
+        length += value->getValueString().size();
+    }
+    std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+    REQUIRE(length > 0);
+
+    std::cout << "Value string benchmark (format): " <<
+                 duration.count() / VALUE_COUNT << " seconds, " <<
+                 (double) allocations.getCount() / VALUE_COUNT << " allocations per value" << std::endl;
+}
+
+TEST_CASE("Value parsing benchmark", "[value]")
+{
+    const int PARSE_COUNT = 100000;
+    const int SWEEP_COUNT = 20;
+
+    // Parse representative value strings.
+    const std::string color3String = "0.18, 0.5, 0.99";
+    const std::string vector4String = "1, -0.25, 1e-3, 4.5";
+    const std::string matrix44String = "1, 0, 0, 0, 0, 0.5, 0, 0, 0, 0, 2, 0, 0.1, 0.2, 0.3, 1";
+    for (int mode = 0; mode < 3; mode++)
+    {
+        float sum = 0.0f;
+        BenchmarkUtil::AllocationCounter allocations;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int i = 0; i < PARSE_COUNT; i++)
+        {
+            if (mode == 0)
+            {
+                sum += mx::fromValueString<mx::Color3>(color3String)[0];
+            }
+            else if (mode == 1)
+            {
+                sum += mx::fromValueString<mx::Vector4>(vector4String)[0];
+            }
+            else
+            {
+                sum += mx::fromValueString<mx::Matrix44>(matrix44String)[0][0];
+            }
+        }
+        std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+        REQUIRE(sum > 0.0f);
+
+        const char* modeNames[] = { "color3", "vector4", "matrix44" };
+        std::cout << "Value parsing benchmark (" << modeNames[mode] << "): " <<
+                     duration.count() / PARSE_COUNT << " seconds, " <<
+                     (double) allocations.getCount() / PARSE_COUNT << " allocations per value" << std::endl;
+    }
+
+    // Parse the values of all value elements in the data libraries.
+    mx::DocumentPtr library = mx::createDocument();
+    for (const mx::FilePath& file : BenchmarkUtil::getLibraryFiles())
+    {
+        mx::readFromXmlFile(library, file);
+    }
+    std::vector<mx::ValueElementPtr> valueElements;
+    for (mx::ElementPtr elem : library->traverseTree())
+    {
+        mx::ValueElementPtr valueElem = elem->asA<mx::ValueElement>();
+        if (valueElem && valueElem->hasValue())
+        {
+            valueElements.push_back(valueElem);
+        }
+    }
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    size_t valueCount = 0;
+    for (int i = 0; i < SWEEP_COUNT; i++)
+    {
+        for (mx::ValueElementPtr valueElem : valueElements)
+        {
+            if (valueElem->getValue())
+            {
+                valueCount++;
+            }
+        }
+    }
+    std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+    REQUIRE(valueCount > 0);
+
+    std::cout << "Value parsing benchmark (library): " << valueElements.size() << " values, " <<
+                 duration.count() / (SWEEP_COUNT * valueElements.size()) << " seconds per value" << std::endl;
+}
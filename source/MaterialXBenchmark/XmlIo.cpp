@@ -0,0 +1,229 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXBenchmark/BenchmarkUtil.h>
+
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// Import the given library files into a document, reading them serially
+// without the library cache.
+void importLibraryFiles(const std::vector<mx::FilePath>& libraryFiles, mx::DocumentPtr doc)
+{
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+    for (const mx::FilePath& file : libraryFiles)
+    {
+        mx::DocumentPtr libDoc = mx::createDocument();
+        mx::readFromXmlFile(libDoc, file);
+        libDoc->setSourceUri(file);
+        doc->importLibrary(libDoc, &copyOptions);
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("Library storage benchmark", "[xmlio]")
+{
+    const int LOAD_COUNT = 10;
+
+    std::vector<mx::FilePath> libraryFiles = BenchmarkUtil::getLibraryFiles();
+    REQUIRE(!libraryFiles.empty());
+
+    for (bool arenaStorage : { false, true })
+    {
+        size_t allocationCount = 0;
+        size_t allocationBytes = 0;
+        std::chrono::duration<double> duration(0.0);
+        for (int i = 0; i < LOAD_COUNT; i++)
+        {
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            BenchmarkUtil::AllocationCounter counter;
+            {
+                mx::DocumentPtr doc = mx::createDocument();
+                if (arenaStorage)
+                {
+                    doc->enableArenaStorage();
+                }
+                for (const mx::FilePath& file : libraryFiles)
+                {
+                    mx::readFromXmlFile(doc, file);
+                }
+                allocationCount += counter.getCount();
+                allocationBytes += counter.getBytes();
+            }
+            duration += std::chrono::system_clock::now() - start;
+        }
+
+        std::cout << "Library storage benchmark (" << (arenaStorage ? "arena" : "heap") << "): " <<
+                     allocationCount / LOAD_COUNT << " allocations, " <<
+                     allocationBytes / LOAD_COUNT << " bytes, " <<
+                     duration.count() / LOAD_COUNT << " seconds per load" << std::endl;
+    }
+}
+
+TEST_CASE("Incremental read benchmark", "[xmlio]")
+{
+    const int READ_COUNT = 10;
+
+    std::vector<mx::FilePath> libraryFiles = BenchmarkUtil::getLibraryFiles();
+    for (bool incremental : { false, true })
+    {
+        size_t allocationCount = 0;
+        size_t allocationBytes = 0;
+        std::chrono::duration<double> duration(0.0);
+        for (int i = 0; i < READ_COUNT; i++)
+        {
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            BenchmarkUtil::AllocationCounter counter;
+            mx::DocumentPtr doc = mx::createDocument();
+            for (const mx::FilePath& file : libraryFiles)
+            {
+                if (incremental)
+                {
+                    mx::readFromXmlFileIncremental(doc, file);
+                }
+                else
+                {
+                    mx::readFromXmlFile(doc, file);
+                }
+            }
+            allocationCount += counter.getCount();
+            allocationBytes += counter.getBytes();
+            duration += std::chrono::system_clock::now() - start;
+        }
+
+        std::cout << "Incremental read benchmark (" << (incremental ? "incremental" : "default") << "): " <<
+                     allocationCount / READ_COUNT << " allocations, " <<
+                     allocationBytes / READ_COUNT << " bytes, " <<
+                     duration.count() / READ_COUNT << " seconds per read" << std::endl;
+    }
+}
+
+TEST_CASE("Library validate benchmark", "[xmlio]")
+{
+    const int VALIDATE_COUNT = 10;
+
+    mx::DocumentPtr doc = mx::createDocument();
+    for (const mx::FilePath& file : BenchmarkUtil::getLibraryFiles())
+    {
+        mx::readFromXmlFile(doc, file);
+    }
+
+    for (bool parallel : { false, true })
+    {
+        size_t allocationCount = 0;
+        std::chrono::duration<double> duration(0.0);
+        for (int i = 0; i < VALIDATE_COUNT; i++)
+        {
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            BenchmarkUtil::AllocationCounter counter;
+            if (parallel)
+            {
+                doc->validateParallel();
+            }
+            else
+            {
+                doc->validate();
+            }
+            allocationCount += counter.getCount();
+            duration += std::chrono::system_clock::now() - start;
+        }
+
+        std::cout << "Library validate benchmark (" << (parallel ? "parallel" : "serial") << "): " <<
+                     allocationCount / VALIDATE_COUNT << " allocations, " <<
+                     duration.count() / VALIDATE_COUNT << " seconds per validate" << std::endl;
+    }
+}
+
+TEST_CASE("Library loading benchmark", "[xmlio]")
+{
+    const int LOAD_COUNT = 10;
+
+    std::vector<mx::FilePath> libraryFiles = BenchmarkUtil::getLibraryFiles();
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+
+    std::vector<std::string> modes = { "serial", "concurrent", "cached" };
+    for (const std::string& mode : modes)
+    {
+        std::chrono::duration<double> duration(0.0);
+        for (int i = 0; i < LOAD_COUNT; i++)
+        {
+            if (mode != "cached")
+            {
+                mx::clearLibraryCache();
+            }
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            mx::DocumentPtr doc = mx::createDocument();
+            if (mode == "serial")
+            {
+                importLibraryFiles(libraryFiles, doc);
+            }
+            else
+            {
+                mx::loadLibraries(libraryFiles, doc, &copyOptions);
+            }
+            duration += std::chrono::system_clock::now() - start;
+        }
+
+        std::cout << "Library loading benchmark (" << mode << "): " <<
+                     duration.count() / LOAD_COUNT << " seconds per load" << std::endl;
+    }
+}
+
+TEST_CASE("Library reference benchmark", "[xmlio]")
+{
+    const int DOCUMENT_COUNT = 100;
+
+    mx::DocumentPtr libraryDoc = mx::createDocument();
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+    mx::loadLibraries(BenchmarkUtil::getLibraryFiles(), libraryDoc, &copyOptions);
+
+    // Build the lookup cache of the library before timing.
+    REQUIRE(!libraryDoc->getMatchingNodeDefs("image").empty());
+
+    // Referencing is measured first, so that it isn't charged for the heap
+    // reclamation that follows the release of imported documents.
+    for (bool reference : { true, false })
+    {
+        std::vector<mx::DocumentPtr> docs;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        BenchmarkUtil::AllocationCounter counter;
+        for (int i = 0; i < DOCUMENT_COUNT; i++)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            if (reference)
+            {
+                doc->referenceLibrary(libraryDoc);
+            }
+            else
+            {
+                doc->importLibrary(libraryDoc);
+            }
+            mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+            mx::NodePtr image = nodeGraph->addNode("image", mx::EMPTY_STRING, "color3");
+            REQUIRE(image->getDeclaration());
+            docs.push_back(doc);
+        }
+        std::chrono::duration<double> duration = std::chrono::system_clock::now() - start;
+
+        std::cout << "Library reference benchmark (" << (reference ? "reference" : "import") << "): " <<
+                     counter.getCount() / DOCUMENT_COUNT << " allocations, " <<
+                     counter.getBytes() / DOCUMENT_COUNT << " bytes, " <<
+                     duration.count() / DOCUMENT_COUNT << " seconds per document" << std::endl;
+    }
+}
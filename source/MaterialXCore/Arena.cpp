@@ -0,0 +1,82 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXCore/Arena.h>
+
+#include <algorithm>
+
+namespace MaterialX
+{
+
+const size_t Arena::DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+//
+// Arena methods
+//
+
+Arena::Arena(size_t blockSize) :
+    _blockSize(blockSize),
+    _current(nullptr),
+    _remaining(0),
+    _allocatedBytes(0)
+{
+}
+
+Arena::~Arena()
+{
+    for (char* block : _blocks)
+    {
+        delete[] block;
+    }
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    // Reuse a released allocation of the same size if one is suitably aligned.
+    size = std::max(size, sizeof(FreeNode));
+    auto it = _freeLists.find(size);
+    if (it != _freeLists.end() && it->second &&
+        reinterpret_cast<size_t>(it->second) % alignment == 0)
+    {
+        FreeNode* node = it->second;
+        it->second = node->next;
+        _allocatedBytes += size;
+        return node;
+    }
+
+    size_t padding = (alignment - (reinterpret_cast<size_t>(_current) % alignment)) % alignment;
+    if (!_current || padding + size > _remaining)
+    {
+        // Allocations larger than the block size receive a dedicated block.
+        size_t blockSize = std::max(_blockSize, size + alignment);
+        char* block = new char[blockSize];
+        _blocks.push_back(block);
+        _current = block;
+        _remaining = blockSize;
+        padding = (alignment - (reinterpret_cast<size_t>(_current) % alignment)) % alignment;
+    }
+
+    char* ptr = _current + padding;
+    _current += padding + size;
+    _remaining -= padding + size;
+    _allocatedBytes += size;
+    return ptr;
+}
+
+void Arena::deallocate(void* ptr, size_t size)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    size = std::max(size, sizeof(FreeNode));
+    FreeNode*& head = _freeLists[size];
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = head;
+    head = node;
+    _allocatedBytes -= size;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,128 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_ARENA_H
+#define MATERIALX_ARENA_H
+
+/// @file
+/// Arena allocation for document storage
+
+#include <MaterialXCore/Library.h>
+
+#include <mutex>
+
+namespace MaterialX
+{
+
+class Arena;
+
+/// A shared pointer to an Arena
+using ArenaPtr = shared_ptr<Arena>;
+
+/// @class Arena
+/// A memory arena, from which small objects are allocated sequentially out of
+/// large blocks.  Released allocations are kept in free lists by size, and are
+/// reused by later allocations of the same size; the blocks themselves are
+/// returned to the heap when the arena is destroyed.  Allocation and release
+/// are thread-safe.
+class Arena
+{
+  public:
+    explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+
+    /// Allocate the given number of bytes with the given alignment.
+    void* allocate(size_t size, size_t alignment);
+
+    /// Release an allocation of the given size, so that its memory may be
+    /// reused by a later allocation of the same size.
+    void deallocate(void* ptr, size_t size);
+
+    /// Return the number of bytes currently allocated from the arena.
+    size_t getAllocatedBytes() const
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _allocatedBytes;
+    }
+
+    /// Return the number of memory blocks owned by the arena.
+    size_t getBlockCount() const
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _blocks.size();
+    }
+
+  public:
+    static const size_t DEFAULT_BLOCK_SIZE;
+
+  private:
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+  private:
+    // A released allocation, linked into the free list of its size.
+    struct FreeNode
+    {
+        FreeNode* next;
+    };
+
+  private:
+    size_t _blockSize;
+    vector<char*> _blocks;
+    char* _current;
+    size_t _remaining;
+    size_t _allocatedBytes;
+    std::unordered_map<size_t, FreeNode*> _freeLists;
+    mutable std::mutex _mutex;
+};
+
+/// @class ArenaAllocator
+/// A standard allocator that allocates from a shared Arena.  Since each
+/// allocator holds a reference to its arena, objects allocated through
+/// std::allocate_shared keep the arena alive for as long as they exist.
+template <class T> class ArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(ArenaPtr arena) :
+        _arena(arena)
+    {
+    }
+    template <class U> ArenaAllocator(const ArenaAllocator<U>& other) :
+        _arena(other.getArena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* ptr, size_t n)
+    {
+        _arena->deallocate(ptr, n * sizeof(T));
+    }
+
+    ArenaPtr getArena() const
+    {
+        return _arena;
+    }
+
+    template <class U> bool operator==(const ArenaAllocator<U>& rhs) const
+    {
+        return _arena == rhs.getArena();
+    }
+    template <class U> bool operator!=(const ArenaAllocator<U>& rhs) const
+    {
+        return _arena != rhs.getArena();
+    }
+
+  private:
+    ArenaPtr _arena;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -5,8 +5,12 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <MaterialXCore/ThreadPool.h>
 #include <MaterialXCore/Util.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <mutex>
 
 namespace MaterialX
@@ -31,6 +35,53 @@ template<class T> shared_ptr<T> updateChildSubclass(ElementPtr parent, ElementPt
     return newChild;
 }
 
+// Return a key that captures every property of the given node that is
+// considered when matching it to a nodedef, and whether the nodedefs of
+// referenced libraries are considered.
+string getNodeDefKey(const Node& node, const string& target, bool includeLibraries)
+{
+    string key = node.getQualifiedName(node.getCategory());
+    key += '\0';
+    key += node.getCategory();
+    key += '\0';
+    key += node.getType();
+    key += '\0';
+    key += target;
+    key += '\0';
+    key += node.hasVersionString() ? node.getVersionString() : "\1";
+    for (const ValueElementPtr& value : node.getActiveValueElements())
+    {
+        key += '\0';
+        key += value->getName();
+        key += '\0';
+        key += value->getCategory();
+        key += '\0';
+        key += value->getType();
+    }
+    key += '\0';
+    key += includeLibraries ? '1' : '0';
+    return key;
+}
+
+// Return the first nodedef that declares the given node, from the nodedefs
+// returned by the given matching function.
+template <class F> NodeDefPtr findNodeDef(F getMatchingNodeDefs, const Node& node, const string& target)
+{
+    vector<NodeDefPtr> nodeDefs = getMatchingNodeDefs(node.getQualifiedName(node.getCategory()));
+    vector<NodeDefPtr> secondary = getMatchingNodeDefs(node.getCategory());
+    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
+    for (NodeDefPtr nodeDef : nodeDefs)
+    {
+        if (targetStringsMatch(nodeDef->getTarget(), target) &&
+            nodeDef->isVersionCompatible(node.getSelf()) &&
+            node.isTypeCompatible(nodeDef))
+        {
+            return nodeDef;
+        }
+    }
+    return NodeDefPtr();
+}
+
 } // anonymous namespace
 
 //
@@ -50,7 +101,10 @@ class Document::Cache
 {
   public:
     Cache() :
-        valid(false)
+        valid(false),
+        nodeDefRevision(0),
+        nodeDefMemoRevision(0),
+        inheritanceRevision(0)
     {
     }
     ~Cache() { }
@@ -66,48 +120,277 @@ class Document::Cache
             portElementMap.clear();
             nodeDefMap.clear();
             implementationMap.clear();
+            pendingElements.clear();
 
             // Traverse the document to build a new cache.
             for (ElementPtr elem : doc.lock()->traverseTree())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                insertElement(elem);
+            }
 
-                if (!nodeName.empty())
-                {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap.insert(std::pair<string, PortElementPtr>(
-                            portElem->getQualifiedName(nodeName),
-                            portElem));
-                    }
-                }
-                if (!nodeString.empty())
-                {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
-                    {
-                        nodeDefMap.insert(std::pair<string, NodeDefPtr>(
-                            nodeDef->getQualifiedName(nodeString),
-                            nodeDef));
-                    }
-                }
-                if (!nodeDefString.empty())
+            valid = true;
+        }
+        else if (!pendingElements.empty())
+        {
+            // Re-index only those elements that have changed since the last
+            // refresh, skipping any that have since been removed.
+            DocumentPtr document = doc.lock();
+            for (ElementPtr elem : pendingElements)
+            {
+                if (isAttached(elem, document))
                 {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
-                    {
-                        implementationMap.insert(std::pair<string, InterfaceElementPtr>(
-                            interface->getQualifiedName(nodeDefString),
-                            interface));
-                    }
+                    eraseElement(elem);
+                    insertElement(elem);
                 }
             }
+            pendingElements.clear();
+        }
+    }
 
-            valid = true;
+    // Called before the indexed attributes of the given element are modified.
+    // Existing entries are removed while the previous attribute values are
+    // still present, and the element is re-indexed on the next refresh.
+    void updateElement(ElementPtr elem)
+    {
+        if (!valid)
+        {
+            return;
         }
+        eraseElement(elem);
+        pendingElements.push_back(elem);
+    }
+
+    // Called before a change that may affect the qualified names of the given
+    // element and all of its descendants.
+    void updateTree(ElementPtr elem)
+    {
+        if (!valid)
+        {
+            return;
+        }
+        for (ElementPtr descendant : elem->traverseTree())
+        {
+            eraseElement(descendant);
+            pendingElements.push_back(descendant);
+        }
+    }
+
+    // Called before the given element and all of its descendants are removed
+    // from the document.
+    void removeTree(ElementPtr elem)
+    {
+        if (!valid)
+        {
+            return;
+        }
+        for (ElementPtr descendant : elem->traverseTree())
+        {
+            eraseElement(descendant);
+        }
+    }
+
+    // Return the geometry binding index of the document, building it if the
+    // document has been modified since it was last built.
+    ConstGeomBindingIndexPtr getGeomBindingIndex()
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!geomBindingIndex)
+        {
+            geomBindingIndex = std::make_shared<GeomBindingIndex>(doc.lock());
+        }
+        return geomBindingIndex;
+    }
+
+    // Return the flattened form of the given collection, building it if the
+    // collections of the document have been modified since it was last built.
+    ConstFlattenedCollectionPtr getFlattenedCollection(ConstCollectionPtr collection)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        ConstFlattenedCollectionPtr& flattened = flattenedCollections[collection.get()];
+        if (!flattened)
+        {
+            flattened = std::make_shared<FlattenedCollection>(collection);
+        }
+        return flattened;
+    }
+
+    // Look up the memoized nodedef for each of the given keys, returning
+    // true for each key that was found.  Memoized nodedefs are discarded if
+    // the given nodedef revision differs from that of the memo.
+    vector<bool> findNodeDefs(const StringVec& keys, size_t revision, vector<NodeDefPtr>& nodeDefs)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (revision != nodeDefMemoRevision)
+        {
+            nodeDefMemo.clear();
+            nodeDefMemoRevision = revision;
+        }
+        vector<bool> found(keys.size(), false);
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            auto it = nodeDefMemo.find(keys[i]);
+            if (it != nodeDefMemo.end())
+            {
+                nodeDefs[i] = it->second;
+                found[i] = true;
+            }
+        }
+        return found;
+    }
+
+    // Memoize the given resolved nodedefs for the given nodedef revision.
+    void insertNodeDefs(const std::unordered_map<string, NodeDefPtr>& resolved, size_t revision)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (revision == nodeDefMemoRevision)
+        {
+            nodeDefMemo.insert(resolved.begin(), resolved.end());
+        }
+    }
+
+    // Called before a change to the given element, discarding derived data
+    // such as the geometry binding index, flattened collections and memoized
+    // nodedefs if the change may affect them.
+    void updateDerivedData(ElementPtr elem)
+    {
+        ElementPtr topLevel = elem;
+        while (topLevel->getParent() && topLevel->getParent()->getParent())
+        {
+            topLevel = topLevel->getParent();
+        }
+        if (topLevel->isA<Document>() ||
+            topLevel->isA<NodeDef>())
+        {
+            nodeDefRevision++;
+        }
+        if (!geomBindingIndex && flattenedCollections.empty())
+        {
+            return;
+        }
+        if (topLevel->isA<Document>() ||
+            topLevel->isA<Collection>())
+        {
+            flattenedCollections.clear();
+            geomBindingIndex.reset();
+        }
+        else if (topLevel->isA<Look>() ||
+                 topLevel->isA<Material>())
+        {
+            geomBindingIndex.reset();
+        }
+    }
+
+    // Called before a change to the given element, advancing the inheritance
+    // revision if the element is the document, a top-level element, or a
+    // value element of a top-level element.  Only top-level elements may be
+    // inherited from, so changes to other elements leave every inheritance
+    // chain and its inherited ports unchanged.
+    void updateInheritance(ElementPtr elem)
+    {
+        ElementPtr parent = elem->getParent();
+        if (!parent || !parent->getParent() ||
+            (!parent->getParent()->getParent() && elem->isA<ValueElement>()))
+        {
+            inheritanceRevision++;
+        }
+    }
+
+    // Called before a change to the value or type of the given element,
+    // discarding its cached typed value.
+    void updateValue(ElementPtr elem)
+    {
+        ValueElementPtr valueElem = elem->asA<ValueElement>();
+        if (valueElem)
+        {
+            valueElem->clearCachedValue();
+        }
+    }
+
+  private:
+    void insertElement(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            PortElementPtr portElem = elem->asA<PortElement>();
+            if (portElem)
+            {
+                portElementMap.insert(std::pair<string, PortElementPtr>(
+                    portElem->getQualifiedName(nodeName),
+                    portElem));
+            }
+        }
+        if (!nodeString.empty())
+        {
+            NodeDefPtr nodeDef = elem->asA<NodeDef>();
+            if (nodeDef)
+            {
+                nodeDefMap.insert(std::pair<string, NodeDefPtr>(
+                    nodeDef->getQualifiedName(nodeString),
+                    nodeDef));
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            InterfaceElementPtr interface = elem->asA<InterfaceElement>();
+            if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
+            {
+                implementationMap.insert(std::pair<string, InterfaceElementPtr>(
+                    interface->getQualifiedName(nodeDefString),
+                    interface));
+            }
+        }
+    }
+
+    void eraseElement(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            eraseEntry(portElementMap, elem->getQualifiedName(nodeName), elem);
+        }
+        if (!nodeString.empty())
+        {
+            eraseEntry(nodeDefMap, elem->getQualifiedName(nodeString), elem);
+        }
+        if (!nodeDefString.empty())
+        {
+            eraseEntry(implementationMap, elem->getQualifiedName(nodeDefString), elem);
+        }
+    }
+
+    template<class T> static void eraseEntry(std::unordered_multimap<string, T>& map, const string& key, ElementPtr elem)
+    {
+        auto keyRange = map.equal_range(key);
+        for (auto it = keyRange.first; it != keyRange.second; ++it)
+        {
+            if (it->second == elem)
+            {
+                map.erase(it);
+                return;
+            }
+        }
+    }
+
+    // Return true if the given element is still reachable from the document root.
+    static bool isAttached(ElementPtr elem, DocumentPtr document)
+    {
+        ElementPtr child = elem;
+        for (ElementPtr parent = child->getParent(); parent; parent = parent->getParent())
+        {
+            if (parent->getChild(child->getName()) != child)
+            {
+                return false;
+            }
+            child = parent;
+        }
+        return child == document;
     }
 
   public:
@@ -117,6 +400,13 @@ class Document::Cache
     std::unordered_multimap<string, PortElementPtr> portElementMap;
     std::unordered_multimap<string, NodeDefPtr> nodeDefMap;
     std::unordered_multimap<string, InterfaceElementPtr> implementationMap;
+    vector<ElementPtr> pendingElements;
+    ConstGeomBindingIndexPtr geomBindingIndex;
+    std::unordered_map<const Collection*, ConstFlattenedCollectionPtr> flattenedCollections;
+    std::atomic<size_t> nodeDefRevision;
+    std::unordered_map<string, NodeDefPtr> nodeDefMemo;
+    size_t nodeDefMemoRevision;
+    std::atomic<size_t> inheritanceRevision;
 };
 
 //
@@ -125,7 +415,8 @@ class Document::Cache
 
 Document::Document(ElementPtr parent, const string& name) :
     GraphElement(parent, CATEGORY, name),
-    _cache(std::unique_ptr<Cache>(new Cache))
+    _cache(std::unique_ptr<Cache>(new Cache)),
+    _attributeNameRoot(std::make_shared<AttributeNames>())
 {
 }
 
@@ -180,6 +471,63 @@ void Document::importLibrary(ConstDocumentPtr library, const CopyOptions* copyOp
     }
 }
 
+void Document::referenceLibrary(ConstDocumentPtr library)
+{
+    if (library.get() == this || library->referencesLibrary(this))
+    {
+        throw Exception("Library reference would create a cycle: " + library->getSourceUri());
+    }
+    _cache->inheritanceRevision = getInheritanceRevision() + 1;
+    _referencedLibraries.push_back(library);
+}
+
+void Document::removeReferencedLibraries()
+{
+    // Advance the nodedef revision past its current value, which includes
+    // the revisions of the libraries being removed.
+    _cache->nodeDefRevision = getNodeDefRevision() + 1;
+    _cache->inheritanceRevision = getInheritanceRevision() + 1;
+    _referencedLibraries.clear();
+}
+
+void Document::enableArenaStorage(ArenaPtr arena)
+{
+    if (!_arena)
+    {
+        _arena = arena ? arena : std::make_shared<Arena>();
+    }
+}
+
+ConstGeomBindingIndexPtr Document::getGeomBindingIndex() const
+{
+    return _cache->getGeomBindingIndex();
+}
+
+ConstFlattenedCollectionPtr Document::getFlattenedCollection(ConstCollectionPtr collection) const
+{
+    return _cache->getFlattenedCollection(collection);
+}
+
+size_t Document::getNodeDefRevision() const
+{
+    size_t revision = _cache->nodeDefRevision;
+    for (const ConstDocumentPtr& library : _referencedLibraries)
+    {
+        revision += library->getNodeDefRevision();
+    }
+    return revision;
+}
+
+size_t Document::getInheritanceRevision() const
+{
+    size_t revision = _cache->inheritanceRevision;
+    for (const ConstDocumentPtr& library : _referencedLibraries)
+    {
+        revision += library->getInheritanceRevision();
+    }
+    return revision;
+}
+
 std::pair<int, int> Document::getVersionIntegers() const
 {
     if (!hasVersionString())
@@ -241,6 +589,71 @@ vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
     return nodeDefs;
 }
 
+vector<ConstNodeDefPtr> Document::findLibraryMatchingNodeDefs(const string& nodeName) const
+{
+    vector<NodeDefPtr> nodeDefs = findMatchingNodeDefs(nodeName);
+    return vector<ConstNodeDefPtr>(nodeDefs.begin(), nodeDefs.end());
+}
+
+NodeDefPtr Document::getNodeDefForNode(ConstNodePtr node, const string& target) const
+{
+    if (node->hasNodeDefString())
+    {
+        return node->getNodeDef(target);
+    }
+    return resolveNodeDefForNode(node, target, false);
+}
+
+ConstNodeDefPtr Document::findLibraryNodeDefForNode(ConstNodePtr node, const string& target) const
+{
+    if (node->hasNodeDefString())
+    {
+        return node->getDeclaration(target);
+    }
+    return resolveNodeDefForNode(node, target, true);
+}
+
+vector<NodeDefPtr> Document::getNodeDefsForNodes(const vector<NodePtr>& nodes, const string& target) const
+{
+    // Build a key for each node without a nodedef string.
+    StringVec keys(nodes.size());
+    vector<NodeDefPtr> nodeDefs(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        if (!nodes[i]->hasNodeDefString())
+        {
+            keys[i] = getNodeDefKey(*nodes[i], target, false);
+        }
+    }
+
+    // Look up all keys in the memo, and then resolve each missing key once.
+    size_t revision = getNodeDefRevision();
+    vector<bool> found = _cache->findNodeDefs(keys, revision, nodeDefs);
+    std::unordered_map<string, NodeDefPtr> resolved;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i]->hasNodeDefString())
+        {
+            nodeDefs[i] = nodes[i]->getNodeDef(target);
+        }
+        else if (!found[i])
+        {
+            auto it = resolved.find(keys[i]);
+            if (it == resolved.end())
+            {
+                auto getMatching = [this](const string& nodeName) { return getMatchingNodeDefs(nodeName); };
+                it = resolved.insert(std::make_pair(keys[i], findNodeDef(getMatching, *nodes[i], target))).first;
+            }
+            nodeDefs[i] = it->second;
+        }
+    }
+    if (!resolved.empty())
+    {
+        _cache->insertNodeDefs(resolved, revision);
+    }
+    return nodeDefs;
+}
+
 vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& nodeDef) const
 {
     // Refresh the cache.
@@ -258,6 +671,100 @@ vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& n
     return implementations;
 }
 
+vector<ConstInterfaceElementPtr> Document::findLibraryMatchingImplementations(const string& nodeDef) const
+{
+    vector<InterfaceElementPtr> implementations = findMatchingImplementations(nodeDef);
+    return vector<ConstInterfaceElementPtr>(implementations.begin(), implementations.end());
+}
+
+vector<NodeDefPtr> Document::findMatchingNodeDefs(const string& nodeName) const
+{
+    vector<NodeDefPtr> nodeDefs = getMatchingNodeDefs(nodeName);
+
+    // Append matching nodedefs from referenced libraries.
+    for (size_t i = 0; i < _referencedLibraries.size(); i++)
+    {
+        for (NodeDefPtr nodeDef : _referencedLibraries[i]->findMatchingNodeDefs(nodeName))
+        {
+            if (!isShadowedInLibrary(nodeDef->getName(), i))
+            {
+                nodeDefs.push_back(nodeDef);
+            }
+        }
+    }
+
+    // Return the matches.
+    return nodeDefs;
+}
+
+vector<InterfaceElementPtr> Document::findMatchingImplementations(const string& nodeDef) const
+{
+    vector<InterfaceElementPtr> implementations = getMatchingImplementations(nodeDef);
+
+    // Append matching implementations from referenced libraries.
+    for (size_t i = 0; i < _referencedLibraries.size(); i++)
+    {
+        for (InterfaceElementPtr implementation : _referencedLibraries[i]->findMatchingImplementations(nodeDef))
+        {
+            if (!isShadowedInLibrary(implementation->getName(), i))
+            {
+                implementations.push_back(implementation);
+            }
+        }
+    }
+
+    // Return the matches.
+    return implementations;
+}
+
+NodeDefPtr Document::resolveNodeDefForNode(ConstNodePtr node, const string& target, bool includeLibraries) const
+{
+    StringVec keys = { getNodeDefKey(*node, target, includeLibraries) };
+    vector<NodeDefPtr> nodeDefs(1);
+    size_t revision = getNodeDefRevision();
+    if (!_cache->findNodeDefs(keys, revision, nodeDefs)[0])
+    {
+        if (includeLibraries)
+        {
+            nodeDefs[0] = findNodeDef([this](const string& nodeName) { return findMatchingNodeDefs(nodeName); }, *node, target);
+        }
+        else
+        {
+            nodeDefs[0] = findNodeDef([this](const string& nodeName) { return getMatchingNodeDefs(nodeName); }, *node, target);
+        }
+        _cache->insertNodeDefs({ { keys[0], nodeDefs[0] } }, revision);
+    }
+    return nodeDefs[0];
+}
+
+bool Document::isShadowedInLibrary(const string& name, size_t libraryIndex) const
+{
+    if (getChild(name))
+    {
+        return true;
+    }
+    for (size_t i = 0; i < libraryIndex; i++)
+    {
+        if (_referencedLibraries[i]->findRootElement(name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Document::referencesLibrary(const Document* library) const
+{
+    for (ConstDocumentPtr referenced : _referencedLibraries)
+    {
+        if (referenced.get() == library || referenced->referencesLibrary(library))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool Document::validate(string* message) const
 {
     bool res = true;
@@ -265,6 +772,61 @@ bool Document::validate(string* message) const
     return GraphElement::validate(message) && res;
 }
 
+bool Document::validateParallel(vector<ValidationDiagnostic>* diagnostics, size_t threadCount) const
+{
+    // Gather elements in the order of a tree traversal, and build the
+    // document cache before any worker starts, so that workers share
+    // read-only state.
+    vector<ElementPtr> elements;
+    for (ElementPtr elem : traverseTree())
+    {
+        elements.push_back(elem);
+    }
+    _cache->refresh();
+
+    // Elements are validated in blocks on the shared thread pool, where
+    // each thread claims the next unclaimed block, so that the work is
+    // balanced regardless of the cost of each element.  Results are stored
+    // per element, and are combined in element order once all blocks are
+    // complete.
+    const size_t BLOCK_SIZE = 16;
+    vector<vector<ValidationDiagnostic>> results(elements.size());
+    vector<char> passed(elements.size(), 0);
+    vector<std::exception_ptr> exceptions(elements.size());
+    size_t blockCount = (elements.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    ThreadPool::getGlobal().parallelFor(blockCount, [&elements, &results, &passed, &exceptions, diagnostics, BLOCK_SIZE](size_t block)
+    {
+        size_t begin = block * BLOCK_SIZE;
+        size_t end = std::min(begin + BLOCK_SIZE, elements.size());
+        for (size_t i = begin; i < end; i++)
+        {
+            try
+            {
+                passed[i] = elements[i]->validateElement(diagnostics ? &results[i] : nullptr);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+            }
+        }
+    }, threadCount);
+
+    bool res = true;
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        if (exceptions[i])
+        {
+            std::rethrow_exception(exceptions[i]);
+        }
+        res = passed[i] && res;
+        if (diagnostics)
+        {
+            diagnostics->insert(diagnostics->end(), results[i].begin(), results[i].end());
+        }
+    }
+    return res;
+}
+
 void Document::upgradeVersion()
 {
     std::pair<int, int> versions = getVersionIntegers();
@@ -585,34 +1147,101 @@ void Document::upgradeVersion()
     }
 }
 
-void Document::onAddElement(ElementPtr, ElementPtr)
+void Document::onAddElement(ElementPtr, ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->updateTree(elem);
+    _cache->updateDerivedData(elem);
+    _cache->updateInheritance(elem);
 }
 
-void Document::onRemoveElement(ElementPtr, ElementPtr)
+void Document::onRemoveElement(ElementPtr, ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->removeTree(elem);
+    _cache->updateDerivedData(elem);
+    _cache->updateInheritance(elem);
+}
+
+void Document::onSetAttribute(ElementPtr elem, const string& attrib, const string& value)
+{
+    _cache->updateDerivedData(elem);
+    if (attrib == INHERIT_ATTRIBUTE)
+    {
+        _cache->inheritanceRevision++;
+    }
+    else if (attrib == NAME_ATTRIBUTE || attrib == NAMESPACE_ATTRIBUTE)
+    {
+        _cache->updateInheritance(elem);
+    }
+    if (attrib == ValueElement::VALUE_ATTRIBUTE ||
+        attrib == TypedElement::TYPE_ATTRIBUTE)
+    {
+        _cache->updateValue(elem);
+    }
+    if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        if (value != elem->getAttribute(attrib))
+        {
+            _cache->updateTree(elem);
+        }
+    }
+    else if (attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+             attrib == NodeDef::NODE_ATTRIBUTE ||
+             attrib == InterfaceElement::NODE_DEF_ATTRIBUTE)
+    {
+        if (value != elem->getAttribute(attrib))
+        {
+            _cache->updateElement(elem);
+        }
+    }
 }
 
-void Document::onSetAttribute(ElementPtr, const string&, const string&)
+void Document::onRemoveAttribute(ElementPtr elem, const string& attrib)
 {
-    _cache->valid = false;
+    _cache->updateDerivedData(elem);
+    if (attrib == INHERIT_ATTRIBUTE)
+    {
+        _cache->inheritanceRevision++;
+    }
+    else if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        _cache->updateInheritance(elem);
+    }
+    if (attrib == ValueElement::VALUE_ATTRIBUTE ||
+        attrib == TypedElement::TYPE_ATTRIBUTE)
+    {
+        _cache->updateValue(elem);
+    }
+    if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        _cache->updateTree(elem);
+    }
+    else if (attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+             attrib == NodeDef::NODE_ATTRIBUTE ||
+             attrib == InterfaceElement::NODE_DEF_ATTRIBUTE)
+    {
+        _cache->updateElement(elem);
+    }
 }
 
-void Document::onRemoveAttribute(ElementPtr, const string&)
+void Document::onCopyContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->updateTree(elem);
+    _cache->updateDerivedData(elem);
+    _cache->updateValue(elem);
+    _cache->inheritanceRevision++;
 }
 
-void Document::onCopyContent(ElementPtr)
+void Document::onClearContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->removeTree(elem);
+    _cache->updateDerivedData(elem);
+    _cache->updateValue(elem);
+    _cache->inheritanceRevision++;
 }
 
-void Document::onClearContent(ElementPtr)
+void Document::onSetChildIndex(ElementPtr, ElementPtr child)
 {
-    _cache->valid = false;
+    _cache->updateInheritance(child);
 }
 
 } // namespace MaterialX
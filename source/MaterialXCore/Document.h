@@ -52,10 +52,39 @@ class Document : public GraphElement
     virtual DocumentPtr copy() const
     {
         DocumentPtr doc = createDocument<Document>();
+        if (_arena)
+        {
+            doc->enableArenaStorage();
+        }
+        for (ConstDocumentPtr library : _referencedLibraries)
+        {
+            doc->referenceLibrary(library);
+        }
         doc->copyContentFrom(getSelf());
         return doc;
     }
 
+    /// Enable arena storage for this document.  Elements subsequently added
+    /// to the document are allocated sequentially from a memory arena owned
+    /// by the document, rather than individually from the heap, which reduces
+    /// allocation counts and memory overhead for large documents.
+    ///
+    /// Memory used by removed elements is reused by elements added later,
+    /// but the arena itself is only returned to the heap when the document
+    /// and all of its elements have been released.
+    ///
+    /// @param arena An optional arena to share with another document, such
+    ///    as one whose elements will later be moved into that document.  If
+    ///    empty, then a new arena is created.
+    void enableArenaStorage(ArenaPtr arena = ArenaPtr());
+
+    /// Return the memory arena of this document, or an empty shared pointer
+    /// if arena storage is not enabled.
+    ArenaPtr getArena() const
+    {
+        return _arena;
+    }
+
     /// Import the given document as a library within this document.
     /// The contents of the library document are copied into this one, and
     /// are assigned the source URI of the library.
@@ -65,6 +94,43 @@ class Document : public GraphElement
     ///    import function.  Defaults to a null pointer.
     void importLibrary(ConstDocumentPtr library, const CopyOptions* copyOptions = nullptr);
 
+    /// Reference the given document as a shared library of this document.
+    /// Unlike importLibrary, the contents of the library are not copied, so
+    /// a single library document may be referenced by any number of documents
+    /// at negligible cost.
+    ///
+    /// Library elements are shared by every document that references them,
+    /// so they are only returned as const, by the findLibrary methods of
+    /// this document and by Node::getDeclaration.  These fall through to
+    /// referenced libraries when no element of the given name exists in this
+    /// document.  Libraries are searched in the order in which they were
+    /// referenced, and elements of this document shadow elements of the same
+    /// name in its libraries.  Methods that return mutable elements, such as
+    /// getNodeDef and Node::getNodeDef, consider only the elements of this
+    /// document, so library content that is to be modified should be copied
+    /// into the document with importLibrary.  Referenced libraries must not
+    /// be modified while they are referenced.
+    /// @param library The library document to be referenced.
+    /// @throws Exception if the library already references this document.
+    void referenceLibrary(ConstDocumentPtr library);
+
+    /// Return the library documents referenced by this document.
+    const vector<ConstDocumentPtr>& getReferencedLibraries() const
+    {
+        return _referencedLibraries;
+    }
+
+    /// Remove all library references from this document.
+    void removeReferencedLibraries();
+
+    /// Return the element, if any, with the given name at the root scope of
+    /// this document, or the matching element of its referenced libraries
+    /// if no such element exists in this document.
+    ConstElementPtr findLibraryElement(const string& name) const
+    {
+        return findRootElement(name);
+    }
+
     /// @}
     /// @name NodeGraph Elements
     /// @{
@@ -237,6 +303,12 @@ class Document : public GraphElement
         removeChildOfType<Look>(name);
     }
 
+    /// Return an index of the material assignments in the looks of this
+    /// document, keyed by geometry path.  The index is built on first use,
+    /// and is built again after the looks, collections or materials of the
+    /// document are modified.
+    ConstGeomBindingIndexPtr getGeomBindingIndex() const;
+
     /// @}
     /// @name Collection Elements
     /// @{
@@ -269,6 +341,11 @@ class Document : public GraphElement
         removeChildOfType<Collection>(name);
     }
 
+    /// Return the flattened form of the given collection of this document.
+    /// The flattened collection is built on first use, and is built again
+    /// after the collections of the document are modified.
+    ConstFlattenedCollectionPtr getFlattenedCollection(ConstCollectionPtr collection) const;
+
     /// @}
     /// @name TypeDef Elements
     /// @{
@@ -295,6 +372,15 @@ class Document : public GraphElement
         return getChildrenOfType<TypeDef>();
     }
 
+    /// Return the TypeDef, if any, with the given name from this document,
+    /// or from its referenced libraries if no such element exists in this
+    /// document.
+    ConstTypeDefPtr findLibraryTypeDef(const string& name) const
+    {
+        ElementPtr child = findRootElement(name);
+        return child ? child->asA<TypeDef>() : TypeDefPtr();
+    }
+
     /// Remove the TypeDef, if any, with the given name.
     void removeTypeDef(const string& name)
     {
@@ -337,6 +423,15 @@ class Document : public GraphElement
         return getChildrenOfType<NodeDef>();
     }
 
+    /// Return the NodeDef, if any, with the given name from this document,
+    /// or from its referenced libraries if no such element exists in this
+    /// document.
+    ConstNodeDefPtr findLibraryNodeDef(const string& name) const
+    {
+        ElementPtr child = findRootElement(name);
+        return child ? child->asA<NodeDef>() : NodeDefPtr();
+    }
+
     /// Remove the NodeDef, if any, with the given name.
     void removeNodeDef(const string& name)
     {
@@ -346,6 +441,40 @@ class Document : public GraphElement
     /// Return a vector of all NodeDef elements that match the given node name.
     vector<NodeDefPtr> getMatchingNodeDefs(const string& nodeName) const;
 
+    /// Return a vector of all NodeDef elements that match the given node name,
+    /// including those of referenced libraries.
+    vector<ConstNodeDefPtr> findLibraryMatchingNodeDefs(const string& nodeName) const;
+
+    /// Return the first NodeDef that declares the given node, optionally
+    /// filtered by the given target name.  Resolved NodeDefs are memoized by
+    /// the category, type, port signature, version and target of the node,
+    /// until the NodeDefs of the document or its referenced libraries are
+    /// modified.
+    NodeDefPtr getNodeDefForNode(ConstNodePtr node, const string& target = EMPTY_STRING) const;
+
+    /// Return the first NodeDef that declares the given node, optionally
+    /// filtered by the given target name, including the NodeDefs of
+    /// referenced libraries.  Resolved NodeDefs are memoized as for
+    /// getNodeDefForNode.
+    ConstNodeDefPtr findLibraryNodeDefForNode(ConstNodePtr node, const string& target = EMPTY_STRING) const;
+
+    /// Return the first NodeDef that declares each of the given nodes,
+    /// optionally filtered by the given target name, as a vector parallel
+    /// to the given nodes.  Nodes with the same signature are resolved once.
+    vector<NodeDefPtr> getNodeDefsForNodes(const vector<NodePtr>& nodes, const string& target = EMPTY_STRING) const;
+    using GraphElement::getNodeDefsForNodes;
+
+    /// Return the revision of the NodeDefs of this document and of its
+    /// referenced libraries, which changes whenever a NodeDef is added to
+    /// or removed from them, or a library is removed.
+    size_t getNodeDefRevision() const;
+
+    /// Return the inheritance revision of this document and of its
+    /// referenced libraries, which changes whenever an inheritance chain
+    /// may have changed, or the ports of a top-level element that may be
+    /// inherited from are added, removed, renamed or reordered.
+    size_t getInheritanceRevision() const;
+
     /// @}
     /// @name PropertySet Elements
     /// @{
@@ -436,6 +565,15 @@ class Document : public GraphElement
         return getChildrenOfType<Implementation>();
     }
 
+    /// Return the Implementation, if any, with the given name from this
+    /// document, or from its referenced libraries if no such element exists
+    /// in this document.
+    ConstImplementationPtr findLibraryImplementation(const string& name) const
+    {
+        ElementPtr child = findRootElement(name);
+        return child ? child->asA<Implementation>() : ImplementationPtr();
+    }
+
     /// Remove the Implementation, if any, with the given name.
     void removeImplementation(const string& name)
     {
@@ -447,6 +585,10 @@ class Document : public GraphElement
     /// Implementation element or NodeGraph element.
     vector<InterfaceElementPtr> getMatchingImplementations(const string& nodeDef) const;
 
+    /// Return a vector of all node implementations that match the given
+    /// NodeDef string, including those of referenced libraries.
+    vector<ConstInterfaceElementPtr> findLibraryMatchingImplementations(const string& nodeDef) const;
+
     /// @}
     /// @name Version
     /// @{
@@ -513,6 +655,19 @@ class Document : public GraphElement
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate that the given document is consistent with the MaterialX
+    /// specification, validating its elements in parallel on the shared
+    /// thread pool.  The document must not be modified until validation
+    /// is complete.
+    /// @param diagnostics An optional output vector, to which a diagnostic
+    ///    for each failed rule is appended.  Diagnostics are ordered by
+    ///    element, in the order of a tree traversal of the document, and are
+    ///    the same for any number of threads.
+    /// @param threadCount The maximum number of threads, including the
+    ///    calling thread, or zero to use all threads of the pool.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validateParallel(vector<ValidationDiagnostic>* diagnostics = nullptr, size_t threadCount = 0) const;
+
     /// @}
     /// @name Callbacks
     /// @{
@@ -535,6 +690,9 @@ class Document : public GraphElement
     /// Called when content is cleared from an element.
     virtual void onClearContent(ElementPtr elem);
 
+    /// Called when a child element is moved to a new index within its parent.
+    virtual void onSetChildIndex(ElementPtr parent, ElementPtr child);
+
     /// Called when data is read into the current document.
     virtual void onRead() { }
 
@@ -561,8 +719,41 @@ class Document : public GraphElement
     static const string CMS_CONFIG_ATTRIBUTE;
 
   private:
+    // Return the element with the given name at the root scope of this
+    // document, or of its referenced libraries.
+    ElementPtr findRootElement(const string& name) const
+    {
+        ElementPtr child = getChild(name);
+        for (size_t i = 0; !child && i < _referencedLibraries.size(); i++)
+        {
+            child = _referencedLibraries[i]->findRootElement(name);
+        }
+        return child;
+    }
+
+    // Return the matching nodedefs and implementations of this document and
+    // of its referenced libraries.
+    vector<NodeDefPtr> findMatchingNodeDefs(const string& nodeName) const;
+    vector<InterfaceElementPtr> findMatchingImplementations(const string& nodeDef) const;
+
+    // Return the memoized nodedef that declares the given node, optionally
+    // including the nodedefs of referenced libraries.
+    NodeDefPtr resolveNodeDefForNode(ConstNodePtr node, const string& target, bool includeLibraries) const;
+
+    // Return true if an element of the given name exists in this document,
+    // or in any library referenced before the library at the given index.
+    bool isShadowedInLibrary(const string& name, size_t libraryIndex) const;
+
+    bool referencesLibrary(const Document* library) const;
+
+  private:
+    friend class Element;
+
     class Cache;
     std::unique_ptr<Cache> _cache;
+    ArenaPtr _arena;
+    AttributeNamesPtr _attributeNameRoot;
+    vector<ConstDocumentPtr> _referencedLibraries;
 };
 
 /// @class ScopedUpdate
@@ -33,15 +33,86 @@ const string ValueElement::UI_FOLDER_ATTRIBUTE = "uifolder";
 const string ValueElement::UI_MIN_ATTRIBUTE = "uimin";
 const string ValueElement::UI_MAX_ATTRIBUTE = "uimax";
 
+const StringVec Element::EMPTY_ATTRIBUTE_NAMES;
+
 Element::CreatorMap Element::_creatorMap;
 
+namespace {
+
+const size_t DEFAULT_ATTRIBUTE_CAPACITY = 4;
+
+// The validation state of the current thread.  Within a call to
+// validateElement, descendants are not validated, and each failed rule is
+// recorded in the optional diagnostics vector.
+thread_local bool singleElementValidation = false;
+thread_local vector<ValidationDiagnostic>* validationDiagnostics = nullptr;
+
+class SingleElementValidation
+{
+  public:
+    SingleElementValidation(vector<ValidationDiagnostic>* diagnostics) :
+        _prevSingleElement(singleElementValidation),
+        _prevDiagnostics(validationDiagnostics)
+    {
+        singleElementValidation = true;
+        validationDiagnostics = diagnostics;
+    }
+    ~SingleElementValidation()
+    {
+        singleElementValidation = _prevSingleElement;
+        validationDiagnostics = _prevDiagnostics;
+    }
+
+  private:
+    bool _prevSingleElement;
+    vector<ValidationDiagnostic>* _prevDiagnostics;
+};
+
+} // anonymous namespace
+
+//
+// Element::AttributeNames methods
+//
+
+Element::AttributeNamesPtr Element::AttributeNames::append(const Symbol& name) const
+{
+    auto it = _successors.find(name);
+    if (it != _successors.end())
+    {
+        AttributeNamesPtr successor = it->second.lock();
+        if (successor)
+        {
+            return successor;
+        }
+    }
+
+    // Remove the entries of released successors before adding a new one.
+    for (auto entry = _successors.begin(); entry != _successors.end(); )
+    {
+        if (entry->second.expired())
+            entry = _successors.erase(entry);
+        else
+            ++entry;
+    }
+
+    shared_ptr<AttributeNames> successor = std::make_shared<AttributeNames>();
+    successor->names = names;
+    successor->names.push_back(name.str());
+    successor->symbols = symbols;
+    successor->symbols.push_back(name);
+    successor->root = root;
+    successor->_parent = shared_from_this();
+    _successors[name] = successor;
+    return successor;
+}
+
 //
 // Element methods
 //
 
 bool Element::operator==(const Element& rhs) const
 {
-    if (getCategory() != rhs.getCategory() ||
+    if (_category != rhs._category ||
         getName() != rhs.getName())
     {
         return false;
@@ -93,6 +164,10 @@ void Element::setName(const string& name)
         parent->_childMap[name] = getSelf();
     }
     _name = name;
+    if (parent)
+    {
+        parent->onChildrenChanged();
+    }
 }
 
 string Element::getNamePath(ConstElementPtr relativeTo) const
@@ -203,8 +278,14 @@ void Element::setChildIndex(const string& name, int index)
         throw Exception("Invalid child index");
     }
 
+    // Handle change notifications.
+    DocumentPtr doc = getDocument();
+    ScopedUpdate update(doc);
+    doc->onSetChildIndex(getSelf(), child);
+
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
+    onChildrenChanged();
 }
 
 void Element::removeChild(const string& name)
@@ -219,24 +300,39 @@ void Element::removeChild(const string& name)
 }
 
 void Element::setAttribute(const string& attrib, const string& value)
+{
+    setAttribute(Symbol(attrib), value);
+}
+
+void Element::setAttribute(const Symbol& attrib, const string& value)
 {
     DocumentPtr doc = getDocument();
 
     // Handle change notifications.
     ScopedUpdate update(doc);
-    doc->onSetAttribute(getSelf(), attrib, value);
+    doc->onSetAttribute(getSelf(), attrib.str(), value);
 
-    if (!_attributeMap.count(attrib))
+    size_t index = findAttribute(attrib);
+    if (index == INVALID_ATTRIBUTE_INDEX)
+    {
+        if (_attributeValues.empty())
+        {
+            _attributeValues.reserve(DEFAULT_ATTRIBUTE_CAPACITY);
+        }
+        const AttributeNames& names = _attributeNames ? *_attributeNames : *doc->_attributeNameRoot;
+        _attributeNames = names.append(attrib);
+        _attributeValues.push_back(value);
+    }
+    else
     {
-        _attributeOrder.push_back(attrib);
+        _attributeValues[index] = value;
     }
-    _attributeMap[attrib] = value;
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    size_t index = findAttribute(attrib);
+    if (index != INVALID_ATTRIBUTE_INDEX)
     {
         DocumentPtr doc = getDocument();
 
@@ -244,9 +340,8 @@ void Element::removeAttribute(const string& attrib)
         ScopedUpdate update(doc);
         doc->onRemoveAttribute(getSelf(), attrib);
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        _attributeNames = copyAttributeNames(*_attributeNames, index);
+        _attributeValues.erase(_attributeValues.begin() + index);
     }
 }
 
@@ -262,11 +357,17 @@ template<class T> shared_ptr<const T> Element::asA() const
 
 ElementPtr Element::addChildOfCategory(const string& category,
                                        const string& name)
+{
+    return addChildOfCategory(Symbol(category), name);
+}
+
+ElementPtr Element::addChildOfCategory(const Symbol& category,
+                                       const string& name)
 {
     string childName = name;
     if (childName.empty())
     {
-        childName = createValidChildName(category + "1");
+        childName = createValidChildName(category.str() + "1");
     }
 
     if (_childMap.count(childName))
@@ -303,6 +404,63 @@ ElementPtr Element::addChildOfCategory(const string& category,
     return child;
 }
 
+void Element::moveChild(ElementPtr child)
+{
+    if (_childMap.count(child->getName()))
+    {
+        throw Exception("Child name is not unique: " + child->getName());
+    }
+    for (ElementPtr elem = getSelf(); elem; elem = elem->getParent())
+    {
+        if (elem == child)
+        {
+            throw Exception("Element cannot be moved into itself: " + child->asString());
+        }
+    }
+
+    ElementPtr parent = child->getParent();
+    if (parent)
+    {
+        parent->unregisterChildElement(child);
+    }
+
+    // Attach the moved elements to the root of this element, sharing the
+    // attribute names of its document, and invalidate any state that was
+    // derived from their previous document.
+    ElementPtr root = getRoot();
+    DocumentPtr doc = getDocument();
+    child->_parent = getSelf();
+    for (ElementPtr elem : child->traverseTree())
+    {
+        elem->_root = root;
+        if (elem->_attributeNames && elem->_attributeNames->root != doc->_attributeNameRoot.get())
+        {
+            elem->_attributeNames = elem->copyAttributeNames(*elem->_attributeNames);
+        }
+        elem->onChildrenChanged();
+    }
+
+    registerChildElement(child);
+}
+
+ArenaPtr Element::getDocumentArena() const
+{
+    return getDocument()->getArena();
+}
+
+Element::AttributeNamesPtr Element::copyAttributeNames(const AttributeNames& names, size_t skipIndex) const
+{
+    AttributeNamesPtr result = getDocument()->_attributeNameRoot;
+    for (size_t i = 0; i < names.symbols.size(); i++)
+    {
+        if (i != skipIndex)
+        {
+            result = result->append(names.symbols[i]);
+        }
+    }
+    return result->names.empty() ? nullptr : result;
+}
+
 ElementPtr Element::getRoot()
 {
     ElementPtr root = _root.lock();
@@ -383,8 +541,13 @@ void Element::copyContentFrom(ConstElementPtr source, const CopyOptions* copyOpt
     doc->onCopyContent(getSelf());
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributeNames = source->_attributeNames;
+    _attributeValues = source->_attributeValues;
+    if (_attributeNames && _attributeNames->root != doc->_attributeNameRoot.get())
+    {
+        // Attribute names are shared only within a document.
+        _attributeNames = copyAttributeNames(*_attributeNames);
+    }
 
     for (ElementPtr child : source->getChildren())
     {
@@ -393,7 +556,7 @@ void Element::copyContentFrom(ConstElementPtr source, const CopyOptions* copyOpt
         {
             continue;
         }
-        ElementPtr childCopy = addChildOfCategory(child->getCategory(), name);
+        ElementPtr childCopy = addChildOfCategory(child->getCategorySymbol(), name);
         childCopy->copyContentFrom(child);
     }
 }
@@ -407,8 +570,8 @@ void Element::clearContent()
     doc->onClearContent(getSelf());
 
     _sourceUri = EMPTY_STRING;
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributeNames = nullptr;
+    _attributeValues.clear();
 
     vector<ElementPtr> children = getChildren();
     for (ElementPtr child : children)
@@ -423,17 +586,26 @@ bool Element::validate(string* message) const
     validateRequire(isValidName(getName()), res, message, "Invalid element name");
     if (hasInheritString())
     {
-        bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
+        bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategorySymbol() == _category;
         validateRequire(validInherit, res, message, "Invalid element inheritance");
     }
-    for (ElementPtr child : getChildren())
+    if (!singleElementValidation)
     {
-        res = child->validate(message) && res;
+        for (ElementPtr child : getChildren())
+        {
+            res = child->validate(message) && res;
+        }
     }
     validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
     return res;
 }
 
+bool Element::validateElement(vector<ValidationDiagnostic>* diagnostics) const
+{
+    SingleElementValidation scope(diagnostics);
+    return validate();
+}
+
 StringResolverPtr Element::createStringResolver(const string& geom,
                                                 ConstMaterialPtr material,
                                                 const string& target,
@@ -494,6 +666,28 @@ string Element::asString() const
     return res;
 }
 
+ConstElementPtr Element::resolveLibraryNameReference(const string& name) const
+{
+    ConstDocumentPtr doc = getRoot()->asA<Document>();
+    if (!doc)
+    {
+        return ConstElementPtr();
+    }
+    for (ConstDocumentPtr library : doc->getReferencedLibraries())
+    {
+        ElementPtr child = library->findRootElement(getQualifiedName(name));
+        if (!child)
+        {
+            child = library->findRootElement(name);
+        }
+        if (child)
+        {
+            return child;
+        }
+    }
+    return ConstElementPtr();
+}
+
 void Element::validateRequire(bool expression, bool& res, string* message, string errorDesc) const
 {
     if (!expression)
@@ -503,6 +697,10 @@ void Element::validateRequire(bool expression, bool& res, string* message, strin
         {
             *message += errorDesc + ": " + asString() + "\n";
         }
+        if (validationDiagnostics)
+        {
+            validationDiagnostics->emplace_back(getNamePath(), errorDesc, errorDesc + ": " + asString());
+        }
     }
 }
 
@@ -532,6 +730,32 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
     return resolver->resolve(getValueString(), getType());
 }
 
+ValuePtr ValueElement::getValue() const
+{
+    ValuePtr value = std::atomic_load(&_cachedValue);
+    if (!value && hasValue())
+    {
+        value = Value::createValueFromStrings(getValueString(), getType());
+        std::atomic_store(&_cachedValue, value);
+    }
+    return value;
+}
+
+ValuePtr ValueElement::getResolvedValue(StringResolverPtr resolver) const
+{
+    if (!hasValue())
+    {
+        return ValuePtr();
+    }
+
+    // Values without string substitutions share the cached value.
+    if (!StringResolver::isResolvedType(getType()))
+    {
+        return getValue();
+    }
+    return Value::createValueFromStrings(getResolvedValueString(resolver), getType());
+}
+
 ValuePtr ValueElement::getBoundValue(ConstMaterialPtr material) const
 {
     ElementPtr upstreamElem = getUpstreamElement(material);
@@ -680,7 +904,7 @@ template <class T> class ElementRegistry
   public:
     ElementRegistry()
     {
-        Element::_creatorMap[T::CATEGORY] = Element::createElement<T>;
+        Element::_creatorMap[Symbol(T::CATEGORY)] = Element::createElement<T>;
     }
     ~ElementRegistry() { }
 };
@@ -11,6 +11,8 @@
 
 #include <MaterialXCore/Library.h>
 
+#include <MaterialXCore/Arena.h>
+#include <MaterialXCore/Symbol.h>
 #include <MaterialXCore/Traversal.h>
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
@@ -26,6 +28,7 @@ class StringResolver;
 class Document;
 class Material;
 class CopyOptions;
+class ValidationDiagnostic;
 
 /// A shared pointer to an Element
 using ElementPtr = shared_ptr<Element>;
@@ -95,6 +98,12 @@ class Element : public std::enable_shared_from_this<Element>
 
     /// Set the element's category string.
     void setCategory(const string& category)
+    {
+        _category = Symbol(category);
+    }
+
+    /// Set the element's category from an interned symbol.
+    void setCategory(const Symbol& category)
     {
         _category = category;
     }
@@ -103,6 +112,13 @@ class Element : public std::enable_shared_from_this<Element>
     /// element represents its role within the document, with common examples
     /// being "material", "nodegraph", and "image".
     const string& getCategory() const
+    {
+        return _category.str();
+    }
+
+    /// Return the element's category as an interned symbol, allowing
+    /// categories to be compared by address.
+    Symbol getCategorySymbol() const
     {
         return _category;
     }
@@ -440,6 +456,19 @@ class Element : public std::enable_shared_from_this<Element>
     ElementPtr addChildOfCategory(const string& category,
                                   const string& name = EMPTY_STRING);
 
+    /// Add a child element of the given category symbol and name.  This is
+    /// equivalent to the string version, but avoids interning the category.
+    ElementPtr addChildOfCategory(const Symbol& category,
+                                  const string& name = EMPTY_STRING);
+
+    /// Move the given element, with all of its descendants, from its current
+    /// parent to the end of the children of this element.  The moved elements
+    /// are transferred rather than copied, and may belong to another document.
+    /// @throws Exception if a child of this element already possesses the
+    ///    name of the given element, or if the given element is this element
+    ///    or one of its ancestors.
+    void moveChild(ElementPtr child);
+
     /// Return the child element, if any, with the given name.
     ElementPtr getChild(const string& name) const
     {
@@ -511,27 +540,47 @@ class Element : public std::enable_shared_from_this<Element>
     /// Set the value string of the given attribute.
     void setAttribute(const string& attrib, const string& value);
 
+    /// Set the value string of the attribute with the given interned name.
+    void setAttribute(const Symbol& attrib, const string& value);
+
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != INVALID_ATTRIBUTE_INDEX;
+    }
+
+    /// Return true if the attribute with the given interned name is present.
+    bool hasAttribute(const Symbol& attrib) const
+    {
+        return findAttribute(attrib) != INVALID_ATTRIBUTE_INDEX;
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        if (it == _attributeMap.end())
+        size_t index = findAttribute(attrib);
+        if (index == INVALID_ATTRIBUTE_INDEX)
             return EMPTY_STRING;
         else
-            return it->second;
+            return _attributeValues[index];
+    }
+
+    /// Return the value string of the attribute with the given interned name.
+    /// If the attribute is not present, then an empty string is returned.
+    const string& getAttribute(const Symbol& attrib) const
+    {
+        size_t index = findAttribute(attrib);
+        if (index == INVALID_ATTRIBUTE_INDEX)
+            return EMPTY_STRING;
+        else
+            return _attributeValues[index];
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
     const StringVec& getAttributeNames() const
     {
-        return _attributeOrder;
+        return _attributeNames ? _attributeNames->names : EMPTY_ATTRIBUTE_NAMES;
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -762,6 +811,14 @@ class Element : public std::enable_shared_from_this<Element>
     /// consistent with the MaterialX specification.
     virtual bool validate(string* message = nullptr) const;
 
+    /// Validate that this element alone, excluding its descendants, is
+    /// consistent with the MaterialX specification.  Elements of a document
+    /// that is not being modified may be validated concurrently.
+    /// @param diagnostics An optional output vector, to which a diagnostic
+    ///    for each failed rule is appended.
+    /// @return True if the element passes all tests, false otherwise.
+    bool validateElement(vector<ValidationDiagnostic>* diagnostics = nullptr) const;
+
     /// @}
     /// @name Utility
     /// @{
@@ -823,9 +880,32 @@ class Element : public std::enable_shared_from_this<Element>
     {
         ConstElementPtr root = getRoot();
         shared_ptr<T> child = root->getChildOfType<T>(getQualifiedName(name));
-        return child ? child : root->getChildOfType<T>(name);
+        if (!child)
+        {
+            child = root->getChildOfType<T>(name);
+        }
+        return child;
     }
 
+    // Resolve a reference to a named element at the root scope of this
+    // document, or of its referenced libraries if no such element exists in
+    // this document.  Library elements are shared between documents, so they
+    // are returned as const.
+    template<class T> shared_ptr<const T> resolveLibraryRootNameReference(const string& name) const
+    {
+        shared_ptr<const T> child = resolveRootNameReference<T>(name);
+        if (!child)
+        {
+            ConstElementPtr libraryChild = resolveLibraryNameReference(name);
+            child = libraryChild ? libraryChild->asA<T>() : shared_ptr<const T>();
+        }
+        return child;
+    }
+
+    // Resolve a reference to a named element at the root scope of the
+    // libraries referenced by this document.
+    ConstElementPtr resolveLibraryNameReference(const string& name) const;
+
     // Enforce a requirement within a validate method, updating the validation
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, string errorDesc) const;
@@ -845,6 +925,9 @@ class Element : public std::enable_shared_from_this<Element>
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Called when the names or order of the children of this element change.
+    virtual void onChildrenChanged() { }
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -852,16 +935,95 @@ class Element : public std::enable_shared_from_this<Element>
         return std::const_pointer_cast<Element>(shared_from_this());
     }
 
+    // Return the index of the given attribute, or INVALID_ATTRIBUTE_INDEX if
+    // the attribute is not present.  Elements store few attributes, so a linear
+    // search of their interned names is faster than a hashed lookup.
+    size_t findAttribute(const Symbol& attrib) const
+    {
+        if (_attributeNames)
+        {
+            const vector<Symbol>& symbols = _attributeNames->symbols;
+            for (size_t i = 0; i < symbols.size(); i++)
+            {
+                if (symbols[i] == attrib)
+                    return i;
+            }
+        }
+        return INVALID_ATTRIBUTE_INDEX;
+    }
+
+    // Return the index of the given attribute.  A string that has never been
+    // interned cannot name an attribute, so it is looked up without interning.
+    size_t findAttribute(const string& attrib) const
+    {
+        Symbol symbol;
+        if (!_attributeNames || !Symbol::find(attrib, symbol))
+            return INVALID_ATTRIBUTE_INDEX;
+        return findAttribute(symbol);
+    }
+
+    // Return the memory arena, if any, of the document that owns this element.
+    ArenaPtr getDocumentArena() const;
+
+    // Allocate a new element of the given subclass, using the memory arena
+    // of the parent's document if arena storage is enabled.
+    template <class T> static shared_ptr<T> allocateElement(ElementPtr parent, const string& name)
+    {
+        ArenaPtr arena = parent ? parent->getDocumentArena() : nullptr;
+        if (arena)
+        {
+            return std::allocate_shared<T>(ArenaAllocator<T>(arena), parent, name);
+        }
+        return std::make_shared<T>(parent, name);
+    }
+
   protected:
-    string _category;
+    // An immutable sequence of attribute names, shared by the elements of a
+    // document that set the same attributes in the same order.  Each document
+    // owns an empty root sequence, from which all others are formed.  Since a
+    // sequence holds only weak references to its successors, it is released
+    // along with the last element that uses it.
+    class AttributeNames : public std::enable_shared_from_this<AttributeNames>
+    {
+      public:
+        AttributeNames() :
+            root(this)
+        {
+        }
+
+        // Return the sequence formed by appending the given name to this one.
+        shared_ptr<const AttributeNames> append(const Symbol& name) const;
+
+      public:
+        StringVec names;
+        vector<Symbol> symbols;
+        const AttributeNames* root;
+
+      private:
+        shared_ptr<const AttributeNames> _parent;
+        mutable std::unordered_map<Symbol, weak_ptr<const AttributeNames>> _successors;
+    };
+    using AttributeNamesPtr = shared_ptr<const AttributeNames>;
+
+    // Return the sequence of this element's document that holds the given
+    // attribute names, omitting the name at the given index if any.
+    AttributeNamesPtr copyAttributeNames(const AttributeNames& names, size_t skipIndex = INVALID_ATTRIBUTE_INDEX) const;
+
+  protected:
+    static const size_t INVALID_ATTRIBUTE_INDEX = (size_t) -1;
+
+    Symbol _category;
     string _name;
     string _sourceUri;
 
     ElementMap _childMap;
     vector<ElementPtr> _childOrder;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    // Attribute names are stored as shared, immutable sequences, so that
+    // elements with identical attribute names share a single copy of them.
+    // Attribute values are stored in the same order.
+    AttributeNamesPtr _attributeNames;
+    StringVec _attributeValues;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
@@ -870,14 +1032,16 @@ class Element : public std::enable_shared_from_this<Element>
     Element(const Element&) = delete;
     Element& operator=(const Element&) = delete;
 
+    static const StringVec EMPTY_ATTRIBUTE_NAMES;
+
     template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
     {
-        return std::make_shared<T>(parent, name);
+        return allocateElement<T>(parent, name);
     }
 
   private:
     using CreatorFunction = ElementPtr (*)(ElementPtr, const string&);
-    using CreatorMap = std::unordered_map<string, CreatorFunction>;
+    using CreatorMap = std::unordered_map<Symbol, CreatorFunction>;
 
     static CreatorMap _creatorMap;
 };
@@ -1043,14 +1207,13 @@ class ValueElement : public TypedElement
     /// Return the typed value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
+    /// The value is parsed on first access and cached until the value or
+    /// type of the element changes, so repeated calls return the same shared
+    /// object, which should not be modified.
+    ///
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
-    ValuePtr getValue() const
-    {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getValueString(), getType());
-    }
+    ValuePtr getValue() const;
 
     /// Return the resolved value of an element as a generic value object, which
     /// may be queried to access its data.
@@ -1060,12 +1223,7 @@ class ValueElement : public TypedElement
     ///    will be created at this scope and applied to the return value.
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
-    ValuePtr getResolvedValue(StringResolverPtr resolver = nullptr) const
-    {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getResolvedValueString(resolver), getType());
-    }
+    ValuePtr getResolvedValue(StringResolverPtr resolver = nullptr) const;
 
     /// @}
     /// @name Bound Value
@@ -1117,6 +1275,17 @@ class ValueElement : public TypedElement
     static const string UI_FOLDER_ATTRIBUTE;
     static const string UI_MIN_ATTRIBUTE;
     static const string UI_MAX_ATTRIBUTE;
+
+  protected:
+    friend class Document;
+
+    void clearCachedValue()
+    {
+        std::atomic_store(&_cachedValue, ValuePtr());
+    }
+
+  private:
+    mutable ValuePtr _cachedValue;
 };
 
 /// @class Token
@@ -1280,6 +1449,41 @@ class StringResolver
     StringMap _geomNameMap;
 };
 
+/// @class ValidationDiagnostic
+/// A description of a validation rule that an element fails to meet.
+class ValidationDiagnostic
+{
+  public:
+    ValidationDiagnostic(const string& elementPath, const string& rule, const string& message) :
+        elementPath(elementPath),
+        rule(rule),
+        message(message)
+    {
+    }
+    ~ValidationDiagnostic() { }
+
+    bool operator==(const ValidationDiagnostic& rhs) const
+    {
+        return elementPath == rhs.elementPath &&
+               rule == rhs.rule &&
+               message == rhs.message;
+    }
+    bool operator!=(const ValidationDiagnostic& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// The name path of the element that failed the rule.
+    string elementPath;
+
+    /// A short description of the rule, such as "Invalid element name".
+    string rule;
+
+    /// A full description of the failure, in the form appended to the
+    /// message of a validate method.
+    string message;
+};
+
 /// @class CopyOptions
 /// A set of options for controlling the behavior of element copy operations.
 class CopyOptions
@@ -1316,7 +1520,7 @@ template<class T> shared_ptr<T> Element::addChild(const string& name)
     if (_childMap.count(childName))
         throw Exception("Child name is not unique: " + childName);
 
-    shared_ptr<T> child = std::make_shared<T>(getSelf(), childName);
+    shared_ptr<T> child = allocateElement<T>(getSelf(), childName);
     registerChildElement(child);
 
     return child;
@@ -25,13 +25,28 @@ const string Collection::INCLUDE_GEOM_ATTRIBUTE = "includegeom";
 const string Collection::EXCLUDE_GEOM_ATTRIBUTE = "excludegeom";
 const string Collection::INCLUDE_COLLECTION_ATTRIBUTE = "includecollection";
 
-bool geomStringsMatch(const string& geom1, const string& geom2, bool contains)
+namespace {
+
+bool geomPathsMatch(const vector<GeomPath>& paths1, const vector<GeomPath>& paths2, bool contains = false)
 {
-    vector<GeomPath> paths1;
-    for (const string& name1 : splitString(geom1, ARRAY_VALID_SEPARATORS))
+    for (const GeomPath& path2 : paths2)
     {
-        paths1.push_back(GeomPath(name1));
+        for (const GeomPath& path1 : paths1)
+        {
+            if (path1.isMatching(path2, contains))
+            {
+                return true;
+            }
+        }
     }
+    return false;
+}
+
+} // anonymous namespace
+
+bool geomStringsMatch(const string& geom1, const string& geom2, bool contains)
+{
+    vector<GeomPath> paths1 = parseGeomString(geom1);
     for (const string& name2 : splitString(geom2, ARRAY_VALID_SEPARATORS))
     {
         GeomPath path2(name2);
@@ -46,6 +61,16 @@ bool geomStringsMatch(const string& geom1, const string& geom2, bool contains)
     return false;
 }
 
+vector<GeomPath> parseGeomString(const string& geom)
+{
+    vector<GeomPath> paths;
+    for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
+    {
+        paths.push_back(GeomPath(name));
+    }
+    return paths;
+}
+
 //
 // GeomElement methods
 //
@@ -139,44 +164,95 @@ bool Collection::hasIncludeCycle() const
 
 bool Collection::matchesGeomString(const string& geom) const
 {
-    if (geomStringsMatch(getActiveExcludeGeom(), geom, true))
-    {
-        return false;
-    }
-    if (geomStringsMatch(getActiveIncludeGeom(), geom))
+    return getFlattenedCollection()->matchesGeomPaths(parseGeomString(geom));
+}
+
+vector<bool> Collection::matchesGeomStrings(const StringVec& geoms) const
+{
+    ConstFlattenedCollectionPtr flattened = getFlattenedCollection();
+    vector<bool> matches;
+    matches.reserve(geoms.size());
+    for (const string& geom : geoms)
     {
-        return true;
+        matches.push_back(flattened->matchesGeomPaths(parseGeomString(geom)));
     }
+    return matches;
+}
+
+ConstFlattenedCollectionPtr Collection::getFlattenedCollection() const
+{
+    return getDocument()->getFlattenedCollection(getSelf()->asA<Collection>());
+}
+
+bool Collection::validate(string* message) const
+{
+    bool res = true;
+    validateRequire(!hasIncludeCycle(), res, message, "Cycle in collection include chain");
+    return Element::validate(message) && res;
+}
+
+//
+// FlattenedCollection methods
+//
 
+FlattenedCollection::FlattenedCollection(ConstCollectionPtr collection) :
+    _name(collection->getName()),
+    _cycle(false)
+{
+    // Gather the include chain breadth first, treating any collection that
+    // is reached twice as a cycle.
     std::set<CollectionPtr> includedSet;
-    vector<CollectionPtr> includedVec = getIncludeCollections();
+    vector<CollectionPtr> includedVec = collection->getIncludeCollections();
     for (size_t i = 0; i < includedVec.size(); i++)
     {
-        CollectionPtr collection = includedVec[i];
-        if (includedSet.count(collection))
+        CollectionPtr included = includedVec[i];
+        if (includedSet.count(included))
         {
-            throw ExceptionFoundCycle("Encountered a cycle in collection: " + getName());
+            _cycle = true;
+            break;
         }
-        includedSet.insert(collection);
-        vector<CollectionPtr> appendVec = collection->getIncludeCollections();
+        includedSet.insert(included);
+        vector<CollectionPtr> appendVec = included->getIncludeCollections();
         includedVec.insert(includedVec.end(), appendVec.begin(), appendVec.end());
     }
-    for (ConstCollectionPtr collection : includedSet)
+
+    _members.push_back({ parseGeomString(collection->getActiveIncludeGeom()),
+                         parseGeomString(collection->getActiveExcludeGeom()) });
+    if (!_cycle)
     {
-        if (collection->matchesGeomString(geom))
+        for (size_t i = 0; i < includedVec.size(); i++)
         {
-            return true;
+            _members.push_back({ parseGeomString(includedVec[i]->getActiveIncludeGeom()),
+                                 parseGeomString(includedVec[i]->getActiveExcludeGeom()) });
         }
     }
-
-    return false;
 }
 
-bool Collection::validate(string* message) const
+bool FlattenedCollection::matchesGeomPaths(const vector<GeomPath>& paths) const
 {
-    bool res = true;
-    validateRequire(!hasIncludeCycle(), res, message, "Cycle in collection include chain");
-    return Element::validate(message) && res;
+    const Member& self = _members[0];
+    if (geomPathsMatch(self.excludeGeom, paths, true))
+    {
+        return false;
+    }
+    if (geomPathsMatch(self.includeGeom, paths))
+    {
+        return true;
+    }
+    if (_cycle)
+    {
+        throw ExceptionFoundCycle("Encountered a cycle in collection: " + _name);
+    }
+    for (size_t i = 1; i < _members.size(); i++)
+    {
+        const Member& member = _members[i];
+        if (geomPathsMatch(member.includeGeom, paths) &&
+            !geomPathsMatch(member.excludeGeom, paths, true))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 } // namespace MaterialX
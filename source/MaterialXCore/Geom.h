@@ -28,6 +28,7 @@ class GeomPropDef;
 class Collection;
 class CollectionAdd;
 class CollectionRemove;
+class FlattenedCollection;
 
 /// A shared pointer to a GeomElement
 using GeomElementPtr = shared_ptr<GeomElement>;
@@ -54,6 +55,9 @@ using CollectionPtr = shared_ptr<Collection>;
 /// A shared pointer to a const Collection
 using ConstCollectionPtr = shared_ptr<const Collection>;
 
+/// A shared pointer to a const FlattenedCollection
+using ConstFlattenedCollectionPtr = shared_ptr<const FlattenedCollection>;
+
 /// @class GeomPath
 /// A MaterialX geometry path, representing the hierarchical location
 /// expressed by a geometry name.
@@ -582,6 +586,16 @@ class Collection : public Element
     /// @throws ExceptionFoundCycle if a cycle is encountered.
     bool matchesGeomString(const string& geom) const;
 
+    /// Return true for each of the given geometry strings that has any
+    /// geometries in common with this collection.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    vector<bool> matchesGeomStrings(const StringVec& geoms) const;
+
+    /// Return the flattened include and exclude geometry of this collection
+    /// and its include chain.  The flattened collection is held by the
+    /// document until a collection of the document is modified.
+    ConstFlattenedCollectionPtr getFlattenedCollection() const;
+
     /// @}
     /// @name Validation
     /// @{
@@ -599,6 +613,62 @@ class Collection : public Element
     static const string INCLUDE_COLLECTION_ATTRIBUTE;
 };
 
+/// @class FlattenedCollection
+/// The include and exclude geometry of a Collection and of every collection
+/// in its include chain, parsed into geometry paths.
+///
+/// A collection contains a geometry if the geometry is not excluded by the
+/// collection itself, and is included but not excluded by the collection or
+/// by any collection in its include chain.  Flattening the include chain in
+/// this way allows membership to be tested without traversing the chain.
+class FlattenedCollection
+{
+  public:
+    /// The parsed include and exclude geometry of a single collection.
+    struct Member
+    {
+        vector<GeomPath> includeGeom;
+        vector<GeomPath> excludeGeom;
+    };
+
+  public:
+    /// Flatten the given collection and its include chain.
+    explicit FlattenedCollection(ConstCollectionPtr collection);
+    ~FlattenedCollection() { }
+
+    /// Return the name of the flattened collection.
+    const string& getName() const
+    {
+        return _name;
+    }
+
+    /// Return the members of the flattened collection, beginning with the
+    /// collection itself and followed by each collection in its include
+    /// chain.  If the include chain contains a cycle, then only the
+    /// collection itself is returned.
+    const vector<Member>& getMembers() const
+    {
+        return _members;
+    }
+
+    /// Return true if the include chain of the collection contains a cycle.
+    bool hasIncludeCycle() const
+    {
+        return _cycle;
+    }
+
+    /// Return true if the collection and the given geometry paths have any
+    /// geometries in common.
+    /// @throws ExceptionFoundCycle if the include chain of the collection
+    ///    must be evaluated and contains a cycle.
+    bool matchesGeomPaths(const vector<GeomPath>& paths) const;
+
+  private:
+    string _name;
+    vector<Member> _members;
+    bool _cycle;
+};
+
 template<class T> GeomAttrPtr GeomInfo::setGeomAttrValue(const string& name,
                                                          const T& value,
                                                          const string& type)
@@ -622,6 +692,10 @@ template<class T> GeomAttrPtr GeomInfo::setGeomAttrValue(const string& name,
 /// @todo Geometry name expressions are not yet supported.
 bool geomStringsMatch(const string& geom1, const string& geom2, bool contains = false);
 
+/// Parse a geometry string, containing an array of geom names, into a vector
+/// of geometry paths.
+vector<GeomPath> parseGeomString(const string& geom);
+
 } // namespace MaterialX
 
 #endif
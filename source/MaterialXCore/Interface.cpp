@@ -10,6 +10,8 @@
 #include <MaterialXCore/Material.h>
 #include <MaterialXCore/Node.h>
 
+#include <atomic>
+
 namespace MaterialX
 {
 
@@ -260,7 +262,9 @@ bool Output::hasUpstreamCycle() const
 {
     try
     {
-        for (Edge edge : traverseGraph()) { }
+        // Iterate without constructing edges, since only the cycle check
+        // performed by the traversal is needed.
+        for (GraphIterator it = traverseGraph().begin(); it != GraphIterator::end(); ++it) { }
     }
     catch (ExceptionFoundCycle&)
     {
@@ -277,127 +281,147 @@ bool Output::validate(string* message) const
 }
 
 //
-// InterfaceElement methods
+// ActivePortTable methods
 //
 
-ParameterPtr InterfaceElement::getActiveParameter(const string& name) const
+ActivePortTable::ActivePortTable(const InterfaceElement& interface) :
+    _portRevision(interface._portRevision),
+    _inheritanceRevision(interface.getDocument()->getInheritanceRevision())
 {
-    for (ConstElementPtr elem : traverseInheritance())
+    for (ConstElementPtr elem : interface.traverseInheritance())
     {
-        ParameterPtr param = elem->asA<InterfaceElement>()->getParameter(name);
-        if (param)
+        for (const ElementPtr& child : elem->getChildren())
         {
-            return param;
+            ValueElementPtr valueElem = child->asA<ValueElement>();
+            if (!valueElem)
+            {
+                continue;
+            }
+            _valueElements.push_back(valueElem);
+            _valueElementMap.insert(std::make_pair(valueElem->getName(), valueElem));
+            if (ParameterPtr param = child->asA<Parameter>())
+            {
+                _parameters.push_back(param);
+            }
+            else if (InputPtr input = child->asA<Input>())
+            {
+                _inputs.push_back(input);
+            }
+            else if (OutputPtr output = child->asA<Output>())
+            {
+                _outputs.push_back(output);
+            }
+            else if (TokenPtr token = child->asA<Token>())
+            {
+                _tokens.push_back(token);
+            }
         }
     }
-    return nullptr;
 }
 
-vector<ParameterPtr> InterfaceElement::getActiveParameters() const
+//
+// InterfaceElement methods
+//
+
+size_t InterfaceElement::createPortRevision()
 {
-    vector<ParameterPtr> activeParams;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<ParameterPtr> params = elem->asA<InterfaceElement>()->getParameters();
-        activeParams.insert(activeParams.end(), params.begin(), params.end());
-    }
-    return activeParams;
+    // Revisions are unique across all interfaces, so that a table is never
+    // matched by a new interface allocated at the address of a deleted one.
+    static std::atomic<size_t> nextRevision(1);
+    return nextRevision++;
 }
 
-InputPtr InterfaceElement::getActiveInput(const string& name) const
+ConstActivePortTablePtr InterfaceElement::getActivePortTable() const
 {
+    // A table is current while the ports of this interface and the
+    // inheritance revision of its document are unchanged.  The document
+    // revision advances with any change to an inheritance chain, or to the
+    // ports of an element that may be inherited from.
+    ConstActivePortTablePtr table = std::atomic_load(&_activePortTable);
+    if (!table ||
+        table->_portRevision != _portRevision ||
+        table->_inheritanceRevision != getDocument()->getInheritanceRevision())
+    {
+        table = std::make_shared<ActivePortTable>(*this);
+        std::atomic_store(&_activePortTable, table);
+    }
+    return table;
+}
+
+template<class T> shared_ptr<T> InterfaceElement::getActivePort(const string& name) const
+{
+    ValueElementPtr valueElem = getActivePortTable()->getValueElement(name);
+    if (!valueElem)
+    {
+        return nullptr;
+    }
+    shared_ptr<T> port = valueElem->asA<T>();
+    if (port)
+    {
+        return port;
+    }
+
+    // The first value element with this name is of another type, so search
+    // the remainder of the inheritance chain.
     for (ConstElementPtr elem : traverseInheritance())
     {
-        InputPtr input = elem->asA<InterfaceElement>()->getInput(name);
-        if (input)
+        port = elem->getChildOfType<T>(name);
+        if (port)
         {
-            return input;
+            return port;
         }
     }
     return nullptr;
 }
 
+ParameterPtr InterfaceElement::getActiveParameter(const string& name) const
+{
+    return getActivePort<Parameter>(name);
+}
+
+vector<ParameterPtr> InterfaceElement::getActiveParameters() const
+{
+    return getActivePortTable()->getParameters();
+}
+
+InputPtr InterfaceElement::getActiveInput(const string& name) const
+{
+    return getActivePort<Input>(name);
+}
+
 vector<InputPtr> InterfaceElement::getActiveInputs() const
 {
-    vector<InputPtr> activeInputs;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<InputPtr> inputs = elem->asA<InterfaceElement>()->getInputs();
-        activeInputs.insert(activeInputs.end(), inputs.begin(), inputs.end());
-    }
-    return activeInputs;
+    return getActivePortTable()->getInputs();
 }
 
 OutputPtr InterfaceElement::getActiveOutput(const string& name) const
 {
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        OutputPtr output = elem->asA<InterfaceElement>()->getOutput(name);
-        if (output)
-        {
-            return output;
-        }
-    }
-    return nullptr;
+    return getActivePort<Output>(name);
 }
 
 vector<OutputPtr> InterfaceElement::getActiveOutputs() const
 {
-    vector<OutputPtr> activeOutputs;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<OutputPtr> outputs = elem->asA<InterfaceElement>()->getOutputs();
-        activeOutputs.insert(activeOutputs.end(), outputs.begin(), outputs.end());
-    }
-    return activeOutputs;
+    return getActivePortTable()->getOutputs();
 }
 
 TokenPtr InterfaceElement::getActiveToken(const string& name) const
 {
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        TokenPtr token = elem->asA<InterfaceElement>()->getToken(name);
-        if (token)
-        {
-            return token;
-        }
-    }
-    return nullptr;
+    return getActivePort<Token>(name);
 }
 
 vector<TokenPtr> InterfaceElement::getActiveTokens() const
 {
-    vector<TokenPtr> activeTokens;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<TokenPtr> tokens = elem->asA<InterfaceElement>()->getTokens();
-        activeTokens.insert(activeTokens.end(), tokens.begin(), tokens.end());
-    }
-    return activeTokens;
+    return getActivePortTable()->getTokens();
 }
 
 ValueElementPtr InterfaceElement::getActiveValueElement(const string& name) const
 {
-    for (ConstElementPtr interface : traverseInheritance())
-    {
-        ValueElementPtr valueElem = interface->getChildOfType<ValueElement>(name);
-        if (valueElem)
-        {
-            return valueElem;
-        }
-    }
-    return nullptr;
+    return getActivePort<ValueElement>(name);
 }
 
 vector<ValueElementPtr> InterfaceElement::getActiveValueElements() const
 {
-    vector<ValueElementPtr> activeValueElems;
-    for (ConstElementPtr interface : traverseInheritance())
-    {
-        vector<ValueElementPtr> valueElems = interface->getChildrenOfType<ValueElement>();
-        activeValueElems.insert(activeValueElems.end(), valueElems.begin(), valueElems.end());
-    }
-    return activeValueElems;
+    return getActivePortTable()->getValueElements();
 }
 
 ValuePtr InterfaceElement::getParameterValue(const string& name, const string& target) const
@@ -447,6 +471,7 @@ ValuePtr InterfaceElement::getInputValue(const string& name, const string& targe
 void InterfaceElement::registerChildElement(ElementPtr child)
 {
     TypedElement::registerChildElement(child);
+    _portRevision = createPortRevision();
     if (child->isA<Parameter>())
     {
         _parameterCount++;
@@ -464,6 +489,7 @@ void InterfaceElement::registerChildElement(ElementPtr child)
 void InterfaceElement::unregisterChildElement(ElementPtr child)
 {
     TypedElement::unregisterChildElement(child);
+    _portRevision = createPortRevision();
     if (child->isA<Parameter>())
     {
         _parameterCount--;
@@ -478,6 +504,12 @@ void InterfaceElement::unregisterChildElement(ElementPtr child)
     }
 }
 
+void InterfaceElement::onChildrenChanged()
+{
+    TypedElement::onChildrenChanged();
+    _portRevision = createPortRevision();
+}
+
 ConstNodeDefPtr InterfaceElement::getDeclaration(const string&) const
 {
     return NodeDefPtr();
@@ -493,7 +525,7 @@ bool InterfaceElement::isTypeCompatible(ConstInterfaceElementPtr declaration) co
     {
         ValueElementPtr declarationValue = declaration->getActiveValueElement(value->getName());
         if (!declarationValue ||
-            declarationValue->getCategory() != value->getCategory() ||
+            declarationValue->getCategorySymbol() != value->getCategorySymbol() ||
             declarationValue->getType() != value->getType())
         {
             return false;
@@ -23,6 +23,7 @@ class PortElement;
 class Input;
 class Output;
 class InterfaceElement;
+class ActivePortTable;
 class Node;
 class NodeDef;
 
@@ -51,6 +52,9 @@ using InterfaceElementPtr = shared_ptr<InterfaceElement>;
 /// A shared pointer to a const InterfaceElement
 using ConstInterfaceElementPtr = shared_ptr<const InterfaceElement>;
 
+/// A shared pointer to a const ActivePortTable
+using ConstActivePortTablePtr = shared_ptr<const ActivePortTable>;
+
 using CharSet = std::set<char>;
 
 /// @class Parameter
@@ -323,6 +327,69 @@ class Output : public PortElement
     static const string CATEGORY;
 };
 
+/// @class ActivePortTable
+/// The active ports of an interface, gathered across its inheritance chain.
+///
+/// A table is a snapshot of the interface at the time it was returned, and
+/// is not affected by later changes to the interface or its inheritance.
+class ActivePortTable
+{
+  public:
+    explicit ActivePortTable(const InterfaceElement& interface);
+    ~ActivePortTable() { }
+
+    /// Return the active parameters of the interface.
+    const vector<ParameterPtr>& getParameters() const
+    {
+        return _parameters;
+    }
+
+    /// Return the active inputs of the interface.
+    const vector<InputPtr>& getInputs() const
+    {
+        return _inputs;
+    }
+
+    /// Return the active outputs of the interface.
+    const vector<OutputPtr>& getOutputs() const
+    {
+        return _outputs;
+    }
+
+    /// Return the active tokens of the interface.
+    const vector<TokenPtr>& getTokens() const
+    {
+        return _tokens;
+    }
+
+    /// Return all active value elements of the interface.
+    const vector<ValueElementPtr>& getValueElements() const
+    {
+        return _valueElements;
+    }
+
+    /// Return the first active value element with the given name, or an
+    /// empty shared pointer if no such element is found.
+    ValueElementPtr getValueElement(const string& name) const
+    {
+        auto it = _valueElementMap.find(name);
+        return it != _valueElementMap.end() ? it->second : ValueElementPtr();
+    }
+
+  private:
+    friend class InterfaceElement;
+
+    size_t _portRevision;
+    size_t _inheritanceRevision;
+
+    vector<ParameterPtr> _parameters;
+    vector<InputPtr> _inputs;
+    vector<OutputPtr> _outputs;
+    vector<TokenPtr> _tokens;
+    vector<ValueElementPtr> _valueElements;
+    std::unordered_map<string, ValueElementPtr> _valueElementMap;
+};
+
 /// @class InterfaceElement
 /// The base class for interface elements such as Node, NodeDef, and NodeGraph.
 ///
@@ -335,7 +402,8 @@ class InterfaceElement : public TypedElement
         TypedElement(parent, category, name),
         _parameterCount(0),
         _inputCount(0),
-        _outputCount(0)
+        _outputCount(0),
+        _portRevision(createPortRevision())
     {
     }
   public:
@@ -571,6 +639,12 @@ class InterfaceElement : public TypedElement
     /// Examples of value elements are Parameter, Input, Output, and Token.
     vector<ValueElementPtr> getActiveValueElements() const;
 
+    /// Return the table of active ports of this interface, taking inheritance
+    /// into account.  The table is shared between calls until the ports or
+    /// inheritance of the interface change, and avoids the copies made by
+    /// the getActive methods that return vectors.
+    ConstActivePortTablePtr getActivePortTable() const;
+
     /// @}
     /// @name Values
     /// @{
@@ -656,11 +730,20 @@ class InterfaceElement : public TypedElement
   protected:
     void registerChildElement(ElementPtr child) override;
     void unregisterChildElement(ElementPtr child) override;
+    void onChildrenChanged() override;
+
+  private:
+    friend class ActivePortTable;
+
+    static size_t createPortRevision();
+    template<class T> shared_ptr<T> getActivePort(const string& name) const;
 
   private:
     size_t _parameterCount;
     size_t _inputCount;
     size_t _outputCount;
+    size_t _portRevision;
+    mutable ConstActivePortTablePtr _activePortTable;
 };
 
 template<class T> ParameterPtr InterfaceElement::setParameterValue(const string& name,
@@ -5,6 +5,12 @@
 
 #include <MaterialXCore/Look.h>
 
+#include <MaterialXCore/Document.h>
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+
 namespace MaterialX
 {
 
@@ -16,6 +22,45 @@ const string Visibility::VIEWER_COLLECTION_ATTRIBUTE = "viewercollection";
 const string Visibility::VISIBILITY_TYPE_ATTRIBUTE = "vistype";
 const string Visibility::VISIBLE_ATTRIBUTE = "visible";
 
+namespace {
+
+// An entry of the geometry binding trie, recording that the geometry path
+// of a node is named by a material assignment or collection.
+struct BindingEntry
+{
+    enum Kind
+    {
+        ASSIGN_GEOM,
+        COLLECTION_INCLUDE,
+        COLLECTION_EXCLUDE
+    };
+
+    bool operator<(const BindingEntry& rhs) const
+    {
+        return kind != rhs.kind ? kind < rhs.kind : index < rhs.index;
+    }
+    bool operator==(const BindingEntry& rhs) const
+    {
+        return kind == rhs.kind && index == rhs.index;
+    }
+
+    Kind kind;
+    size_t index;
+};
+
+void sortUnique(vector<size_t>& vec)
+{
+    std::sort(vec.begin(), vec.end());
+    vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+}
+
+bool containsSorted(const vector<size_t>& vec, size_t value)
+{
+    return std::binary_search(vec.begin(), vec.end(), value);
+}
+
+} // anonymous namespace
+
 //
 // MaterialAssign methods
 //
@@ -109,4 +154,352 @@ MaterialPtr MaterialAssign::getReferencedMaterial() const
     return resolveRootNameReference<Material>(getMaterial());   
 }
 
+//
+// GeomBindingIndex methods
+//
+
+class GeomBindingIndex::Impl
+{
+  public:
+    Impl() :
+        nodes(1)
+    {
+    }
+
+    // A node of the trie, holding one component of a geometry path.
+    struct Node
+    {
+        Node() :
+            parent(0)
+        {
+        }
+
+        std::unordered_map<string, size_t> children;
+        size_t parent;
+
+        // The entries whose geometry paths end at this node.
+        vector<BindingEntry> entries;
+
+        // The assignment and include entries whose geometry paths end at
+        // this node or any of its descendants.
+        vector<BindingEntry> subtreeEntries;
+    };
+
+    struct CollectionData
+    {
+        CollectionPtr collection;
+
+        // The collections included by this collection, directly or
+        // indirectly, and whether expanding them encounters a cycle.
+        vector<size_t> includes;
+        bool cyclic;
+
+        // The material assignments that reference this collection.
+        vector<size_t> assigns;
+
+        // The referenced collections whose membership may depend on this
+        // collection, including this collection itself.
+        vector<size_t> dependents;
+    };
+
+    // The matches found for a geometry string.
+    struct Hits
+    {
+        vector<size_t> assigns;
+        vector<size_t> includes;
+        vector<size_t> excludes;
+    };
+
+    void addGeomString(const string& geom, BindingEntry entry)
+    {
+        for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
+        {
+            size_t node = 0;
+            for (const string& component : splitString(name, GEOM_PATH_SEPARATOR))
+            {
+                auto it = nodes[node].children.find(component);
+                if (it != nodes[node].children.end())
+                {
+                    node = it->second;
+                    continue;
+                }
+                size_t child = nodes.size();
+                nodes[node].children[component] = child;
+                nodes.emplace_back();
+                nodes[child].parent = node;
+                node = child;
+            }
+            nodes[node].entries.push_back(entry);
+        }
+    }
+
+    size_t addCollection(CollectionPtr collection)
+    {
+        auto it = collectionIndices.find(collection.get());
+        if (it != collectionIndices.end())
+        {
+            return it->second;
+        }
+        size_t index = collections.size();
+        collectionIndices[collection.get()] = index;
+        collections.emplace_back();
+        collections[index].collection = collection;
+        collections[index].cyclic = false;
+        addGeomString(collection->getActiveIncludeGeom(), { BindingEntry::COLLECTION_INCLUDE, index });
+        addGeomString(collection->getActiveExcludeGeom(), { BindingEntry::COLLECTION_EXCLUDE, index });
+
+        // Expand included collections as Collection::matchesGeomString does,
+        // recording a cycle if any collection is encountered twice.
+        std::set<CollectionPtr> includedSet;
+        vector<CollectionPtr> includedVec = collection->getIncludeCollections();
+        for (size_t i = 0; i < includedVec.size(); i++)
+        {
+            if (!includedSet.insert(includedVec[i]).second)
+            {
+                collections[index].cyclic = true;
+                return index;
+            }
+            vector<CollectionPtr> appendVec = includedVec[i]->getIncludeCollections();
+            includedVec.insert(includedVec.end(), appendVec.begin(), appendVec.end());
+        }
+        for (CollectionPtr included : includedSet)
+        {
+            size_t includedIndex = addCollection(included);
+            collections[index].includes.push_back(includedIndex);
+        }
+        return index;
+    }
+
+    void finalize()
+    {
+        // Children are always created after their parents, so a reverse pass
+        // gathers the entries of each subtree.
+        for (size_t i = nodes.size(); i-- > 0; )
+        {
+            Node& node = nodes[i];
+            for (const BindingEntry& entry : node.entries)
+            {
+                if (entry.kind != BindingEntry::COLLECTION_EXCLUDE)
+                {
+                    node.subtreeEntries.push_back(entry);
+                }
+            }
+            std::sort(node.subtreeEntries.begin(), node.subtreeEntries.end());
+            node.subtreeEntries.erase(std::unique(node.subtreeEntries.begin(), node.subtreeEntries.end()),
+                                      node.subtreeEntries.end());
+            if (i > 0)
+            {
+                vector<BindingEntry>& parentEntries = nodes[node.parent].subtreeEntries;
+                parentEntries.insert(parentEntries.end(), node.subtreeEntries.begin(), node.subtreeEntries.end());
+            }
+        }
+
+        for (size_t i = 0; i < collections.size(); i++)
+        {
+            if (collections[i].assigns.empty())
+            {
+                continue;
+            }
+            collections[i].dependents.push_back(i);
+            for (size_t included : collections[i].includes)
+            {
+                collections[included].dependents.push_back(i);
+            }
+            if (collections[i].cyclic)
+            {
+                cyclicCollections.push_back(i);
+            }
+        }
+    }
+
+    void addEntry(const BindingEntry& entry, Hits& hits) const
+    {
+        switch (entry.kind)
+        {
+            case BindingEntry::ASSIGN_GEOM:
+                hits.assigns.push_back(entry.index);
+                break;
+            case BindingEntry::COLLECTION_INCLUDE:
+                hits.includes.push_back(entry.index);
+                break;
+            case BindingEntry::COLLECTION_EXCLUDE:
+                hits.excludes.push_back(entry.index);
+                break;
+        }
+    }
+
+    // Gather the entries that match the given geometry string.  An entry
+    // matches a path if either is a prefix of the other, while an exclusion
+    // applies only to the paths that it contains.
+    void findHits(const string& geom, Hits& hits) const
+    {
+        for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
+        {
+            StringVec components = splitString(name, GEOM_PATH_SEPARATOR);
+            size_t node = 0;
+            for (size_t depth = 0; ; depth++)
+            {
+                bool complete = (depth == components.size());
+                for (const BindingEntry& entry : nodes[node].entries)
+                {
+                    if (!complete || entry.kind == BindingEntry::COLLECTION_EXCLUDE)
+                    {
+                        addEntry(entry, hits);
+                    }
+                }
+                if (complete)
+                {
+                    for (const BindingEntry& entry : nodes[node].subtreeEntries)
+                    {
+                        addEntry(entry, hits);
+                    }
+                    break;
+                }
+                auto it = nodes[node].children.find(components[depth]);
+                if (it == nodes[node].children.end())
+                {
+                    break;
+                }
+                node = it->second;
+            }
+        }
+        sortUnique(hits.assigns);
+        sortUnique(hits.includes);
+        sortUnique(hits.excludes);
+    }
+
+    // Return true if the given collection matches, following the evaluation
+    // order of Collection::matchesGeomString.
+    bool collectionMatches(size_t index, const Hits& hits, std::unordered_map<size_t, bool>& memo) const
+    {
+        auto it = memo.find(index);
+        if (it != memo.end())
+        {
+            return it->second;
+        }
+        bool match = false;
+        if (containsSorted(hits.excludes, index))
+        {
+            match = false;
+        }
+        else if (containsSorted(hits.includes, index))
+        {
+            match = true;
+        }
+        else if (collections[index].cyclic)
+        {
+            throw ExceptionFoundCycle("Encountered a cycle in collection: " + collections[index].collection->getName());
+        }
+        else
+        {
+            for (size_t included : collections[index].includes)
+            {
+                if (collectionMatches(included, hits, memo))
+                {
+                    match = true;
+                    break;
+                }
+            }
+        }
+        memo[index] = match;
+        return match;
+    }
+
+    vector<size_t> findAssigns(const string& geom, ConstMaterialPtr material) const
+    {
+        Hits hits;
+        findHits(geom, hits);
+
+        vector<size_t> matches;
+        for (size_t assign : hits.assigns)
+        {
+            if (!material || assignMaterials[assign] == material)
+            {
+                matches.push_back(assign);
+            }
+        }
+
+        // Evaluate only those referenced collections whose membership may
+        // have changed from the empty default, along with any collections
+        // whose evaluation would encounter a cycle.
+        vector<size_t> candidates = cyclicCollections;
+        for (size_t include : hits.includes)
+        {
+            const vector<size_t>& dependents = collections[include].dependents;
+            candidates.insert(candidates.end(), dependents.begin(), dependents.end());
+        }
+        sortUnique(candidates);
+
+        std::unordered_map<size_t, bool> memo;
+        for (size_t candidate : candidates)
+        {
+            for (size_t assign : collections[candidate].assigns)
+            {
+                if ((!material || assignMaterials[assign] == material) &&
+                    !containsSorted(hits.assigns, assign) &&
+                    collectionMatches(candidate, hits, memo))
+                {
+                    matches.push_back(assign);
+                }
+            }
+        }
+        sortUnique(matches);
+        return matches;
+    }
+
+  public:
+    vector<Node> nodes;
+    vector<CollectionData> collections;
+    std::unordered_map<const Collection*, size_t> collectionIndices;
+    vector<size_t> cyclicCollections;
+    vector<MaterialPtr> assignMaterials;
+};
+
+GeomBindingIndex::GeomBindingIndex(ConstDocumentPtr doc) :
+    _impl(new Impl)
+{
+    for (LookPtr look : doc->getLooks())
+    {
+        for (MaterialAssignPtr matAssign : look->getMaterialAssigns())
+        {
+            size_t index = _assigns.size();
+            _assigns.push_back(matAssign);
+            _impl->assignMaterials.push_back(matAssign->getReferencedMaterial());
+            _impl->addGeomString(matAssign->getActiveGeom(), { BindingEntry::ASSIGN_GEOM, index });
+            CollectionPtr collection = matAssign->getCollection();
+            if (collection)
+            {
+                size_t collectionIndex = _impl->addCollection(collection);
+                _impl->collections[collectionIndex].assigns.push_back(index);
+            }
+        }
+    }
+    _impl->finalize();
+}
+
+GeomBindingIndex::~GeomBindingIndex()
+{
+}
+
+vector<MaterialAssignPtr> GeomBindingIndex::getMaterialAssigns(const string& geom, ConstMaterialPtr material) const
+{
+    vector<MaterialAssignPtr> matAssigns;
+    for (size_t index : _impl->findAssigns(geom, material))
+    {
+        matAssigns.push_back(_assigns[index]);
+    }
+    return matAssigns;
+}
+
+vector<vector<MaterialAssignPtr>> GeomBindingIndex::getMaterialAssigns(const StringVec& geoms, ConstMaterialPtr material) const
+{
+    vector<vector<MaterialAssignPtr>> matAssigns;
+    matAssigns.reserve(geoms.size());
+    for (const string& geom : geoms)
+    {
+        matAssigns.push_back(getMaterialAssigns(geom, material));
+    }
+    return matAssigns;
+}
+
 } // namespace MaterialX
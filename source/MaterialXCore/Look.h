@@ -22,6 +22,7 @@ class Look;
 class LookInherit;
 class MaterialAssign;
 class Visibility;
+class GeomBindingIndex;
 
 /// A shared pointer to a Look
 using LookPtr = shared_ptr<Look>;
@@ -38,6 +39,9 @@ using VisibilityPtr = shared_ptr<Visibility>;
 /// A shared pointer to a const Visibility
 using ConstVisibilityPtr = shared_ptr<const Visibility>;
 
+/// A shared pointer to a const GeomBindingIndex
+using ConstGeomBindingIndexPtr = shared_ptr<const GeomBindingIndex>;
+
 /// @class Look
 /// A look element within a Document.
 class Look : public Element
@@ -439,6 +443,56 @@ class Visibility : public GeomElement
     static const string VISIBLE_ATTRIBUTE;
 };
 
+/// @class GeomBindingIndex
+/// An index of the material assignments in the looks of a document, keyed
+/// by geometry path.
+///
+/// The geometry strings of each MaterialAssign, and the include and exclude
+/// strings of the collections they reference, are stored in a trie over the
+/// components of their geometry paths, with included collections expanded.
+/// The material assignments that apply to a geometry string are then found
+/// in time proportional to the depth of its paths and the number of
+/// matching entries, rather than the number of assignments in the document.
+///
+/// An index reflects the document at the time it was built, and the index
+/// returned by Document::getGeomBindingIndex is rebuilt whenever the looks,
+/// collections or materials of the document are modified.
+class GeomBindingIndex
+{
+  public:
+    /// Build an index of the material assignments in the given document.
+    explicit GeomBindingIndex(shared_ptr<const Document> doc);
+    ~GeomBindingIndex();
+
+    /// Return the material assignments that apply to the given geometry
+    /// string, in the order of their looks in the document.  This matches
+    /// the assignments whose geometry strings match the given string, or
+    /// whose collections match the given string.
+    /// @param geom The geometry string to be resolved.
+    /// @param material An optional material, restricting the results to
+    ///    assignments that reference it.
+    /// @throws ExceptionFoundCycle if a referenced collection must be
+    ///    evaluated and its include chain contains a cycle.
+    vector<MaterialAssignPtr> getMaterialAssigns(const string& geom,
+                                                 ConstMaterialPtr material = nullptr) const;
+
+    /// Return the material assignments that apply to each of the given
+    /// geometry strings, as in getMaterialAssigns for a single string.
+    vector<vector<MaterialAssignPtr>> getMaterialAssigns(const StringVec& geoms,
+                                                         ConstMaterialPtr material = nullptr) const;
+
+    /// Return the number of material assignments in the index.
+    size_t getMaterialAssignCount() const
+    {
+        return _assigns.size();
+    }
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> _impl;
+    vector<MaterialAssignPtr> _assigns;
+};
+
 } // namespace MaterialX
 
 #endif
@@ -62,28 +62,7 @@ vector<NodeDefPtr> Material::getShaderNodeDefs(const string& target, const strin
 
 vector<MaterialAssignPtr> Material::getGeometryBindings(const string& geom) const
 {
-    vector<MaterialAssignPtr> matAssigns;
-    for (LookPtr look : getDocument()->getLooks())
-    {
-        for (MaterialAssignPtr matAssign : look->getMaterialAssigns())
-        {
-            if (matAssign->getReferencedMaterial() == getSelf())
-            {
-                if (geomStringsMatch(geom, matAssign->getActiveGeom()))
-                {
-                    matAssigns.push_back(matAssign);
-                    continue;
-                }
-                CollectionPtr coll = matAssign->getCollection();
-                if (coll && coll->matchesGeomString(geom))
-                {
-                    matAssigns.push_back(matAssign);
-                    continue;
-                }
-            }
-        }
-    }
-    return matAssigns;
+    return getDocument()->getGeomBindingIndex()->getMaterialAssigns(geom, getSelf()->asA<Material>());
 }
 
 vector<ParameterPtr> Material::getPrimaryShaderParameters(const string& target, const string& type) const
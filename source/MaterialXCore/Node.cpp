@@ -72,19 +72,16 @@ NodeDefPtr Node::getNodeDef(const string& target) const
     {
         return resolveRootNameReference<NodeDef>(getNodeDefString());
     }
-    vector<NodeDefPtr> nodeDefs = getDocument()->getMatchingNodeDefs(getQualifiedName(getCategory()));
-    vector<NodeDefPtr> secondary = getDocument()->getMatchingNodeDefs(getCategory());
-    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
-    for (NodeDefPtr nodeDef : nodeDefs)
+    return getDocument()->getNodeDefForNode(getSelf()->asA<Node>(), target);
+}
+
+ConstNodeDefPtr Node::getDeclaration(const string& target) const
+{
+    if (hasNodeDefString())
     {
-        if (targetStringsMatch(nodeDef->getTarget(), target) &&
-            nodeDef->isVersionCompatible(getSelf()) &&
-            isTypeCompatible(nodeDef))
-        {
-            return nodeDef;
-        }
+        return resolveLibraryRootNameReference<NodeDef>(getNodeDefString());
     }
-    return NodeDefPtr();
+    return getDocument()->findLibraryNodeDefForNode(getSelf()->asA<Node>(), target);
 }
 
 Edge Node::getUpstreamEdge(ConstMaterialPtr material, size_t index) const
@@ -141,6 +138,11 @@ bool Node::validate(string* message) const
 // GraphElement methods
 //
 
+vector<NodeDefPtr> GraphElement::getNodeDefsForNodes(const string& target) const
+{
+    return getDocument()->getNodeDefsForNodes(getNodes(), target);
+}
+
 void GraphElement::flattenSubgraphs(const string& target)
 {
     vector<NodePtr> processNodeVec = getNodes();
@@ -150,9 +152,11 @@ void GraphElement::flattenSubgraphs(const string& target)
         using PortElementVec = vector<PortElementPtr>;
         std::unordered_map<NodePtr, NodeGraphPtr> graphImplMap;
         std::unordered_map<NodePtr, PortElementVec> downstreamPortMap;
-        for (NodePtr cacheNode : processNodeVec)
+        vector<NodeDefPtr> nodeDefs = getDocument()->getNodeDefsForNodes(processNodeVec, target);
+        for (size_t i = 0; i < processNodeVec.size(); i++)
         {
-            InterfaceElementPtr implement = cacheNode->getImplementation(target);
+            NodePtr cacheNode = processNodeVec[i];
+            InterfaceElementPtr implement = nodeDefs[i] ? nodeDefs[i]->getImplementation(target) : nullptr;
             if (!implement || !implement->isA<NodeGraph>())
             {
                 continue;
@@ -131,11 +131,9 @@ class Node : public InterfaceElement
     /// @{
 
     /// Return the first declaration of this interface, optionally filtered
-    ///    by the given target name.
-    ConstNodeDefPtr getDeclaration(const string& target = EMPTY_STRING) const override
-    {
-        return getNodeDef(target);
-    }
+    ///    by the given target name.  Unlike getNodeDef, the NodeDefs of the
+    ///    libraries referenced by the document are taken into account.
+    ConstNodeDefPtr getDeclaration(const string& target = EMPTY_STRING) const override;
 
     /// @}
     /// @name Validation
@@ -210,6 +208,12 @@ class GraphElement : public InterfaceElement
         removeChildOfType<Node>(name);
     }
 
+    /// Return the NodeDef of each Node in the graph, optionally filtered by
+    /// the given target name, as a vector parallel to getNodes().  The
+    /// NodeDefs of all nodes are resolved in a single pass, and an entry is
+    /// empty if no matching NodeDef is found.
+    vector<NodeDefPtr> getNodeDefsForNodes(const string& target = EMPTY_STRING) const;
+
     /// @}
     /// @name Utility
     /// @{
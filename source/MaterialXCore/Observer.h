@@ -56,6 +56,9 @@ class Observer
     /// Called when content is cleared from an element.
     virtual void onClearContent(ElementPtr) { }
 
+    /// Called when a child element is moved to a new index within its parent.
+    virtual void onSetChildIndex(ElementPtr, ElementPtr) { }
+
     /// Called when data is read into the current document.
     virtual void onRead() { }
 
@@ -140,6 +143,14 @@ class ObservedDocument : public Document
     DocumentPtr copy() const override
     {
         DocumentPtr doc = createDocument<ObservedDocument>();
+        if (getArena())
+        {
+            doc->enableArenaStorage();
+        }
+        for (ConstDocumentPtr library : getReferencedLibraries())
+        {
+            doc->referenceLibrary(library);
+        }
         doc->copyContentFrom(getSelf());
         return doc;
     }
@@ -195,6 +206,7 @@ class ObservedDocument : public Document
 
     void onCopyContent(ElementPtr elem) override
     {
+        Document::onCopyContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -206,6 +218,7 @@ class ObservedDocument : public Document
 
     void onClearContent(ElementPtr elem) override
     {
+        Document::onClearContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -215,6 +228,18 @@ class ObservedDocument : public Document
         }
     }
 
+    void onSetChildIndex(ElementPtr parent, ElementPtr child) override
+    {
+        Document::onSetChildIndex(parent, child);
+        if (_callbacksEnabled)
+        {
+            for (auto& item : _observerMap)
+            {
+                item.second->onSetChildIndex(parent, child);
+            }
+        }
+    }
+
     void onRead() override
     {
         if (_callbacksEnabled)
@@ -0,0 +1,129 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXCore/Symbol.h>
+
+#include <mutex>
+#include <unordered_set>
+
+namespace MaterialX
+{
+
+namespace {
+
+class SymbolTable
+{
+  public:
+    // Return the interned copy of the given string.  Elements of an
+    // unordered_set are never relocated, so their addresses remain stable
+    // as the table grows.
+    const string* intern(const string& str)
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return &*_strings.insert(str).first;
+    }
+
+    // Return the interned copy of the given string, or nullptr if the string
+    // has not been interned.
+    const string* find(const string& str)
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _strings.find(str);
+        return it != _strings.end() ? &*it : nullptr;
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _strings.size();
+    }
+
+  private:
+    std::mutex _mutex;
+    std::unordered_set<string> _strings;
+};
+
+SymbolTable& getSymbolTable()
+{
+    // The table is intentionally leaked, so that symbols remain valid
+    // during static destruction.
+    static SymbolTable* table = new SymbolTable;
+    return *table;
+}
+
+const string* getEmptyString()
+{
+    static const string* empty = getSymbolTable().intern(string());
+    return empty;
+}
+
+// A per-thread cache of interned strings, indexed by the address of their
+// source string.  Since the contents of a source string may change, or its
+// address be reused, each hit is verified by comparing the strings.
+struct InternCacheEntry
+{
+    const string* source;
+    const string* interned;
+};
+
+const size_t INTERN_CACHE_SIZE = 64;
+
+thread_local InternCacheEntry internCache[INTERN_CACHE_SIZE];
+
+const string* findInterned(const string& str, bool insert)
+{
+    InternCacheEntry& entry = internCache[(reinterpret_cast<size_t>(&str) / sizeof(string)) % INTERN_CACHE_SIZE];
+    if (entry.source == &str && *entry.interned == str)
+    {
+        return entry.interned;
+    }
+
+    const string* interned = insert ? getSymbolTable().intern(str) : getSymbolTable().find(str);
+    if (interned)
+    {
+        entry.source = &str;
+        entry.interned = interned;
+    }
+    return interned;
+}
+
+} // anonymous namespace
+
+//
+// Symbol methods
+//
+
+Symbol::Symbol() :
+    _str(getEmptyString())
+{
+}
+
+Symbol::Symbol(const string& str) :
+    _str(str.empty() ? getEmptyString() : findInterned(str, true))
+{
+}
+
+Symbol::Symbol(const char* str) :
+    _str(*str ? getSymbolTable().intern(string(str)) : getEmptyString())
+{
+}
+
+bool Symbol::find(const string& str, Symbol& symbol)
+{
+    const string* interned = str.empty() ? getEmptyString() : findInterned(str, false);
+    if (!interned)
+    {
+        return false;
+    }
+    symbol._str = interned;
+    return true;
+}
+
+size_t Symbol::getSymbolCount()
+{
+    return getSymbolTable().size();
+}
+
+} // namespace MaterialX
@@ -0,0 +1,103 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SYMBOL_H
+#define MATERIALX_SYMBOL_H
+
+/// @file
+/// Interned string symbols
+
+#include <MaterialXCore/Library.h>
+
+namespace MaterialX
+{
+
+/// @class Symbol
+/// An interned string.  Each distinct string value is stored once in a
+/// process-wide table, so symbols may be copied, compared and hashed as
+/// cheaply as pointers.  Interning is thread-safe, and interned strings
+/// remain valid for the lifetime of the process.
+///
+/// Each thread caches the strings it has recently interned by the address
+/// of their source string, so that repeatedly interning the same string
+/// object, such as a category or attribute name constant, takes no lock.
+class Symbol
+{
+  public:
+    /// Construct the symbol for the empty string.
+    Symbol();
+
+    /// Construct the symbol for the given string, interning it if needed.
+    explicit Symbol(const string& str);
+
+    /// Construct the symbol for the given C string, interning it if needed.
+    explicit Symbol(const char* str);
+
+    /// Return true if the given symbol is identical to this one.
+    bool operator==(const Symbol& rhs) const
+    {
+        return _str == rhs._str;
+    }
+
+    /// Return true if the given symbol differs from this one.
+    bool operator!=(const Symbol& rhs) const
+    {
+        return _str != rhs._str;
+    }
+
+    /// Compare two symbols by address.  This ordering is suitable for use in
+    /// ordered containers, but is unrelated to the order of the strings.
+    bool operator<(const Symbol& rhs) const
+    {
+        return _str < rhs._str;
+    }
+
+    /// Return the interned string of this symbol.
+    const string& str() const
+    {
+        return *_str;
+    }
+
+    /// Return true if this is the symbol for the empty string.
+    bool empty() const
+    {
+        return _str->empty();
+    }
+
+    /// Return a hash value for this symbol.
+    size_t getHash() const
+    {
+        return std::hash<const string*>()(_str);
+    }
+
+    /// Find the symbol for the given string without interning it.
+    /// @return True if the string has been interned, in which case its
+    ///    symbol is returned in the second argument.
+    static bool find(const string& str, Symbol& symbol);
+
+    /// Return the number of distinct strings that have been interned.
+    static size_t getSymbolCount();
+
+  private:
+    const string* _str;
+};
+
+} // namespace MaterialX
+
+namespace std
+{
+
+/// Hash function for Symbol, allowing its use as a key in unordered containers.
+template <> struct hash<MaterialX::Symbol>
+{
+    size_t operator()(const MaterialX::Symbol& symbol) const
+    {
+        return symbol.getHash();
+    }
+};
+
+} // namespace std
+
+#endif
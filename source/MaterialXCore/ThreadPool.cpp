@@ -0,0 +1,162 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXCore/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace MaterialX
+{
+
+//
+// ThreadPool::Loop class
+//
+
+// The shared state of a parallel loop.  Each participating thread claims the
+// next unclaimed index until all have been claimed, so workers that start
+// after the loop has completed return without calling the function.
+class ThreadPool::Loop
+{
+  public:
+    Loop(size_t count, const std::function<void(size_t)>& func) :
+        _count(count),
+        _func(func),
+        _nextIndex(0),
+        _completedCount(0),
+        _errorIndex(count)
+    {
+    }
+
+    void run()
+    {
+        for (size_t i = _nextIndex++; i < _count; i = _nextIndex++)
+        {
+            try
+            {
+                _func(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(_mutex);
+                if (i < _errorIndex)
+                {
+                    _errorIndex = i;
+                    _error = std::current_exception();
+                }
+            }
+            if (++_completedCount == _count)
+            {
+                std::lock_guard<std::mutex> guard(_mutex);
+                _completed.notify_all();
+            }
+        }
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _completed.wait(lock, [this]() { return _completedCount == _count; });
+        if (_error)
+        {
+            std::rethrow_exception(_error);
+        }
+    }
+
+  private:
+    size_t _count;
+    const std::function<void(size_t)>& _func;
+    std::atomic<size_t> _nextIndex;
+    std::atomic<size_t> _completedCount;
+    std::mutex _mutex;
+    std::condition_variable _completed;
+    size_t _errorIndex;
+    std::exception_ptr _error;
+};
+
+//
+// ThreadPool methods
+//
+
+ThreadPool::ThreadPool(size_t workerCount) :
+    _stopping(false)
+{
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        _workers.emplace_back(&ThreadPool::runWorker, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _stopping = true;
+    }
+    _queueChanged.notify_all();
+    for (std::thread& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::getGlobal()
+{
+    // The pool is intentionally leaked, so that it remains valid for
+    // operations performed during static destruction.
+    static ThreadPool* pool = new ThreadPool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return *pool;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& func, size_t maxThreads)
+{
+    if (!count)
+    {
+        return;
+    }
+
+    // The function is referenced rather than copied, which is safe since a
+    // worker only calls it after claiming an index, and this call does not
+    // return until every claimed index has completed.
+    shared_ptr<Loop> loop = std::make_shared<Loop>(count, func);
+    size_t helperCount = std::min(_workers.size(), count - 1);
+    if (maxThreads)
+    {
+        helperCount = std::min(helperCount, maxThreads - 1);
+    }
+    if (helperCount)
+    {
+        {
+            std::lock_guard<std::mutex> guard(_mutex);
+            _queue.insert(_queue.end(), helperCount, loop);
+        }
+        _queueChanged.notify_all();
+    }
+
+    loop->run();
+    loop->wait();
+}
+
+void ThreadPool::runWorker()
+{
+    while (true)
+    {
+        shared_ptr<Loop> loop;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _queueChanged.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+            if (_stopping)
+            {
+                return;
+            }
+            loop = _queue.front();
+            _queue.pop_front();
+        }
+        loop->run();
+    }
+}
+
+} // namespace MaterialX
@@ -0,0 +1,74 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_THREADPOOL_H
+#define MATERIALX_THREADPOOL_H
+
+/// @file
+/// A shared pool of worker threads
+
+#include <MaterialXCore/Library.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace MaterialX
+{
+
+/// @class ThreadPool
+/// A fixed set of worker threads, which are started once and shared by the
+/// parallel operations of MaterialX, so that no operation starts threads of
+/// its own.
+///
+/// The thread calling parallelFor takes part in the loop, so a loop always
+/// completes, even when all workers are busy with other loops or when it is
+/// called from a worker thread.
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(size_t workerCount);
+    ~ThreadPool();
+
+    /// Return the process-wide pool, whose threads, including the calling
+    /// thread, match the hardware concurrency.
+    static ThreadPool& getGlobal();
+
+    /// Call the given function once for each index from zero to the given
+    /// count, and return once all calls have completed.
+    /// @param count The number of indices.
+    /// @param func The function to call with each index.
+    /// @param maxThreads The maximum number of threads, including the calling
+    ///    thread, to use for the loop.  If zero, all workers may be used.
+    /// @throws The first exception, in index order, thrown by the function.
+    void parallelFor(size_t count, const std::function<void(size_t)>& func, size_t maxThreads = 0);
+
+    /// Return the number of worker threads of the pool.
+    size_t getWorkerCount() const
+    {
+        return _workers.size();
+    }
+
+  private:
+    class Loop;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void runWorker();
+
+  private:
+    vector<std::thread> _workers;
+    std::deque<shared_ptr<Loop>> _queue;
+    std::mutex _mutex;
+    std::condition_variable _queueChanged;
+    bool _stopping;
+};
+
+} // namespace MaterialX
+
+#endif
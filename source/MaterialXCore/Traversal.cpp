@@ -85,10 +85,10 @@ TreeIterator& TreeIterator::operator++()
 
 size_t GraphIterator::getNodeDepth() const
 {
-    size_t nodeDepth = 0;
-    for (ElementPtr elem : _pathElems)
+    size_t nodeDepth = (_upstreamElem && _upstreamElem->isA<Node>()) ? 1 : 0;
+    for (const StackFrame& frame : _stack)
     {
-        if (elem->isA<Node>())
+        if (frame.first->isA<Node>())
         {
             nodeDepth++;
         }
@@ -126,7 +126,7 @@ GraphIterator& GraphIterator::operator++()
     {
         if (_upstreamElem)
         {
-            returnPathDownstream(_upstreamElem);
+            returnPathDownstream();
         }
 
         if (_stack.empty())
@@ -150,30 +150,34 @@ GraphIterator& GraphIterator::operator++()
         }
 
         // Traverse to our parent's siblings.
-        returnPathDownstream(parentFrame.first);
+        returnPathDownstream();
         _stack.pop_back();
     }
 
     return *this;
 }
 
-void GraphIterator::extendPathUpstream(ElementPtr upstreamElem, ElementPtr connectingElem)
+void GraphIterator::extendPathUpstream(const ElementPtr& upstreamElem, const ElementPtr& connectingElem)
 {
-    // Check for cycles.
-    if (_pathElems.count(upstreamElem))
+    // Check for cycles.  The elements of the current path are those of the
+    // stack, so a scan of the stack avoids maintaining a separate set of
+    // path elements for each edge.
+    const Element* elem = upstreamElem.get();
+    for (const StackFrame& frame : _stack)
     {
-        throw ExceptionFoundCycle("Encountered cycle at element: " + upstreamElem->asString());
+        if (frame.first.get() == elem)
+        {
+            throw ExceptionFoundCycle("Encountered cycle at element: " + upstreamElem->asString());
+        }
     }
 
     // Extend the current path to the new element.
-    _pathElems.insert(upstreamElem);
     _upstreamElem = upstreamElem;
     _connectingElem = connectingElem;
 }
 
-void GraphIterator::returnPathDownstream(ElementPtr upstreamElem)
+void GraphIterator::returnPathDownstream()
 {
-    _pathElems.erase(upstreamElem);
     _upstreamElem = ElementPtr();
     _connectingElem = ElementPtr();
 }
@@ -198,7 +202,7 @@ InheritanceIterator& InheritanceIterator::operator++()
     if (_elem)
     {
         ElementPtr super = _elem->getInheritsFrom();
-        if (super && super->getCategory() != _elem->getCategory())
+        if (super && super->getCategorySymbol() != _elem->getCategorySymbol())
         {
             super = nullptr;
         }
@@ -200,12 +200,10 @@ class GraphIterator
         _prune(false),
         _holdCount(0)
     {
-        _pathElems.insert(elem);
     }
     ~GraphIterator() { }
 
   private:
-    using ElementSet = std::set<ElementPtr>;
     using StackFrame = std::pair<ElementPtr, size_t>;
 
   public:
@@ -261,6 +259,32 @@ class GraphIterator
         return !_stack.empty() ? _stack.back().second : 0;
     }
 
+    /// @}
+    /// @name Raw Elements
+    /// Non-owning versions of the element accessors, which avoid reference
+    /// counting in performance-critical loops.  The returned pointers are
+    /// owned by the document being traversed.
+    /// @{
+
+    /// Return a raw pointer to the downstream element of the current edge.
+    Element* getDownstreamElementRaw() const
+    {
+        return !_stack.empty() ? _stack.back().first.get() : nullptr;
+    }
+
+    /// Return a raw pointer to the connecting element, if any, of the
+    /// current edge.
+    Element* getConnectingElementRaw() const
+    {
+        return _connectingElem.get();
+    }
+
+    /// Return a raw pointer to the upstream element of the current edge.
+    Element* getUpstreamElementRaw() const
+    {
+        return _upstreamElem.get();
+    }
+
     /// @}
     /// @name Depth
     /// @{
@@ -319,13 +343,12 @@ class GraphIterator
     /// @}
 
   private:
-    void extendPathUpstream(ElementPtr upstreamElem, ElementPtr connectingElem);
-    void returnPathDownstream(ElementPtr upstreamElem);
+    void extendPathUpstream(const ElementPtr& upstreamElem, const ElementPtr& connectingElem);
+    void returnPathDownstream();
 
   private:
     ElementPtr _upstreamElem;
     ElementPtr _connectingElem;
-    ElementSet _pathElems;
     ConstMaterialPtr _material;
     vector<StackFrame> _stack;
     bool _prune;
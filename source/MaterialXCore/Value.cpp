@@ -8,6 +8,7 @@
 #include <MaterialXCore/Util.h>
 
 #include <iomanip>
+#include <locale>
 #include <sstream>
 #include <type_traits>
 
@@ -15,8 +16,8 @@ namespace MaterialX
 {
 
 Value::CreatorMap Value::_creatorMap;
-Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
-int Value::_floatPrecision = 6;
+thread_local Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
+thread_local int Value::_floatPrecision = 6;
 
 namespace {
 
@@ -30,22 +31,102 @@ template <class T> class is_std_vector< vector<T> > : public std::true_type { };
 template <class T> using enable_if_std_vector_t =
     typename std::enable_if<is_std_vector<T>::value, T>::type;
 
-template <class T> void stringToData(const string& value, T& data)
+// Iterates over the tokens of a value string that lie between array
+// separators, without copying them.  Each token is a range within the
+// original string.
+class ValueTokenizer
 {
-    std::stringstream ss(value);
-    if (!(ss >> data))
+  public:
+    explicit ValueTokenizer(const string& str) :
+        _str(str),
+        _pos(str.find_first_not_of(ARRAY_VALID_SEPARATORS))
     {
-        throw ExceptionTypeError("Type mismatch in generic stringToData: " + value);
     }
+
+    bool next(const char*& begin, const char*& end)
+    {
+        if (_pos == string::npos)
+        {
+            return false;
+        }
+        size_t endPos = _str.find_first_of(ARRAY_VALID_SEPARATORS, _pos);
+        if (endPos == string::npos)
+        {
+            endPos = _str.size();
+        }
+        begin = _str.data() + _pos;
+        end = _str.data() + endPos;
+        _pos = _str.find_first_not_of(ARRAY_VALID_SEPARATORS, endPos);
+        return true;
+    }
+
+  private:
+    const string& _str;
+    size_t _pos;
+};
+
+// A stream for parsing values in place from a range of characters, which
+// is imbued with the classic locale, so that parsing is independent of the
+// global locale.  One stream is held per thread and reused, avoiding the
+// cost of constructing a stream and copying characters for each value.
+class ValueInputStream : private std::streambuf
+{
+  public:
+    ValueInputStream() :
+        _stream(this)
+    {
+        _stream.imbue(std::locale::classic());
+    }
+
+    // Parse a value from the start of the given range, returning true if
+    // a value was read.  Any characters following the value are ignored.
+    template <class T> bool parse(const char* begin, const char* end, T& data)
+    {
+        setg(const_cast<char*>(begin), const_cast<char*>(begin), const_cast<char*>(end));
+        _stream.clear();
+        return static_cast<bool>(_stream >> data);
+    }
+
+  private:
+    std::istream _stream;
+};
+
+// Parse a data value from the given range of a string.
+template <class T> bool parseData(const char* begin, const char* end, T& data)
+{
+    static thread_local ValueInputStream stream;
+    return stream.parse(begin, end, data);
 }
 
-template <> void stringToData(const string& str, bool& data)
+template <> bool parseData(const char* begin, const char* end, bool& data)
 {
-    if (str == VALUE_STRING_TRUE)
+    size_t length = (size_t) (end - begin);
+    if (VALUE_STRING_TRUE.compare(0, string::npos, begin, length) == 0)
         data = true;
-    else if (str == VALUE_STRING_FALSE)
+    else if (VALUE_STRING_FALSE.compare(0, string::npos, begin, length) == 0)
         data = false;
     else
+        return false;
+    return true;
+}
+
+template <> bool parseData(const char* begin, const char* end, string& data)
+{
+    data.assign(begin, end);
+    return true;
+}
+
+template <class T> void stringToData(const string& value, T& data)
+{
+    if (!parseData(value.data(), value.data() + value.size(), data))
+    {
+        throw ExceptionTypeError("Type mismatch in generic stringToData: " + value);
+    }
+}
+
+template <> void stringToData(const string& str, bool& data)
+{
+    if (!parseData(str.data(), str.data() + str.size(), data))
         throw ExceptionTypeError("Type mismatch in boolean stringToData: " + str);
 }
 
@@ -56,76 +137,130 @@ template <> void stringToData(const string& str, string& data)
 
 template <class T> void stringToData(const string& str, enable_if_mx_vector_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numElements())
+    ValueTokenizer tokenizer(str);
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    for (size_t i = 0; i < data.numElements(); i++)
     {
-        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
+        if (!tokenizer.next(begin, end))
+        {
+            throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
+        }
+        if (!parseData(begin, end, data[i]))
+        {
+            throw ExceptionTypeError("Type mismatch in generic stringToData: " + string(begin, end));
+        }
     }
-    for (size_t i = 0; i < data.numElements(); i++)
+    if (tokenizer.next(begin, end))
     {
-        stringToData(tokens[i], data[i]);
+        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
     }
 }
 
 template <class T> void stringToData(const string& str, enable_if_mx_matrix_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numRows() * data.numColumns())
-    {
-        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
-    }
+    ValueTokenizer tokenizer(str);
+    const char* begin = nullptr;
+    const char* end = nullptr;
     for (size_t i = 0; i < data.numRows(); i++)
     {
         for (size_t j = 0; j < data.numColumns(); j++)
         {
-            stringToData(tokens[i * data.numRows() + j], data[i][j]);
+            if (!tokenizer.next(begin, end))
+            {
+                throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
+            }
+            if (!parseData(begin, end, data[i][j]))
+            {
+                throw ExceptionTypeError("Type mismatch in generic stringToData: " + string(begin, end));
+            }
         }
     }
+    if (tokenizer.next(begin, end))
+    {
+        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
+    }
 }
 
 template <class T> void stringToData(const string& str, enable_if_std_vector_t<T>& data)
 {
-    for (const string& token : splitString(str, ARRAY_VALID_SEPARATORS))
+    ValueTokenizer tokenizer(str);
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    while (tokenizer.next(begin, end))
     {
         typename T::value_type val;
-        stringToData(token, val);
+        if (!parseData(begin, end, val))
+        {
+            throw ExceptionTypeError("Type mismatch in array stringToData: " + str);
+        }
         data.push_back(val);
     }
 }
 
-template <class T> void dataToString(const T& data, string& str)
+// A string stream for formatting values, which is imbued with the classic
+// locale, so that value strings are independent of the global locale.  One
+// stream is held per thread and reused, avoiding the cost of constructing a
+// stream for each value.
+class ValueOutputStream
 {
-    std::stringstream ss;
+  public:
+    ValueOutputStream()
+    {
+        _stream.imbue(std::locale::classic());
+    }
 
-    // Set float format and precision for the stream
-    const Value::FloatFormat fmt = Value::getFloatFormat();
-    ss.setf(std::ios_base::fmtflags(
-            (fmt == Value::FloatFormatFixed ? std::ios_base::fixed :
-            (fmt == Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
-        std::ios_base::floatfield);
-    ss.precision(Value::getFloatPrecision());
+    // Return the stream, cleared and set to the given float format and
+    // precision.
+    std::ostringstream& reset(Value::FloatFormat format, int precision)
+    {
+        _stream.str(EMPTY_STRING);
+        _stream.clear();
+        _stream.setf(std::ios_base::fmtflags(
+                (format == Value::FloatFormatFixed ? std::ios_base::fixed :
+                (format == Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
+            std::ios_base::floatfield);
+        _stream.precision(precision);
+        return _stream;
+    }
 
+  private:
+    std::ostringstream _stream;
+};
+
+template <class T> void dataToString(const T& data, string& str, Value::FloatFormat format, int precision)
+{
+    static thread_local ValueOutputStream stream;
+    std::ostringstream& ss = stream.reset(format, precision);
     ss << data;
-    str = ss.str();
+    str += ss.str();
+}
+
+template <> void dataToString(const int& data, string& str, Value::FloatFormat, int)
+{
+    str += std::to_string(data);
+}
+
+template <> void dataToString(const long& data, string& str, Value::FloatFormat, int)
+{
+    str += std::to_string(data);
 }
 
-template <> void dataToString(const bool& data, string& str)
+template <> void dataToString(const bool& data, string& str, Value::FloatFormat, int)
 {
-    str = data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
+    str += data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
 }
 
-template <> void dataToString(const string& data, string& str)
+template <> void dataToString(const string& data, string& str, Value::FloatFormat, int)
 {
-    str = data;
+    str += data;
 }
 
-template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, string& str)
+template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, string& str, Value::FloatFormat format, int precision)
 {
     for (size_t i = 0; i < data.numElements(); i++)
     {
-        string token;
-        dataToString(data[i], token);
-        str += token;
+        dataToString(data[i], str, format, precision);
         if (i + 1 < data.numElements())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -133,15 +268,13 @@ template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, strin
     }
 }
 
-template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, string& str)
+template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, string& str, Value::FloatFormat format, int precision)
 {
     for (size_t i = 0; i < data.numRows(); i++)
     {
         for (size_t j = 0; j < data.numColumns(); j++)
         {
-            string token;
-            dataToString(data[i][j], token);
-            str += token;
+            dataToString(data[i][j], str, format, precision);
             if (i + 1 < data.numRows() ||
                 j + 1 < data.numColumns())
             {
@@ -151,13 +284,11 @@ template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, strin
     }
 }
 
-template <class T> void dataToString(const enable_if_std_vector_t<T>& data, string& str)
+template <class T> void dataToString(const enable_if_std_vector_t<T>& data, string& str, Value::FloatFormat format, int precision)
 {
     for (size_t i = 0; i < data.size(); i++)
     {
-        string token;
-        dataToString<typename T::value_type>(data[i], token);
-        str += token;
+        dataToString<typename T::value_type>(data[i], str, format, precision);
         if (i + 1 < data.size())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -177,9 +308,14 @@ template<class T> const string& getTypeString()
 }
 
 template <class T> string toValueString(const T& data)
+{
+    return toValueString<T>(data, Value::getFloatFormat(), Value::getFloatPrecision());
+}
+
+template <class T> string toValueString(const T& data, Value::FloatFormat format, int precision)
 {
     string value;
-    dataToString<T>(data, value);
+    dataToString<T>(data, value, format, precision);
     return value;
 }
 
@@ -204,6 +340,11 @@ template <class T> string TypedValue<T>::getValueString() const
     return toValueString<T>(_data);
 }
 
+template <class T> string TypedValue<T>::getValueString(FloatFormat format, int precision) const
+{
+    return toValueString<T>(_data, format, precision);
+}
+
 template <class T> ValuePtr TypedValue<T>::createFromString(const string& value)
 {
     try
@@ -229,6 +370,12 @@ ValuePtr Value::createValueFromStrings(const string& value, const string& type)
     return TypedValue<string>::createFromString(value);
 }
 
+string Value::getValueString(FloatFormat format, int precision) const
+{
+    ScopedFloatFormatting formatting(format, precision);
+    return getValueString();
+}
+
 template<class T> bool Value::isA() const
 {
     return dynamic_cast<const TypedValue<T>*>(this) != nullptr;
@@ -289,6 +436,8 @@ template bool Value::isA<T>() const;                    \
 template const T& Value::asA<T>() const;                \
 template const string& getTypeString<T>();              \
 template string toValueString(const T& data);           \
+template string toValueString(const T& data,            \
+    Value::FloatFormat format, int precision);          \
 template T fromValueString(const string& value);        \
 ValueRegistry<T> registry##T;
 
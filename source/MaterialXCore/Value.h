@@ -72,10 +72,19 @@ class Value
     /// Return the type string for this value.
     virtual const string& getTypeString() const = 0;
 
-    /// Return the value string for this value.
+    /// Return the value string for this value, using the float formatting
+    /// of the calling thread.
     virtual string getValueString() const = 0;
 
-    /// Set float formatting for converting values to strings.
+    /// Return the value string for this value, using the given float
+    /// formatting.  Unlike the global formatting, this is safe to use with
+    /// differing formats on concurrent threads.  The default implementation
+    /// applies the given formatting to the calling thread for the duration
+    /// of a call to getValueString.
+    virtual string getValueString(FloatFormat format, int precision) const;
+
+    /// Set float formatting for converting values to strings on the
+    /// calling thread.
     /// Formats to use are FloatFormatFixed, FloatFormatScientific 
     /// or FloatFormatDefault to set default format.
     static void setFloatFormat(FloatFormat format)
@@ -83,7 +92,8 @@ class Value
         _floatFormat = format;
     }
 
-    /// Set float precision for converting values to strings.
+    /// Set float precision for converting values to strings on the calling
+    /// thread.
     static void setFloatPrecision(int precision)
     {
         _floatPrecision = precision;
@@ -122,8 +132,8 @@ class Value
 
   private:
     static CreatorMap _creatorMap;
-    static FloatFormat _floatFormat;
-    static int _floatPrecision;
+    static thread_local FloatFormat _floatFormat;
+    static thread_local int _floatPrecision;
 };
 
 /// The class template for typed subclasses of Value
@@ -170,6 +180,9 @@ template <class T> class TypedValue : public Value
     /// Return value string.
     string getValueString() const override;
 
+    /// Return value string, using the given float formatting.
+    string getValueString(FloatFormat format, int precision) const override;
+
     //
     // Static helper methods
     //
@@ -197,9 +210,14 @@ class ExceptionTypeError : public Exception
 /// Return the type string associated with the given data type.
 template<class T> const string& getTypeString();
 
-/// Convert the given data value to a value string.
+/// Convert the given data value to a value string, using the float
+/// formatting of the calling thread.
 template <class T> string toValueString(const T& data);
 
+/// Convert the given data value to a value string, using the given float
+/// format and precision.
+template <class T> string toValueString(const T& data, Value::FloatFormat format, int precision);
+
 /// Convert the given value string to a data value of the given type.
 /// @throws ExceptionTypeError if the conversion cannot be performed.
 template <class T> T fromValueString(const string& value);
@@ -0,0 +1,471 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <MaterialXFormat/File.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace MaterialX
+{
+
+const unsigned int BINARY_FORMAT_VERSION = 1;
+
+namespace {
+
+// The binary format consists of a header, followed by the string table,
+// the element records and the attribute records.  The string table holds
+// stringCount + 1 offsets into a block of string data, padded to a multiple
+// of four bytes.  Element records are stored in depth-first order, with the
+// document itself as the first record, and each element owns the next
+// attributeCount attribute records.  All values are stored in the byte order
+// of the writing platform, which is verified on read.
+
+const char BINARY_MAGIC[8] = { 'M', 'T', 'L', 'X', 'B', 'I', 'N', '\0' };
+const uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+struct BinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t stringCount;
+    uint32_t stringDataSize;
+    uint32_t elementCount;
+    uint32_t attributeCount;
+};
+
+struct ElementRecord
+{
+    uint32_t category;
+    uint32_t name;
+    uint32_t sourceUri;
+    uint32_t childCount;
+    uint32_t attributeCount;
+};
+
+struct AttributeRecord
+{
+    uint32_t name;
+    uint32_t value;
+};
+
+size_t padToWord(size_t size)
+{
+    return (size + 3) & ~size_t(3);
+}
+
+//
+// Writing
+//
+
+class BinaryWriter
+{
+  public:
+    void addElement(ConstElementPtr elem)
+    {
+        ElementRecord record;
+        record.category = addString(elem->getCategory());
+        record.name = addString(elem->getName());
+        record.sourceUri = addString(elem->getSourceUri());
+        record.childCount = (uint32_t) elem->getChildren().size();
+        record.attributeCount = (uint32_t) elem->getAttributeNames().size();
+        _elements.push_back(record);
+
+        for (const string& attrName : elem->getAttributeNames())
+        {
+            AttributeRecord attr;
+            attr.name = addString(attrName);
+            attr.value = addString(elem->getAttribute(attrName));
+            _attributes.push_back(attr);
+        }
+        for (ElementPtr child : elem->getChildren())
+        {
+            addElement(child);
+        }
+    }
+
+    void write(std::ostream& stream) const
+    {
+        vector<uint32_t> offsets;
+        offsets.reserve(_strings.size() + 1);
+        uint32_t offset = 0;
+        for (const string* str : _strings)
+        {
+            offsets.push_back(offset);
+            offset += (uint32_t) str->size();
+        }
+        offsets.push_back(offset);
+
+        BinaryHeader header;
+        memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        header.version = BINARY_FORMAT_VERSION;
+        header.byteOrder = BINARY_BYTE_ORDER;
+        header.stringCount = (uint32_t) _strings.size();
+        header.stringDataSize = offset;
+        header.elementCount = (uint32_t) _elements.size();
+        header.attributeCount = (uint32_t) _attributes.size();
+
+        stream.write((const char*) &header, sizeof(header));
+        stream.write((const char*) offsets.data(), offsets.size() * sizeof(uint32_t));
+        for (const string* str : _strings)
+        {
+            stream.write(str->data(), str->size());
+        }
+        const char padding[4] = { 0, 0, 0, 0 };
+        stream.write(padding, padToWord(offset) - offset);
+        stream.write((const char*) _elements.data(), _elements.size() * sizeof(ElementRecord));
+        stream.write((const char*) _attributes.data(), _attributes.size() * sizeof(AttributeRecord));
+    }
+
+  private:
+    uint32_t addString(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it != _stringIndices.end())
+        {
+            return it->second;
+        }
+        uint32_t index = (uint32_t) _strings.size();
+        it = _stringIndices.insert(std::make_pair(str, index)).first;
+        _strings.push_back(&it->first);
+        return index;
+    }
+
+  private:
+    std::unordered_map<string, uint32_t> _stringIndices;
+    vector<const string*> _strings;
+    vector<ElementRecord> _elements;
+    vector<AttributeRecord> _attributes;
+};
+
+//
+// Reading
+//
+
+class BinaryReader
+{
+  public:
+    BinaryReader(const char* buffer, size_t size) :
+        _elementIndex(0),
+        _attributeIndex(0)
+    {
+        if (!buffer || size < sizeof(BinaryHeader))
+        {
+            throw ExceptionParseError("Binary document is too small to contain a header");
+        }
+        BinaryHeader header;
+        memcpy(&header, buffer, sizeof(header));
+        if (memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+        {
+            throw ExceptionParseError("Invalid binary document header");
+        }
+        if (header.byteOrder != BINARY_BYTE_ORDER)
+        {
+            throw ExceptionParseError("Binary document was written with a different byte order");
+        }
+        if (header.version != BINARY_FORMAT_VERSION)
+        {
+            throw ExceptionParseError("Unsupported binary document version: " + std::to_string(header.version));
+        }
+
+        // Compute section locations, verifying that they lie within the buffer.
+        size_t offsetsStart = sizeof(BinaryHeader);
+        size_t stringDataStart = offsetsStart + ((size_t) header.stringCount + 1) * sizeof(uint32_t);
+        size_t elementsStart = stringDataStart + padToWord(header.stringDataSize);
+        size_t attributesStart = elementsStart + (size_t) header.elementCount * sizeof(ElementRecord);
+        size_t end = attributesStart + (size_t) header.attributeCount * sizeof(AttributeRecord);
+        if (end > size || header.elementCount == 0)
+        {
+            throw ExceptionParseError("Binary document is truncated");
+        }
+
+        // Build the string table.
+        const char* stringData = buffer + stringDataStart;
+        _strings.resize(header.stringCount);
+        uint32_t begin = readWord(buffer + offsetsStart);
+        for (uint32_t i = 0; i < header.stringCount; i++)
+        {
+            uint32_t next = readWord(buffer + offsetsStart + (i + 1) * sizeof(uint32_t));
+            if (begin > next || next > header.stringDataSize)
+            {
+                throw ExceptionParseError("Invalid string table in binary document");
+            }
+            _strings[i].assign(stringData + begin, next - begin);
+            begin = next;
+        }
+
+        _elements = buffer + elementsStart;
+        _attributes = buffer + attributesStart;
+        _elementCount = header.elementCount;
+        _attributeCount = header.attributeCount;
+    }
+
+    void readDocument(DocumentPtr doc)
+    {
+        ElementRecord record = nextElement();
+        if (getString(record.category) != Document::CATEGORY)
+        {
+            throw ExceptionParseError("Binary document does not begin with a document element");
+        }
+        readContent(doc, record);
+        if (_elementIndex != _elementCount || _attributeIndex != _attributeCount)
+        {
+            throw ExceptionParseError("Unexpected trailing records in binary document");
+        }
+    }
+
+  private:
+    void readContent(ElementPtr elem, const ElementRecord& record)
+    {
+        const string& sourceUri = getString(record.sourceUri);
+        if (!sourceUri.empty())
+        {
+            elem->setSourceUri(sourceUri);
+        }
+        for (uint32_t i = 0; i < record.attributeCount; i++)
+        {
+            AttributeRecord attr = nextAttribute();
+            elem->setAttribute(getString(attr.name), getString(attr.value));
+        }
+        for (uint32_t i = 0; i < record.childCount; i++)
+        {
+            ElementRecord childRecord = nextElement();
+            ElementPtr child = elem->addChildOfCategory(getString(childRecord.category),
+                                                        getString(childRecord.name));
+            readContent(child, childRecord);
+        }
+    }
+
+    ElementRecord nextElement()
+    {
+        if (_elementIndex >= _elementCount)
+        {
+            throw ExceptionParseError("Invalid element record in binary document");
+        }
+        ElementRecord record;
+        memcpy(&record, _elements + _elementIndex++ * sizeof(ElementRecord), sizeof(record));
+        return record;
+    }
+
+    AttributeRecord nextAttribute()
+    {
+        if (_attributeIndex >= _attributeCount)
+        {
+            throw ExceptionParseError("Invalid attribute record in binary document");
+        }
+        AttributeRecord record;
+        memcpy(&record, _attributes + _attributeIndex++ * sizeof(AttributeRecord), sizeof(record));
+        return record;
+    }
+
+    const string& getString(uint32_t index) const
+    {
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Invalid string index in binary document");
+        }
+        return _strings[index];
+    }
+
+    static uint32_t readWord(const char* data)
+    {
+        uint32_t word;
+        memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+  private:
+    vector<string> _strings;
+    const char* _elements;
+    const char* _attributes;
+    size_t _elementCount;
+    size_t _attributeCount;
+    size_t _elementIndex;
+    size_t _attributeIndex;
+};
+
+// A read-only memory mapping of a file.
+class MappedFile
+{
+  public:
+    explicit MappedFile(const string& filename) :
+        _data(nullptr),
+        _size(0)
+    {
+#if defined(_WIN32)
+        _file = CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        _mapping = NULL;
+        if (_file == INVALID_HANDLE_VALUE)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename);
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(_file, &size) && size.QuadPart > 0)
+        {
+            _size = (size_t) size.QuadPart;
+            _mapping = CreateFileMapping(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (_mapping)
+            {
+                _data = (const char*) MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+            }
+        }
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename);
+        }
+        struct stat sb;
+        if (fstat(fd, &sb) == 0 && sb.st_size > 0)
+        {
+            _size = (size_t) sb.st_size;
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = (const char*) data;
+            }
+        }
+        close(fd);
+#endif
+        if (!_data)
+        {
+            release();
+            throw ExceptionParseError("Failed to map binary document: " + filename);
+        }
+    }
+
+    ~MappedFile()
+    {
+        release();
+    }
+
+    const char* data() const
+    {
+        return _data;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+  private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void release()
+    {
+#if defined(_WIN32)
+        if (_data)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping)
+        {
+            CloseHandle(_mapping);
+        }
+        CloseHandle(_file);
+#else
+        if (_data)
+        {
+            munmap((void*) _data, _size);
+        }
+#endif
+        _data = nullptr;
+    }
+
+  private:
+    const char* _data;
+    size_t _size;
+#if defined(_WIN32)
+    HANDLE _file;
+    HANDLE _mapping;
+#endif
+};
+
+} // anonymous namespace
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size)
+{
+    BinaryReader reader(buffer, size);
+
+    ScopedUpdate update(doc);
+    doc->onRead();
+    reader.readDocument(doc);
+    doc->upgradeVersion();
+}
+
+void readFromBinaryFile(DocumentPtr doc, const string& filename, const string& searchPath)
+{
+    FileSearchPath fileSearchPath = FileSearchPath(searchPath);
+    fileSearchPath.append(getEnvironmentPath());
+
+    MappedFile file(fileSearchPath.find(filename));
+    readFromBinaryBuffer(doc, file.data(), file.size());
+    doc->setSourceUri(filename);
+}
+
+void readFromBinaryString(DocumentPtr doc, const string& str)
+{
+    readFromBinaryBuffer(doc, str.data(), str.size());
+}
+
+//
+// Writing
+//
+
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream)
+{
+    ScopedUpdate update(doc);
+    doc->onWrite();
+
+    BinaryWriter writer;
+    writer.addElement(doc);
+    writer.write(stream);
+}
+
+void writeToBinaryFile(DocumentPtr doc, const string& filename)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs.is_open())
+    {
+        throw ExceptionFileMissing("Failed to open file for writing: " + filename);
+    }
+    writeToBinaryStream(doc, ofs);
+    ofs.flush();
+    if (!ofs.good())
+    {
+        throw ExceptionFileMissing("Failed to write file: " + filename);
+    }
+}
+
+string writeToBinaryString(DocumentPtr doc)
+{
+    std::ostringstream stream;
+    writeToBinaryStream(doc, stream);
+    return stream.str();
+}
+
+} // namespace MaterialX
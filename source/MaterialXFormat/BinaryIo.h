@@ -0,0 +1,85 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for a binary serialization of MaterialX documents
+///
+/// The binary format stores a complete document as a table of unique strings,
+/// followed by element records in depth-first order and attribute records
+/// that reference strings by index.  Binary files are memory-mapped when read,
+/// and are intended as a fast-loading cache of documents that are authored
+/// as MTLX files, rather than as an interchange format.
+
+#include <MaterialXCore/Library.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/XmlIo.h>
+
+namespace MaterialX
+{
+
+/// The current version of the binary document format.
+extern const unsigned int BINARY_FORMAT_VERSION;
+
+/// @name Read Functions
+/// @{
+
+/// Read a Document in binary format from the given buffer.
+/// @param doc The Document into which data is read.
+/// @param buffer The buffer from which data is read.
+/// @param size The size of the buffer in bytes.
+/// @throws ExceptionParseError if the document cannot be parsed.
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size);
+
+/// Read a Document in binary format from the given filename.  The file is
+/// memory-mapped for the duration of the read.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.
+/// @param searchPath A semicolon-separated sequence of file paths, which will
+///    be applied in order when searching for the given file.  Defaults to the
+///    empty string.
+/// @throws ExceptionParseError if the document cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+void readFromBinaryFile(DocumentPtr doc,
+                        const string& filename,
+                        const string& searchPath = EMPTY_STRING);
+
+/// Read a Document in binary format from the given string.
+/// @param doc The Document into which data is read.
+/// @param str The string from which data is read.
+/// @throws ExceptionParseError if the document cannot be parsed.
+void readFromBinaryString(DocumentPtr doc, const string& str);
+
+/// @}
+/// @name Write Functions
+/// @{
+
+/// Write a Document in binary format to the given output stream.  All
+/// elements of the document are written, including those with source file
+/// markings, and their source URIs are preserved.
+/// @param doc The Document to be written.
+/// @param stream The output stream to which data is written.
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream);
+
+/// Write a Document in binary format to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.
+/// @throws ExceptionFileMissing if the file cannot be opened or written.
+void writeToBinaryFile(DocumentPtr doc, const string& filename);
+
+/// Write a Document in binary format to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @return The output string, returned by value
+string writeToBinaryString(DocumentPtr doc);
+
+/// @}
+
+} // namespace MaterialX
+
+#endif
@@ -15,10 +15,13 @@
 #include <sys/stat.h>
 #endif
 
+#include <atomic>
 #include <cctype>
 #include <cerrno>
 #include <climits>
 #include <cstring>
+#include <mutex>
+#include <unordered_map>
 
 namespace MaterialX
 {
@@ -36,6 +39,13 @@ const string PATH_LIST_SEPARATOR = ":";
 #endif
 const string MATERIALX_SEARCH_PATH_ENV_VAR = "MATERIALX_SEARCH_PATH";
 
+namespace {
+
+// The number of file system probes made by FileSearchPath::find.
+std::atomic<size_t> fileProbeCount(0);
+
+} // anonymous namespace
+
 //
 // FilePath methods
 //
@@ -138,6 +148,32 @@ bool FilePath::exists() const
 #endif
 }
 
+long long FilePath::getModificationTime() const
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesEx(asString().c_str(), GetFileExInfoStandard, &data))
+    {
+        return 0;
+    }
+    ULARGE_INTEGER time;
+    time.LowPart = data.ftLastWriteTime.dwLowDateTime;
+    time.HighPart = data.ftLastWriteTime.dwHighDateTime;
+    return (long long) time.QuadPart;
+#else
+    struct stat sb;
+    if (stat(asString().c_str(), &sb) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return (long long) sb.st_mtimespec.tv_sec * 1000000000LL + sb.st_mtimespec.tv_nsec;
+#else
+    return (long long) sb.st_mtim.tv_sec * 1000000000LL + sb.st_mtim.tv_nsec;
+#endif
+#endif
+}
+
 FilePath FilePath::getCurrentPath()
 {
 #if defined(_WIN32)
@@ -157,6 +193,94 @@ FilePath FilePath::getCurrentPath()
 #endif
 }
 
+//
+// FileSearchPath methods
+//
+
+class FileSearchPath::Cache
+{
+  public:
+    std::mutex mutex;
+    std::unordered_map<string, FilePath> resolvedPaths;
+};
+
+FilePath FileSearchPath::find(const FilePath& filename) const
+{
+    if (_paths.empty() || filename.isAbsolute())
+    {
+        return filename;
+    }
+
+    string key;
+    if (_cache)
+    {
+        key = filename.asString();
+        std::lock_guard<std::mutex> guard(_cache->mutex);
+        auto it = _cache->resolvedPaths.find(key);
+        if (it != _cache->resolvedPaths.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Filenames that are not found are cached as well, resolving to the
+    // original filename.
+    FilePath resolved = filename;
+    for (const FilePath& path : _paths)
+    {
+        FilePath combined = path / filename;
+        fileProbeCount++;
+        if (combined.exists())
+        {
+            resolved = combined;
+            break;
+        }
+    }
+
+    if (_cache)
+    {
+        std::lock_guard<std::mutex> guard(_cache->mutex);
+        _cache->resolvedPaths[key] = resolved;
+    }
+    return resolved;
+}
+
+void FileSearchPath::setCacheEnabled(bool enabled)
+{
+    if (enabled && !_cache)
+    {
+        _cache = std::make_shared<Cache>();
+    }
+    else if (!enabled)
+    {
+        _cache.reset();
+    }
+}
+
+void FileSearchPath::clearCache()
+{
+    if (_cache)
+    {
+        std::lock_guard<std::mutex> guard(_cache->mutex);
+        _cache->resolvedPaths.clear();
+    }
+}
+
+size_t FileSearchPath::getProbeCount()
+{
+    return fileProbeCount;
+}
+
+void FileSearchPath::detachCache()
+{
+    // Results cached for the previous sequence of paths may no longer be
+    // valid, so a modified search path starts a new cache of its own.
+    if (_cache)
+    {
+        _cache = std::make_shared<Cache>();
+    }
+}
+
 FileSearchPath getEnvironmentPath(const string& sep)
 {
     string searchPathEnv = getEnviron(MATERIALX_SEARCH_PATH_ENV_VAR);
@@ -117,6 +117,11 @@ class FilePath
     /// Return true if the given path exists on the file system.
     bool exists() const;
 
+    /// Return the last modification time of the given path as an opaque
+    /// timestamp, suitable for detecting changes to a file, or zero if the
+    /// path does not exist.
+    long long getModificationTime() const;
+
     /// @}
 
     /// Return the current working directory of the file system.
@@ -131,6 +136,12 @@ class FilePath
 /// @class FileSearchPath
 /// A sequence of file paths, which may be queried to find the first instance
 /// of a given filename on the file system.
+///
+/// A search path may optionally cache the results of its queries, including
+/// filenames that were not found, so that repeated queries for the same
+/// filename don't probe the file system again.  Copies of a search path share
+/// its cache until either copy is modified, and the cache must be cleared
+/// explicitly when files are added to or removed from the file system.
 class FileSearchPath
 {
   public:
@@ -171,12 +182,14 @@ class FileSearchPath
     /// Append the given path to the sequence.
     void append(const FilePath& path)
     {
+        detachCache();
         _paths.push_back(path);
     }
 
     /// Append the given search path to the sequence.
     void append(const FileSearchPath& searchPath)
     {
+        detachCache();
         for (const FilePath& path : searchPath.paths())
         {
             _paths.push_back(path);
@@ -192,6 +205,7 @@ class FileSearchPath
     /// Prepend the given path to the sequence.
     void prepend(const FilePath& path)
     {
+        detachCache();
         _paths.insert(_paths.begin(), path);
     }
     
@@ -204,6 +218,7 @@ class FileSearchPath
     /// Return the path at the given index.
     FilePath& operator[](size_t index)
     {
+        detachCache();
         return _paths[index];
     }
     
@@ -217,28 +232,38 @@ class FileSearchPath
     /// returning the first combined path found on the file system.
     /// On success, the combined path is returned; otherwise the original
     /// filename is returned unmodified.
-    FilePath find(const FilePath& filename) const
+    FilePath find(const FilePath& filename) const;
+
+    /// @name Resolution Cache
+    /// @{
+
+    /// Set whether the results of find are cached.  Defaults to false.
+    void setCacheEnabled(bool enabled);
+
+    /// Return true if the results of find are cached.
+    bool getCacheEnabled() const
     {
-        if (_paths.empty()) 
-        {
-            return filename;
-        }
-        if (!filename.isAbsolute())
-        {
-            for (const FilePath& path : _paths)
-            {
-                FilePath combined = path / filename;
-                if (combined.exists())
-                {
-                    return combined;
-                }
-            }
-        }
-        return filename;
+        return _cache != nullptr;
     }
 
+    /// Clear all cached results, including those of copies that share the
+    /// cache of this search path.
+    void clearCache();
+
+    /// Return the number of file system probes that have been made by the
+    /// find method of all search paths since the process started.
+    static size_t getProbeCount();
+
+    /// @}
+
+  private:
+    class Cache;
+
+    void detachCache();
+
   private:
     vector<FilePath> _paths;
+    shared_ptr<Cache> _cache;
 };
 
 /// Return a FileSearchPath object from search path environment variable.
@@ -0,0 +1,115 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXFormat/Util.h>
+
+#include <MaterialXFormat/XmlIo.h>
+
+#include <MaterialXCore/ThreadPool.h>
+
+#include <mutex>
+
+namespace MaterialX
+{
+
+namespace {
+
+// A process-wide cache of parsed library documents, keyed by file path.
+class LibraryCache
+{
+  public:
+    // Return the cached document for the given file, or nullptr if the file
+    // has not been read, or has been modified since it was read.
+    ConstDocumentPtr get(const string& filename, long long modificationTime)
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _entries.find(filename);
+        if (it != _entries.end() && it->second.modificationTime == modificationTime)
+        {
+            return it->second.doc;
+        }
+        return nullptr;
+    }
+
+    void set(const string& filename, long long modificationTime, ConstDocumentPtr doc)
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _entries[filename] = { modificationTime, doc };
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _entries.clear();
+    }
+
+  private:
+    struct Entry
+    {
+        long long modificationTime;
+        ConstDocumentPtr doc;
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<string, Entry> _entries;
+};
+
+LibraryCache& getLibraryCache()
+{
+    static LibraryCache cache;
+    return cache;
+}
+
+} // anonymous namespace
+
+//
+// Library functions
+//
+
+ConstDocumentPtr readLibraryFile(const FilePath& file)
+{
+    string filename = file.asString();
+    long long modificationTime = file.getModificationTime();
+    LibraryCache& cache = getLibraryCache();
+
+    ConstDocumentPtr cachedDoc = cache.get(filename, modificationTime);
+    if (cachedDoc)
+    {
+        return cachedDoc;
+    }
+
+    DocumentPtr doc = createDocument();
+    readFromXmlFile(doc, filename);
+    doc->setSourceUri(filename);
+    cache.set(filename, modificationTime, doc);
+    return doc;
+}
+
+vector<ConstDocumentPtr> readLibraryFiles(const vector<FilePath>& files)
+{
+    // Read the files on the shared thread pool.  The first error in file
+    // order is reported, for consistency with serial reads.
+    vector<ConstDocumentPtr> docs(files.size());
+    ThreadPool::getGlobal().parallelFor(files.size(), [&](size_t i)
+    {
+        docs[i] = readLibraryFile(files[i]);
+    });
+    return docs;
+}
+
+void loadLibraries(const vector<FilePath>& files, DocumentPtr doc, const CopyOptions* copyOptions)
+{
+    for (ConstDocumentPtr libDoc : readLibraryFiles(files))
+    {
+        doc->importLibrary(libDoc, copyOptions);
+    }
+}
+
+void clearLibraryCache()
+{
+    getLibraryCache().clear();
+}
+
+} // namespace MaterialX
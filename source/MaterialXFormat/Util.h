@@ -0,0 +1,62 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_FORMAT_UTIL_H
+#define MATERIALX_FORMAT_UTIL_H
+
+/// @file
+/// Utilities for loading MaterialX data libraries
+
+#include <MaterialXCore/Library.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/File.h>
+
+namespace MaterialX
+{
+
+/// @name Library Functions
+/// @{
+
+/// Read the given library file, returning a parsed document that is shared
+/// between all callers.  Parsed libraries are cached for the lifetime of the
+/// process, keyed by file path and modification time, so that a library is
+/// only parsed again when its file has changed.  The returned document must
+/// not be modified.
+/// @param file The library file to be read.
+/// @throws ExceptionParseError if the document cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+ConstDocumentPtr readLibraryFile(const FilePath& file);
+
+/// Read the given library files concurrently on the shared thread pool,
+/// returning their parsed documents in the order of the given files.  Each
+/// file is read through the library cache, as in readLibraryFile.
+/// @param files The library files to be read.
+/// @throws ExceptionParseError if a document cannot be parsed.
+/// @throws ExceptionFileMissing if a file cannot be opened.
+vector<ConstDocumentPtr> readLibraryFiles(const vector<FilePath>& files);
+
+/// Import the given library files into a document.  The files are read
+/// concurrently through the library cache, and are then imported into the
+/// document in the order given.
+/// @param files The library files to be imported.
+/// @param doc The Document into which the libraries are imported.
+/// @param copyOptions An optional pointer to a CopyOptions object, which is
+///    passed to Document::importLibrary.  Defaults to a null pointer.
+/// @throws ExceptionParseError if a document cannot be parsed.
+/// @throws ExceptionFileMissing if a file cannot be opened.
+void loadLibraries(const vector<FilePath>& files,
+                   DocumentPtr doc,
+                   const CopyOptions* copyOptions = nullptr);
+
+/// Clear all parsed documents from the library cache.
+void clearLibraryCache();
+
+/// @}
+
+} // namespace MaterialX
+
+#endif
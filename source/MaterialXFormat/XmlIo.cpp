@@ -9,9 +9,13 @@
 
 #include <MaterialXFormat/PugiXML/pugixml.hpp>
 
+#include <MaterialXCore/ThreadPool.h>
 #include <MaterialXCore/Types.h>
 #include <MaterialXCore/Util.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <string.h>
@@ -46,7 +50,7 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
     // Create child elements and recurse.
     for (const xml_node& xmlChild : xmlNode.children())
     {
-        string category = xmlChild.name();
+        Symbol category(xmlChild.name());
         string name;
         for (const xml_attribute& xmlAttr : xmlChild.attributes())
         {
@@ -141,34 +145,812 @@ void xmlDocumentFromFile(xml_document& xmlDoc, string filename, const string& se
     }
 }
 
-void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const string& searchPath, const XmlReadOptions* readOptions)
+const size_t STREAM_BUFFER_SIZE = 1 << 16;
+
+// Append the UTF-8 encoding of the given code point to a string.
+void appendUtf8(string& str, unsigned long code)
 {
-    XmlReadFunction readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
-    xml_node xmlChild = xmlNode.first_child();
-    while (xmlChild)
+    if (code < 0x80)
     {
-        if (xmlChild.name() == XINCLUDE_TAG)
+        str += (char) code;
+    }
+    else if (code < 0x800)
+    {
+        str += (char) (0xC0 | (code >> 6));
+        str += (char) (0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        str += (char) (0xE0 | (code >> 12));
+        str += (char) (0x80 | ((code >> 6) & 0x3F));
+        str += (char) (0x80 | (code & 0x3F));
+    }
+    else
+    {
+        str += (char) (0xF0 | (code >> 18));
+        str += (char) (0x80 | ((code >> 12) & 0x3F));
+        str += (char) (0x80 | ((code >> 6) & 0x3F));
+        str += (char) (0x80 | (code & 0x3F));
+    }
+}
+
+bool isXmlSpace(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Return true if the given character may begin a name, using the character
+// classes of pugixml, which accept any byte of a multi-byte UTF-8 sequence.
+bool isNameStartChar(int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' || c >= 0x80;
+}
+
+bool isNameChar(int c)
+{
+    return isNameStartChar(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+// Return true if the given encoding declaration is compatible with UTF-8.
+bool isUtf8Encoding(string encoding)
+{
+    std::transform(encoding.begin(), encoding.end(), encoding.begin(), ::tolower);
+    return encoding == "utf-8" || encoding == "utf8" || encoding == "us-ascii" || encoding == "ascii";
+}
+
+// The XInclude reference whose read is being performed by the current thread.
+thread_local const std::pair<string, string>* currentInclude = nullptr;
+
+} // anonymous namespace
+
+// Reads the XInclude references of a document through the XIncludeCache of
+// the given read options, and imports the included documents into the
+// document in the order of their references.
+class XIncludeReader
+{
+  public:
+    XIncludeReader(const string& searchPath, const XmlReadOptions* readOptions) :
+        _searchPath(searchPath),
+        _readOptions(readOptions)
+    {
+    }
+
+    // Add the given XInclude reference to those to be read.
+    void request(const string& filename)
+    {
+        // Read XInclude references if requested.
+        XmlReadFunction readXIncludeFunction = _readOptions ? _readOptions->readXIncludeFunction : readFromXmlFile;
+        if (!readXIncludeFunction)
+        {
+            return;
+        }
+
+        // Check for XInclude cycles.
+        if (_readOptions && _readOptions->parentFilenames.count(filename))
+        {
+            throw ExceptionParseError("XInclude cycle detected.");
+        }
+
+        _filenames.push_back(filename);
+    }
+
+    // Read the included documents, and then import them into the given
+    // document once all of them have been read successfully.
+    void import(DocumentPtr doc)
+    {
+        if (_filenames.empty())
+        {
+            return;
+        }
+
+        XIncludeCachePtr cache = (_readOptions && _readOptions->xincludeCache) ? _readOptions->xincludeCache : std::make_shared<XIncludeCache>();
+        XIncludeCache::IncludeKey includer = currentInclude ? *currentInclude : XIncludeCache::IncludeKey();
+        vector<ConstDocumentPtr> libraries(_filenames.size());
+        auto readInclude = [this, &cache, &includer, &libraries](size_t i)
+        {
+            XmlReadOptions xiReadOptions = _readOptions ? *_readOptions : XmlReadOptions();
+            xiReadOptions.parentFilenames.insert(_filenames[i]);
+            xiReadOptions.xincludeCache = cache;
+            libraries[i] = cache->getDocument(_filenames[i], _searchPath, xiReadOptions, includer);
+        };
+
+        // Files are read in parallel on the shared thread pool only by the
+        // built-in readers, as a custom read function need not be safe to call
+        // from multiple threads, and a single file is read on this thread.
+        if (isBuiltInReader(_readOptions ? _readOptions->readXIncludeFunction : readFromXmlFile))
+        {
+            ThreadPool::getGlobal().parallelFor(_filenames.size(), readInclude);
+        }
+        else
+        {
+            for (size_t i = 0; i < _filenames.size(); i++)
+            {
+                readInclude(i);
+            }
+        }
+
+        for (ConstDocumentPtr library : libraries)
         {
-            // Read XInclude references if requested.
-            if (readXIncludeFunction)
+            doc->importLibrary(library, _readOptions);
+        }
+    }
+
+  private:
+    static bool isBuiltInReader(const XmlReadFunction& readFunction)
+    {
+        using ReadFileFunction = decltype(&readFromXmlFile);
+        const ReadFileFunction* target = readFunction.target<ReadFileFunction>();
+        return target && (*target == &readFromXmlFile || *target == &readFromXmlFileIncremental);
+    }
+
+  private:
+    string _searchPath;
+    const XmlReadOptions* _readOptions;
+    StringVec _filenames;
+};
+
+// An incremental XML reader, which creates elements as their start tags are
+// parsed, without holding the XML text or an XML DOM in memory.  Input is
+// consumed from a stream in fixed-size blocks, and elements are created in a
+// scratch document, whose elements are moved into the target document only
+// once the parse has succeeded, so that they are never copied.
+//
+// As in the default reader, processing instructions, comments and document
+// type declarations are skipped, CDATA sections and character data that is
+// not whitespace are read as anonymous elements, and attribute values are
+// normalized as in pugixml's default parse mode.  Only UTF-8 input is
+// supported.
+class XmlStreamReader
+{
+  public:
+    XmlStreamReader(DocumentPtr target, const string& source, const string& searchPath, const XmlReadOptions* readOptions) :
+        _target(target),
+        _doc(createDocument()),
+        _source(source),
+        _readOptions(readOptions),
+        _includes(searchPath, readOptions),
+        _stream(nullptr),
+        _bufferStart(nullptr),
+        _pos(nullptr),
+        _end(nullptr),
+        _consumed(0),
+        _attributeCount(0),
+        _depth(0),
+        _rootFound(false)
+    {
+        // The scratch document holds only the attributes that are read, and
+        // allocates its elements from the arena of the target document.
+        _doc->removeAttribute(Element::VERSION_ATTRIBUTE);
+        if (_target->getArena())
+        {
+            _doc->enableArenaStorage(_target->getArena());
+        }
+    }
+
+    void read(std::istream& stream)
+    {
+        _stream = &stream;
+        _buffer.resize(STREAM_BUFFER_SIZE);
+        _bufferStart = _pos = _end = _buffer.data();
+        parse();
+    }
+
+    // Merge the document that was read into the target document, importing
+    // included documents ahead of its own elements as the default reader does.
+    void merge()
+    {
+        ScopedUpdate update(_target);
+        _target->onRead();
+
+        _includes.import(_target);
+
+        for (const string& attrName : _doc->getAttributeNames())
+        {
+            _target->setAttribute(attrName, _doc->getAttribute(attrName));
+        }
+        if (_doc->hasSourceUri())
+        {
+            _target->setSourceUri(_doc->getSourceUri());
+        }
+
+        bool skipDuplicateElements = _readOptions && _readOptions->skipDuplicateElements;
+        vector<ElementPtr> children = _doc->getChildren();
+        for (ElementPtr child : children)
+        {
+            // If requested, skip elements with duplicate names.
+            if (skipDuplicateElements && _target->getChild(child->getName()))
+            {
+                continue;
+            }
+            _target->moveChild(child);
+        }
+        _doc = nullptr;
+
+        _target->upgradeVersion();
+    }
+
+  private:
+    void parse()
+    {
+        // Skip a UTF-8 byte order mark, and reject other encodings.
+        int c = peek();
+        if (c == 0xEF)
+        {
+            get();
+            expect((char) 0xBB);
+            expect((char) 0xBF);
+        }
+        else if (c == 0xFE || c == 0xFF || c == 0)
+        {
+            throw parseError("Unsupported encoding");
+        }
+
+        while (skipCharacterData())
+        {
+            get();
+            c = peek();
+            if (c == '?')
+            {
+                get();
+                readProcessingInstruction();
+            }
+            else if (c == '!')
+            {
+                get();
+                c = peek();
+                if (c == '-')
+                {
+                    expect('-');
+                    expect('-');
+                    skipPast("-->");
+                }
+                else if (c == '[')
+                {
+                    for (char ch : string("[CDATA["))
+                    {
+                        expect(ch);
+                    }
+                    skipPast("]]>");
+                    addCharacterData();
+                }
+                else
+                {
+                    skipDeclaration();
+                }
+            }
+            else if (c == '/')
+            {
+                get();
+                readEndTag();
+            }
+            else
+            {
+                readStartTag();
+            }
+        }
+
+        if (_depth)
+        {
+            throw parseError("Start-end tags mismatch");
+        }
+        if (!_rootFound)
+        {
+            throw parseError("No document element found");
+        }
+    }
+
+    //
+    // Character input
+    //
+
+    bool refill()
+    {
+        _consumed += _end - _bufferStart;
+        _stream->read(_buffer.data(), _buffer.size());
+        size_t count = (size_t) _stream->gcount();
+        _bufferStart = _pos = _buffer.data();
+        _end = _bufferStart + count;
+        return count > 0;
+    }
+
+    int peek()
+    {
+        if (_pos == _end && !refill())
+        {
+            return -1;
+        }
+        return (unsigned char) *_pos;
+    }
+
+    int get()
+    {
+        int c = peek();
+        if (c >= 0)
+        {
+            _pos++;
+        }
+        return c;
+    }
+
+    void expect(char expected)
+    {
+        if (get() != (unsigned char) expected)
+        {
+            throw parseError("Unexpected character");
+        }
+    }
+
+    void skipSpace()
+    {
+        while (isXmlSpace(peek()))
+        {
+            _pos++;
+        }
+    }
+
+    // Skip character data up to the next markup, returning false if the end
+    // of the input is reached.  Character data that is not whitespace is
+    // read as an anonymous element.
+    bool skipCharacterData()
+    {
+        bool foundText = false;
+        while (true)
+        {
+            const char* markup = (const char*) memchr(_pos, '<', _end - _pos);
+            const char* textEnd = markup ? markup : _end;
+            for (const char* c = _pos; !foundText && c < textEnd; c++)
+            {
+                foundText = !isXmlSpace(*c);
+            }
+            _pos = textEnd;
+            if (markup || !refill())
+            {
+                if (foundText)
+                {
+                    addCharacterData();
+                }
+                return markup != nullptr;
+            }
+        }
+    }
+
+    // Append characters to a string until the given predicate is satisfied
+    // or the end of the input is reached.
+    template <class Predicate> void appendUntil(string& str, Predicate isEnd)
+    {
+        while (true)
+        {
+            const char* start = _pos;
+            while (_pos < _end && !isEnd(*_pos))
+            {
+                _pos++;
+            }
+            str.append(start, _pos);
+            if (_pos < _end || !refill())
+            {
+                return;
+            }
+        }
+    }
+
+    void skipPast(const string& terminator)
+    {
+        size_t matched = 0;
+        while (matched < terminator.size())
+        {
+            int c = get();
+            if (c < 0)
+            {
+                throw parseError("Unterminated markup");
+            }
+            // Each terminator is a repeated character followed by '>', so a
+            // further repetition leaves a partial match unchanged.
+            if (c == (unsigned char) terminator[matched])
+            {
+                matched++;
+            }
+            else if (c != (unsigned char) terminator[0])
+            {
+                matched = 0;
+            }
+        }
+    }
+
+    void skipDeclaration()
+    {
+        int bracketDepth = 0;
+        char quote = 0;
+        while (true)
+        {
+            int c = get();
+            if (c < 0)
+            {
+                throw parseError("Unterminated declaration");
+            }
+            if (quote)
+            {
+                quote = (c == quote) ? 0 : quote;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote = (char) c;
+            }
+            else if (c == '[')
+            {
+                bracketDepth++;
+            }
+            else if (c == ']')
+            {
+                bracketDepth--;
+            }
+            else if (c == '>' && bracketDepth <= 0)
+            {
+                return;
+            }
+        }
+    }
+
+    // Skip a processing instruction, checking the encoding of an XML
+    // declaration.
+    void readProcessingInstruction()
+    {
+        readName(_endTag);
+        if (_endTag != "xml")
+        {
+            skipPast("?>");
+            return;
+        }
+        while (true)
+        {
+            skipSpace();
+            if (peek() == '?')
+            {
+                get();
+                expect('>');
+                return;
+            }
+            std::pair<string, string>& attr = addAttribute();
+            _attributeCount = 0;
+            if (attr.first == "encoding" && !isUtf8Encoding(attr.second))
             {
-                string filename = xmlChild.attribute("href").value();
+                throw parseError("Unsupported encoding " + attr.second);
+            }
+        }
+    }
 
-                // Check for XInclude cycles.
-                if (readOptions && readOptions->parentFilenames.count(filename))
+    //
+    // Tags and attributes
+    //
+
+    void readName(string& name)
+    {
+        name.clear();
+        if (!isNameStartChar(peek()))
+        {
+            throw parseError("Invalid name");
+        }
+        appendUntil(name, [](char c) { return !isNameChar((unsigned char) c); });
+    }
+
+    void readAttributeValue(string& value)
+    {
+        int quote = get();
+        if (quote != '"' && quote != '\'')
+        {
+            throw parseError("Attribute value must be quoted");
+        }
+        value.clear();
+        while (true)
+        {
+            appendUntil(value, [quote](char c)
+            {
+                return c == quote || c == '&' || c == '\r' || c == '\n' || c == '\t';
+            });
+            int c = get();
+            if (c == quote)
+            {
+                return;
+            }
+            else if (c == '&')
+            {
+                readEntity(value);
+            }
+            else if (c == '\r' || c == '\n' || c == '\t')
+            {
+                if (c == '\r' && peek() == '\n')
                 {
-                    throw ExceptionParseError("XInclude cycle detected.");
+                    get();
                 }
+                value += ' ';
+            }
+            else
+            {
+                throw parseError("Unterminated attribute value");
+            }
+        }
+    }
+
+    // Decode an entity reference following an ampersand.  Unrecognized
+    // references are preserved as literal text.
+    void readEntity(string& value)
+    {
+        const size_t MAX_ENTITY_LENGTH = 10;
+        string& entity = _entity;
+        entity.clear();
+        int c = peek();
+        while (c >= 0 && c != ';' && entity.size() < MAX_ENTITY_LENGTH && !isXmlSpace(c) && c != '&' && c != '"' && c != '\'')
+        {
+            entity += (char) get();
+            c = peek();
+        }
+        if (c != ';')
+        {
+            value += '&';
+            value += entity;
+            return;
+        }
+        get();
+
+        if (entity == "lt")
+        {
+            value += '<';
+        }
+        else if (entity == "gt")
+        {
+            value += '>';
+        }
+        else if (entity == "amp")
+        {
+            value += '&';
+        }
+        else if (entity == "quot")
+        {
+            value += '"';
+        }
+        else if (entity == "apos")
+        {
+            value += '\'';
+        }
+        else if (entity.size() > 1 && entity[0] == '#')
+        {
+            bool hex = entity[1] == 'x';
+            char* numberEnd = nullptr;
+            const char* number = entity.c_str() + (hex ? 2 : 1);
+            unsigned long code = strtoul(number, &numberEnd, hex ? 16 : 10);
+            if (*number && !*numberEnd && code <= 0x10FFFF)
+            {
+                appendUtf8(value, code);
+            }
+            else
+            {
+                value += '&' + entity + ';';
+            }
+        }
+        else
+        {
+            value += '&' + entity + ';';
+        }
+    }
 
-                // Read the included file into a library document.
-                DocumentPtr library = createDocument();
-                XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
-                xiReadOptions.parentFilenames.insert(filename);
-                readXIncludeFunction(library, filename, searchPath, &xiReadOptions);
+    // Read an attribute into the next free entry of the attribute list.
+    std::pair<string, string>& addAttribute()
+    {
+        if (_attributes.size() <= _attributeCount)
+        {
+            _attributes.resize(_attributeCount + 1);
+        }
+        std::pair<string, string>& attr = _attributes[_attributeCount++];
+        readName(attr.first);
+        skipSpace();
+        expect('=');
+        skipSpace();
+        readAttributeValue(attr.second);
 
-                // Import the library document.
-                doc->importLibrary(library, readOptions);
+        // Attributes must be separated by whitespace.
+        int c = peek();
+        if (!isXmlSpace(c) && c != '/' && c != '>' && c != '?')
+        {
+            throw parseError("Unexpected character");
+        }
+        return attr;
+    }
+
+    void readStartTag()
+    {
+        if (_tags.size() <= _depth)
+        {
+            _tags.resize(_depth + 1);
+            _elements.resize(_depth + 1);
+        }
+        string& tag = _tags[_depth];
+        readName(tag);
+
+        _attributeCount = 0;
+        bool selfClosing = false;
+        while (true)
+        {
+            skipSpace();
+            int c = peek();
+            if (c == '/')
+            {
+                get();
+                expect('>');
+                selfClosing = true;
+                break;
+            }
+            if (c == '>')
+            {
+                get();
+                break;
+            }
+            if (c < 0)
+            {
+                throw parseError("Unterminated start tag");
             }
+            addAttribute();
+        }
+
+        _elements[_depth] = startElement(tag);
+        _depth++;
+        if (selfClosing)
+        {
+            endElement();
+        }
+    }
+
+    void readEndTag()
+    {
+        readName(_endTag);
+        skipSpace();
+        expect('>');
+        if (!_depth || _endTag != _tags[_depth - 1])
+        {
+            throw parseError("Start-end tags mismatch");
+        }
+        endElement();
+    }
+
+    //
+    // Element construction
+    //
+
+    // Create the element for the given start tag, returning an empty pointer
+    // if its subtree is to be skipped.
+    ElementPtr startElement(const string& tag)
+    {
+        static const Symbol DOCUMENT_CATEGORY(Document::CATEGORY);
+        static const Symbol XINCLUDE_CATEGORY(XINCLUDE_TAG);
+
+        // Intern the category once, for both comparison and construction.
+        Symbol category(tag);
+
+        if (!_depth)
+        {
+            if (_rootFound)
+            {
+                throw parseError("Multiple document elements");
+            }
+            _rootFound = true;
+            if (category != DOCUMENT_CATEGORY)
+            {
+                return nullptr;
+            }
+            setAttributes(_doc);
+            return _doc;
+        }
+
+        ElementPtr parent = _elements[_depth - 1];
+        if (!parent)
+        {
+            return nullptr;
+        }
+        if (parent == _doc && category == XINCLUDE_CATEGORY)
+        {
+            _includes.request(getAttribute("href"));
+            return nullptr;
+        }
+
+        const string& name = getAttribute(Element::NAME_ATTRIBUTE);
+
+        // If requested, skip elements with duplicate names.
+        if (_readOptions && _readOptions->skipDuplicateElements && parent->getChild(name))
+        {
+            return nullptr;
+        }
+
+        ElementPtr elem = parent->addChildOfCategory(category, name);
+        setAttributes(elem);
+        return elem;
+    }
+
+    void endElement()
+    {
+        _depth--;
+        _elements[_depth] = nullptr;
+    }
+
+    // Add an anonymous element for a CDATA section or character data.
+    void addCharacterData()
+    {
+        ElementPtr parent = _depth ? _elements[_depth - 1] : nullptr;
+        if (parent)
+        {
+            parent->addChildOfCategory(Symbol(EMPTY_STRING), EMPTY_STRING);
+        }
+    }
+
+    const string& getAttribute(const string& attrName) const
+    {
+        for (size_t i = 0; i < _attributeCount; i++)
+        {
+            if (_attributes[i].first == attrName)
+            {
+                return _attributes[i].second;
+            }
+        }
+        return EMPTY_STRING;
+    }
+
+    void setAttributes(ElementPtr elem)
+    {
+        for (size_t i = 0; i < _attributeCount; i++)
+        {
+            const std::pair<string, string>& attr = _attributes[i];
+            if (attr.first == SOURCE_URI_ATTRIBUTE)
+            {
+                elem->setSourceUri(attr.second);
+            }
+            else if (attr.first != Element::NAME_ATTRIBUTE)
+            {
+                elem->setAttribute(attr.first, attr.second);
+            }
+        }
+    }
+
+    ExceptionParseError parseError(const string& desc) const
+    {
+        size_t offset = _consumed + (_pos - _bufferStart);
+        return ExceptionParseError("XML parse error in " + _source +
+                                   " (" + desc + " at character " + std::to_string(offset) + ")");
+    }
+
+  private:
+    DocumentPtr _target;
+    DocumentPtr _doc;
+    string _source;
+    const XmlReadOptions* _readOptions;
+    XIncludeReader _includes;
+
+    std::istream* _stream;
+    vector<char> _buffer;
+    const char* _bufferStart;
+    const char* _pos;
+    const char* _end;
+    size_t _consumed;
+
+    vector<std::pair<string, string>> _attributes;
+    size_t _attributeCount;
+    string _endTag;
+    string _entity;
+
+    vector<string> _tags;
+    vector<ElementPtr> _elements;
+    size_t _depth;
+    bool _rootFound;
+};
+
+namespace {
+
+void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const string& searchPath, const XmlReadOptions* readOptions)
+{
+    // Begin reading all included files, and then import them in order.
+    XIncludeReader includes(searchPath, readOptions);
+    xml_node xmlChild = xmlNode.first_child();
+    while (xmlChild)
+    {
+        if (xmlChild.name() == XINCLUDE_TAG)
+        {
+            includes.request(xmlChild.attribute("href").value());
 
             // Remove include directive.
             xml_node includeNode = xmlChild;
@@ -180,6 +962,7 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const string& searchPa
             xmlChild = xmlChild.next_sibling();
         }
     }
+    includes.import(doc);
 }
 
 void documentFromXml(DocumentPtr doc,
@@ -211,6 +994,90 @@ XmlReadOptions::XmlReadOptions() :
 {
 }
 
+//
+// XIncludeCache methods
+//
+
+size_t XIncludeCache::getReadCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _documents.size();
+}
+
+ConstDocumentPtr XIncludeCache::getDocument(const string& filename,
+                                            const string& searchPath,
+                                            const XmlReadOptions& readOptions,
+                                            const IncludeKey& includer)
+{
+    IncludeKey key(filename, searchPath);
+    std::promise<ConstDocumentPtr> promise;
+    std::shared_future<ConstDocumentPtr> pendingDocument;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Reject references that would close a cycle in the include graph of
+        // the cache, as a read in such a cycle would wait on itself.
+        if (key == includer || includes(key, includer))
+        {
+            throw ExceptionParseError("XInclude cycle detected.");
+        }
+        _includes[includer].insert(key);
+
+        auto it = _documents.find(key);
+        if (it != _documents.end())
+        {
+            pendingDocument = it->second;
+        }
+        else
+        {
+            _documents[key] = promise.get_future().share();
+        }
+    }
+
+    // Wait for a document that has been read, or is being read, by another
+    // operation sharing this cache.
+    if (pendingDocument.valid())
+    {
+        return pendingDocument.get();
+    }
+
+    // Read the included file on this thread, recording it as the includer
+    // of the files that it references.
+    const IncludeKey* previousInclude = currentInclude;
+    currentInclude = &key;
+    try
+    {
+        DocumentPtr library = createDocument();
+        readOptions.readXIncludeFunction(library, key.first, key.second, &readOptions);
+        currentInclude = previousInclude;
+        promise.set_value(library);
+        return library;
+    }
+    catch (...)
+    {
+        currentInclude = previousInclude;
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+bool XIncludeCache::includes(const IncludeKey& includer, const IncludeKey& key) const
+{
+    auto it = _includes.find(includer);
+    if (it == _includes.end())
+    {
+        return false;
+    }
+    for (const IncludeKey& include : it->second)
+    {
+        if (include == key || includes(include, key))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 //
 // XmlWriteOptions methods
 //
@@ -263,6 +1130,31 @@ void readFromXmlString(DocumentPtr doc, const string& str, const XmlReadOptions*
     readFromXmlStream(doc, stream, readOptions);
 }
 
+void readFromXmlStreamIncremental(DocumentPtr doc, std::istream& stream, const XmlReadOptions* readOptions)
+{
+    XmlStreamReader reader(doc, "stream", EMPTY_STRING, readOptions);
+    reader.read(stream);
+    reader.merge();
+}
+
+void readFromXmlFileIncremental(DocumentPtr doc, const string& filename, const string& searchPath, const XmlReadOptions* readOptions)
+{
+    FileSearchPath fileSearchPath = FileSearchPath(searchPath);
+    fileSearchPath.append(getEnvironmentPath());
+    string resolvedFilename = fileSearchPath.find(filename);
+
+    std::ifstream stream(resolvedFilename, std::ios::binary);
+    if (!stream)
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + resolvedFilename);
+    }
+
+    XmlStreamReader reader(doc, "file: " + resolvedFilename, searchPath, readOptions);
+    reader.read(stream);
+    reader.merge();
+    doc->setSourceUri(filename);
+}
+
 //
 // Writing
 //
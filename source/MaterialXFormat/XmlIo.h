@@ -13,10 +13,18 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <future>
+#include <map>
+#include <mutex>
+
 namespace MaterialX
 {
 
 class XmlReadOptions;
+class XIncludeCache;
+
+/// A shared pointer to an XIncludeCache
+using XIncludeCachePtr = shared_ptr<XIncludeCache>;
 
 /// A standard function that reads from an XML file into a Document, with
 /// optional search path and read options.
@@ -37,6 +45,49 @@ class XmlReadOptions : public CopyOptions
     /// The set of parent filenames at the scope of the current document.
     /// Defaults to an empty set.
     StringSet parentFilenames;
+
+    /// The cache through which XInclude references are read.  If provided,
+    /// the cache may be shared by a batch of read operations with the same
+    /// options, so that each included file is read only once.  If null, a
+    /// new cache is created for each read operation.  Defaults to nullptr.
+    XIncludeCachePtr xincludeCache;
+};
+
+/// @class XIncludeCache
+/// A cache of the documents read for XInclude references.
+///
+/// A read operation shares its cache with the reads of its included files,
+/// so that each distinct file in the include graph is read once.  When the
+/// built-in readers are used, the files included by a document are read in
+/// parallel on the shared thread pool, while a custom
+/// XmlReadOptions::readXIncludeFunction is called serially on the calling
+/// thread.  Included documents are imported in the order of their
+/// references, so that the results match a serial read.
+class XIncludeCache
+{
+  public:
+    XIncludeCache() { }
+    ~XIncludeCache() { }
+
+    /// Return the number of distinct files that have been read through
+    /// this cache.
+    size_t getReadCount() const;
+
+  private:
+    using IncludeKey = std::pair<string, string>;
+
+    ConstDocumentPtr getDocument(const string& filename,
+                                 const string& searchPath,
+                                 const XmlReadOptions& readOptions,
+                                 const IncludeKey& includer);
+    bool includes(const IncludeKey& includer, const IncludeKey& key) const;
+
+    friend class XIncludeReader;
+
+  private:
+    mutable std::mutex _mutex;
+    std::map<IncludeKey, std::shared_future<ConstDocumentPtr>> _documents;
+    std::map<IncludeKey, std::set<IncludeKey>> _includes;
 };
 
 /// @class XmlWriteOptions
@@ -118,6 +169,44 @@ void readFromXmlFile(DocumentPtr doc,
 /// @throws ExceptionParseError if the document cannot be parsed.
 void readFromXmlString(DocumentPtr doc, const string& str, const XmlReadOptions* readOptions = nullptr);
 
+/// @}
+/// @name Incremental Read Functions
+/// An alternative to the read functions above for large documents, which
+/// parses XML incrementally rather than through an XML DOM, so that neither
+/// the XML text nor a DOM is held in memory.  Input is consumed in fixed-size
+/// blocks, and elements are read into a scratch document, which is merged
+/// into the given document only once the parse has succeeded.  If a parse
+/// error is encountered, the given document is left unchanged.
+///
+/// Documents are read as by the read functions above, with the exception
+/// that only UTF-8 input is supported.
+/// @{
+
+/// Read a Document as XML from the given input stream, incrementally.
+/// @param doc The Document into which data is read.
+/// @param stream The input stream from which data is read.
+/// @param readOptions An optional pointer to an XmlReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the document cannot be parsed.
+void readFromXmlStreamIncremental(DocumentPtr doc, std::istream& stream, const XmlReadOptions* readOptions = nullptr);
+
+/// Read a Document as XML from the given filename, incrementally.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.
+/// @param searchPath A semicolon-separated sequence of file paths, which will
+///    be applied in order when searching for the given file and its includes.
+///    Defaults to the empty string.
+/// @param readOptions An optional pointer to an XmlReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the document cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+void readFromXmlFileIncremental(DocumentPtr doc,
+                                const string& filename,
+                                const string& searchPath = EMPTY_STRING,
+                                const XmlReadOptions* readOptions = nullptr);
+
 /// @}
 /// @name Write Functions
 /// @{
@@ -59,11 +59,12 @@ void LightCompoundNodeGlsl::createVariables(const ShaderNode&, GenContext& conte
     ShaderStage& ps = shader.getStage(Stage::PIXEL);
     VariableBlock& lightData = ps.getUniformBlock(HW::LIGHT_DATA);
 
-    // Create all light uniforms
+    // Create all light uniforms.  Each shader is given its own ports, so
+    // that the ports of this implementation are never shared by shaders.
     for (size_t i = 0; i<_lightUniforms.size(); ++i)
     {
-        ShaderPort* u = const_cast<ShaderPort*>(_lightUniforms[i]);
-        lightData.add(u->getSelf());
+        const ShaderPort* u = _lightUniforms[i];
+        lightData.add(u->getType(), u->getName());
     }
 
     // Create uniform for number of active light sources
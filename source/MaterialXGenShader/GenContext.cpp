@@ -8,6 +8,23 @@
 namespace MaterialX
 {
 
+namespace
+{
+
+// Return a string holding the generation options that may affect the
+// construction of a shader graph.
+string getTemplateOptions(const GenOptions& options)
+{
+    return std::to_string(options.shaderInterfaceType) + ":" +
+           std::to_string(options.fileTextureVerticalFlip) + ":" +
+           options.targetColorSpaceOverride + ":" +
+           std::to_string(options.hwTransparency) + ":" +
+           std::to_string(options.hwSpecularEnvironmentMethod) + ":" +
+           std::to_string(options.hwMaxActiveLightSources);
+}
+
+} // anonymous namespace
+
 //
 // GenContext methods
 //
@@ -21,6 +38,16 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
     }
 }
 
+GenContext::GenContext(const GenContext& other) :
+    _sg(other._sg),
+    _options(other._options),
+    _sourceCodeSearchPath(other._sourceCodeSearchPath),
+    _userData(other._userData),
+    _inputSuffix(other._inputSuffix),
+    _outputSuffix(other._outputSuffix)
+{
+}
+
 void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
 {
     _nodeImpls[name] = impl;
@@ -32,6 +59,38 @@ ShaderNodeImplPtr GenContext::findNodeImplementation(const string& name)
     return it != _nodeImpls.end() ? it->second : nullptr;
 }
 
+void GenContext::addShaderGraphTemplate(const string& key, ConstDocumentPtr document, ShaderGraphPtr graph)
+{
+    // Drop templates whose documents no longer exist.
+    for (auto it = _graphTemplates.begin(); it != _graphTemplates.end(); )
+    {
+        it = it->second.document.expired() ? _graphTemplates.erase(it) : std::next(it);
+    }
+
+    GraphTemplate& graphTemplate = _graphTemplates[key];
+    graphTemplate.document = document;
+    graphTemplate.nodeDefRevision = document->getNodeDefRevision();
+    graphTemplate.options = getTemplateOptions(_options);
+    graphTemplate.graph = graph;
+}
+
+ConstShaderGraphPtr GenContext::findShaderGraphTemplate(const string& key, ConstDocumentPtr document) const
+{
+    auto it = _graphTemplates.find(key);
+    if (it == _graphTemplates.end())
+    {
+        return nullptr;
+    }
+    const GraphTemplate& graphTemplate = it->second;
+    if (graphTemplate.document.lock() != document ||
+        graphTemplate.nodeDefRevision != document->getNodeDefRevision() ||
+        graphTemplate.options != getTemplateOptions(_options))
+    {
+        return nullptr;
+    }
+    return graphTemplate.graph;
+}
+
 void GenContext::addInputSuffix(const ShaderInput* input, const string& suffix)
 {
     _inputSuffix[input] = suffix;
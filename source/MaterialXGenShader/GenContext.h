@@ -14,6 +14,8 @@
 #include <MaterialXGenShader/GenOptions.h>
 #include <MaterialXGenShader/ShaderNode.h>
 
+#include <MaterialXCore/Document.h>
+
 #include <MaterialXFormat/File.h>
 
 namespace MaterialX
@@ -65,12 +67,22 @@ class GenUserData : public std::enable_shared_from_this<GenUserData>
 /// @class GenContext 
 /// A context class for shader generation.
 /// Used for thread local storage of data needed during shader generation.
+///
+/// A context may be copied to give each of several concurrent shader
+/// generation tasks its own context.  A copy has the shader generator,
+/// options, search path and user data of the original, and starts with
+/// empty caches of shader node implementations and shader graph templates,
+/// since implementations hold state that is not safe to share between
+/// threads.
 class GenContext
 {
   public:
     /// Constructor.
     GenContext(ShaderGeneratorPtr sg);
 
+    /// Copy constructor.  The copy has its own empty caches.
+    GenContext(const GenContext& other);
+
     /// Return shader generatior.
     ShaderGenerator& getShaderGenerator()
     {
@@ -113,6 +125,12 @@ class GenContext
         return _sourceCodeSearchPath.find(filename);
     }
 
+    /// Return the search path used to resolve source code files.
+    const FileSearchPath& getSourceCodeSearchPath() const
+    {
+        return _sourceCodeSearchPath;
+    }
+
     /// Cache a shader node implementation.
     void addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
 
@@ -120,6 +138,27 @@ class GenContext
     /// or return nullptr if no implementation is found.
     ShaderNodeImplPtr findNodeImplementation(const string& name);
 
+    /// Cache a shader graph template built from the given document.
+    /// Templates hold the parameter-independent structure of a shader graph,
+    /// and are copied to build the graphs of elements that share this
+    /// structure.  The template is not modified once cached, and replaces
+    /// any template previously cached with the same key.  The document is
+    /// held weakly, along with its nodedef revision and the current
+    /// generation options.
+    void addShaderGraphTemplate(const string& key, ConstDocumentPtr document, ShaderGraphPtr graph);
+
+    /// Find and return a cached shader graph template for the given
+    /// document, or return nullptr if no template is found.  A template is
+    /// only returned if it was built from the same document, at its current
+    /// nodedef revision, with the current generation options.
+    ConstShaderGraphPtr findShaderGraphTemplate(const string& key, ConstDocumentPtr document) const;
+
+    /// Remove all cached shader graph templates.
+    void clearShaderGraphTemplates()
+    {
+        _graphTemplates.clear();
+    }
+
     /// Add user data to the context to make it
     /// available during shader generator.
     void pushUserData(const string& name, GenUserDataPtr data)
@@ -195,6 +234,18 @@ class GenContext
     // Cached shader node implementations.
     std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
 
+    // A cached shader graph template, with the state it was built from.
+    struct GraphTemplate
+    {
+        std::weak_ptr<const Document> document;
+        size_t nodeDefRevision;
+        string options;
+        ShaderGraphPtr graph;
+    };
+
+    // Cached shader graph templates.
+    std::unordered_map<string, GraphTemplate> _graphTemplates;
+
     // User data
     std::unordered_map<string, vector<GenUserDataPtr>> _userData;
 
@@ -203,6 +254,9 @@ class GenContext
 
     // List of output suffixes
     std::unordered_map<const ShaderOutput*, string> _outputSuffix;
+
+  private:
+    GenContext& operator=(const GenContext&) = delete;
 };
 
 } // namespace MaterialX
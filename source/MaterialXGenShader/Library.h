@@ -33,6 +33,10 @@ using ShaderPtr = shared_ptr<Shader>;
 using ShaderStagePtr = shared_ptr<ShaderStage>;
 /// Shared pointer to a ShaderGenerator
 using ShaderGeneratorPtr = shared_ptr<ShaderGenerator>;
+/// Shared pointer to a ShaderGraph
+using ShaderGraphPtr = shared_ptr<ShaderGraph>;
+/// Shared pointer to a constant ShaderGraph
+using ConstShaderGraphPtr = shared_ptr<const ShaderGraph>;
 /// Shared pointer to a ShaderNodeImpl
 using ShaderNodeImplPtr = shared_ptr<ShaderNodeImpl>;
 /// Shared pointer to a GenContext
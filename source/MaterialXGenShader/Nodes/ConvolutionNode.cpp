@@ -5,10 +5,14 @@
 
 #include <MaterialXGenShader/Nodes/ConvolutionNode.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
 #include <MaterialXGenShader/ShaderNode.h>
 #include <MaterialXGenShader/ShaderStage.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderGraph.h>
+
+#include <algorithm>
 
 namespace
 {
@@ -93,6 +97,190 @@ const ShaderInput* ConvolutionNode::getSamplingInput(const ShaderNode& node) con
     return nullptr;
 }
 
+void ConvolutionNode::emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
+{
+    // Upstream functions are defined only for hardware shading languages,
+    // which declare constants and uniforms at global scope.  Other languages,
+    // such as OSL, declare them within the shader body, where they cannot be
+    // referenced by the upstream functions, so samples are emitted inline.
+    if (!dynamic_cast<const HwShaderGenerator*>(&context.getShaderGenerator()))
+    {
+        return;
+    }
+
+    BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
+        // Function definitions are emitted once per implementation, so emit
+        // the upstream functions of all convolution nodes in the graph here.
+        // Nodes are visited in topological order, so functions called by
+        // other upstream functions are defined first.
+        for (const ShaderNode* graphNode : node.getParent()->getNodes())
+        {
+            const ConvolutionNode* convolution = dynamic_cast<const ConvolutionNode*>(&graphNode->getImplementation());
+            UpstreamFunction function;
+            if (convolution &&
+                convolution->getUpstreamFunction(*graphNode, function) &&
+                stage.addFunctionName(function.name))
+            {
+                convolution->emitUpstreamFunction(*graphNode, function, context, stage);
+            }
+        }
+    END_SHADER_STAGE(stage, Stage::PIXEL)
+}
+
+bool ConvolutionNode::getUpstreamFunction(const ShaderNode& node, UpstreamFunction& function) const
+{
+    const ShaderInput* inInput = node.getInput("in");
+    const ShaderOutput* inConnection = inInput ? inInput->getConnection() : nullptr;
+    const ShaderGraph* graph = node.getParent();
+    if (!graph || !inConnection || !inConnection->getType() || !acceptsInputType(inConnection->getType()))
+    {
+        return false;
+    }
+
+    DependencyMap dependencies;
+    if (!dependsOnSample(inConnection->getNode(), graph, dependencies))
+    {
+        return false;
+    }
+
+    function.name = node.getOutput()->getVariable() + "_upstream";
+    function.nodes.clear();
+    function.arguments.clear();
+    function.sampledArguments.clear();
+
+    auto addArgument = [&function](const ShaderOutput* argument, bool sampled)
+    {
+        auto it = std::find(function.arguments.begin(), function.arguments.end(), argument);
+        if (it == function.arguments.end())
+        {
+            function.arguments.push_back(argument);
+            function.sampledArguments.push_back(sampled);
+        }
+        else if (sampled)
+        {
+            function.sampledArguments[it - function.arguments.begin()] = true;
+        }
+    };
+
+    // Gather the upstream nodes that depend on a sampled texture coordinate,
+    // passing the outputs of all other nodes as arguments.
+    for (const ShaderNode* graphNode : graph->getNodes())
+    {
+        auto it = dependencies.find(graphNode);
+        if (it == dependencies.end() || !it->second)
+        {
+            continue;
+        }
+        function.nodes.push_back(graphNode);
+
+        const ConvolutionNode* convolution = dynamic_cast<const ConvolutionNode*>(&graphNode->getImplementation());
+        if (convolution)
+        {
+            // Nested convolutions call their own upstream function,
+            // which takes its arguments from this function.
+            UpstreamFunction nested;
+            if (convolution->getUpstreamFunction(*graphNode, nested))
+            {
+                for (size_t i = 0; i < nested.arguments.size(); i++)
+                {
+                    addArgument(nested.arguments[i], nested.sampledArguments[i]);
+                }
+            }
+        }
+
+        const ShaderInput* samplingInput = convolution ? nullptr : getSamplingInput(*graphNode);
+        for (const ShaderInput* input : graphNode->getInputs())
+        {
+            const ShaderOutput* connection = input->getConnection();
+            if (!connection || (convolution && input->getName() == "in"))
+            {
+                continue;
+            }
+            auto upstream = dependencies.find(connection->getNode());
+            if (upstream == dependencies.end() || !upstream->second)
+            {
+                addArgument(connection, input == samplingInput);
+            }
+        }
+    }
+
+    return std::find(function.sampledArguments.begin(), function.sampledArguments.end(), true) != function.sampledArguments.end();
+}
+
+bool ConvolutionNode::dependsOnSample(const ShaderNode* node, const ShaderGraph* graph, DependencyMap& dependencies) const
+{
+    // Graph sockets are arguments of the graph.
+    if (node == graph)
+    {
+        return false;
+    }
+    auto it = dependencies.find(node);
+    if (it != dependencies.end())
+    {
+        return it->second;
+    }
+    dependencies[node] = false;
+
+    // A node depends on the sample position if it samples a texture
+    // coordinate, if it is a convolution of such a node, or if any
+    // of its inputs depend on the sample position.
+    bool depends = false;
+    const ConvolutionNode* convolution = dynamic_cast<const ConvolutionNode*>(&node->getImplementation());
+    if (convolution)
+    {
+        UpstreamFunction nested;
+        depends = convolution->getUpstreamFunction(*node, nested);
+    }
+    else
+    {
+        const ShaderInput* samplingInput = getSamplingInput(*node);
+        depends = samplingInput &&
+                  samplingInput->getType() == Type::VECTOR2 &&
+                  samplingInput->getChannels().empty() &&
+                  samplingInput->getConnection() &&
+                  samplingInput->getConnection()->getType() == Type::VECTOR2;
+    }
+    for (const ShaderInput* input : node->getInputs())
+    {
+        const ShaderOutput* connection = input->getConnection();
+        if (connection && !(convolution && input->getName() == "in") &&
+            dependsOnSample(connection->getNode(), graph, dependencies))
+        {
+            depends = true;
+        }
+    }
+
+    dependencies[node] = depends;
+    return depends;
+}
+
+void ConvolutionNode::emitUpstreamFunction(const ShaderNode& node, const UpstreamFunction& function, GenContext& context, ShaderStage& stage) const
+{
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    const Syntax& syntax = shadergen.getSyntax();
+    const ShaderInput* inInput = node.getInput("in");
+
+    // Arguments keep the names of the variables they are called with,
+    // so the upstream nodes are emitted unchanged in the function body.
+    string signature = syntax.getTypeName(inInput->getType()) + " " + function.name + "(";
+    string delim = "";
+    for (const ShaderOutput* argument : function.arguments)
+    {
+        signature += delim + syntax.getTypeName(argument->getType()) + " " + argument->getVariable();
+        delim = ", ";
+    }
+    shadergen.emitLine(signature + ")", stage, false);
+
+    shadergen.emitScopeBegin(stage);
+    for (const ShaderNode* upstreamNode : function.nodes)
+    {
+        shadergen.emitFunctionCall(*upstreamNode, context, stage, false);
+    }
+    shadergen.emitLine("return " + shadergen.getUpstreamResult(inInput, context), stage);
+    shadergen.emitScopeEnd(stage);
+    shadergen.emitLineBreak(stage);
+}
+
 void ConvolutionNode::emitInputSamplesUV(const ShaderNode& node, 
                                          unsigned int sampleCount, unsigned int filterWidth, 
                                          float filterSize, float filterOffset,
@@ -108,7 +296,56 @@ void ConvolutionNode::emitInputSamplesUV(const ShaderNode& node,
     const ShaderInput* inInput = node.getInput("in");
     const ShaderOutput* inConnection = inInput ? inInput->getConnection() : nullptr;
 
-    if (inConnection && inConnection->getType() && acceptsInputType(inConnection->getType()))
+    UpstreamFunction function;
+    if (getUpstreamFunction(node, function) && stage.hasFunctionName(function.name))
+    {
+        StringVec inputVec2Suffix;
+        if (sampleCount > 1)
+        {
+            // Emit code to compute sample size from the first sampled
+            // texture coordinate.
+            const ShaderOutput* output = node.getOutput();
+            const size_t sampledIndex = std::find(function.sampledArguments.begin(), function.sampledArguments.end(), true) - function.sampledArguments.begin();
+            const string sampleSizeName(output->getVariable() + "_sample_size");
+            const string vec2TypeString = shadergen.getSyntax().getTypeName(Type::VECTOR2);
+            string sampleCall(vec2TypeString + " " + sampleSizeName + " = " +
+                sampleSizeFunctionUV + "(" +
+                function.arguments[sampledIndex]->getVariable() + "," +
+                std::to_string(filterSize) + "," +
+                std::to_string(filterOffset) + ");"
+            );
+            shadergen.emitLine(sampleCall, stage);
+
+            // Build the sample offset strings. This is dependent on
+            // the derived class to determine where samples are located
+            // and to generate the strings required to offset from the center
+            // sample. The sample size is passed over.
+            //
+            computeSampleOffsetStrings(sampleSizeName, vec2TypeString,
+                filterWidth, inputVec2Suffix);
+        }
+
+        // Each sample is a call to the upstream function, with all
+        // sampled texture coordinates offset.  A single sample is also
+        // a call, since the upstream nodes are not emitted outside the
+        // function when this node is nested in another upstream function.
+        for (unsigned int i = 0; i < sampleCount; i++)
+        {
+            string sampleString = function.name + "(";
+            string delim = "";
+            for (size_t j = 0; j < function.arguments.size(); j++)
+            {
+                sampleString += delim + function.arguments[j]->getVariable();
+                if (function.sampledArguments[j] && sampleCount > 1)
+                {
+                    sampleString += inputVec2Suffix[i];
+                }
+                delim = ", ";
+            }
+            sampleStrings.push_back(sampleString + ")");
+        }
+    }
+    else if (inConnection && inConnection->getType() && acceptsInputType(inConnection->getType()))
     {
         const ShaderNode* upstreamNode = inConnection->getNode();
         if (upstreamNode && upstreamNode->hasClassification(ShaderNode::Classification::SAMPLE2D))
@@ -192,6 +429,16 @@ void ConvolutionNode::emitInputSamplesUV(const ShaderNode& node,
                 }
             }
         }
+        else
+        {
+            // The upstream result does not depend on the sample position,
+            // so use it for all samples.
+            const string upstreamResult = shadergen.getUpstreamResult(inInput, context);
+            for (unsigned int i = 0; i < sampleCount; i++)
+            {
+                sampleStrings.push_back(upstreamResult);
+            }
+        }
     }
     else
     {
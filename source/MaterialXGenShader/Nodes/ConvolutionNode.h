@@ -8,9 +8,13 @@
 
 #include <MaterialXGenShader/ShaderNodeImpl.h>
 
+#include <unordered_map>
+
 namespace MaterialX
 {
 
+class ShaderGraph;
+
 /// Utility class for implementations of nodes which perform convolutions
 ///
 class ConvolutionNode : public ShaderNodeImpl
@@ -18,7 +22,24 @@ class ConvolutionNode : public ShaderNodeImpl
   public:
      void createVariables(const ShaderNode& node, GenContext& context, Shader& shader) const override;
 
+     void emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
+
   protected:
+    /// A function evaluating the graph upstream of a convolution node at
+    /// an offset sample position, so that each sample is a single call.
+    struct UpstreamFunction
+    {
+        /// Name of the function.
+        string name;
+        /// Upstream nodes evaluated by the function, in topological order.
+        vector<const ShaderNode*> nodes;
+        /// Outputs of other nodes passed as arguments to the function.
+        vector<const ShaderOutput*> arguments;
+        /// For each argument, true if it is a sampled texture coordinate,
+        /// which is offset for each sample.
+        vector<bool> sampledArguments;
+    };
+
     /// Constructor
     ConvolutionNode();
 
@@ -34,6 +55,11 @@ class ConvolutionNode : public ShaderNodeImpl
     /// then a null pointer is returned.
     virtual const ShaderInput* getSamplingInput(const ShaderNode& node) const;
 
+    /// Return the function evaluating the graph upstream of the given node.
+    /// Returns false if the upstream graph does not depend on a sampled
+    /// texture coordinate.
+    bool getUpstreamFunction(const ShaderNode& node, UpstreamFunction& function) const;
+
     /// Generate upstream / input sampling code in uv space and cache the output variable names which 
     /// will hold the sample values after execution.
     void emitInputSamplesUV(const ShaderNode& node,
@@ -45,6 +71,12 @@ class ConvolutionNode : public ShaderNodeImpl
 
     static const string SAMPLE2D_INPUT;
     static const string SAMPLE3D_INPUT;
+
+  private:
+    using DependencyMap = std::unordered_map<const ShaderNode*, bool>;
+
+    bool dependsOnSample(const ShaderNode* node, const ShaderGraph* graph, DependencyMap& dependencies) const;
+    void emitUpstreamFunction(const ShaderNode& node, const UpstreamFunction& function, GenContext& context, ShaderStage& stage) const;
 };
 
 } // namespace MaterialX
@@ -47,10 +47,12 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
     }
     context.getShaderGenerator().getSyntax().makeValidName(_functionName);
 
-    if (!readFile(context.resolveSourceFile(file), _functionSource))
+    ConstSourceFilePtr sourceFile = readSourceFile(context.resolveSourceFile(file));
+    if (!sourceFile)
     {
         throw ExceptionShaderGenError("Can't find source file '" + file + "' used by implementation '" + impl.getName() + "'");
     }
+    _functionSource = sourceFile->getContents();
 
     if (_inlined)
     {
@@ -0,0 +1,498 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <MaterialXCore/Document.h>
+#include <MaterialXCore/Util.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace MaterialX
+{
+
+namespace {
+
+// The version of the key and file formats, which is combined with every key.
+const string SHADER_CACHE_VERSION = "2";
+const string SHADER_CACHE_EXTENSION = ".mxshader";
+
+// Return a name for a temporary file that is unique to the calling thread
+// of this process.  A random number is included as well as the process
+// identifier, since processes on different hosts may share a directory.
+string getTemporarySuffix()
+{
+#if defined(_WIN32)
+    long processId = (long) _getpid();
+#else
+    long processId = (long) getpid();
+#endif
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    std::ostringstream suffix;
+    suffix << ".tmp" << processId << '_' << std::this_thread::get_id() << '_' << std::hex << generator();
+    return suffix.str();
+}
+
+// A 64-bit FNV-1a hash, which is stable across platforms and processes.
+class StableHash
+{
+  public:
+    StableHash() :
+        _hash(14695981039346656037ULL)
+    {
+    }
+
+    void add(const string& str)
+    {
+        for (char c : str)
+        {
+            addByte((unsigned char) c);
+        }
+
+        // Terminate each string, so that adjacent strings are unambiguous.
+        addByte(0xFF);
+    }
+
+    string asString() const
+    {
+        char buffer[17];
+        snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long) _hash);
+        return string(buffer);
+    }
+
+  private:
+    void addByte(unsigned char byte)
+    {
+        _hash ^= byte;
+        _hash *= 1099511628211ULL;
+    }
+
+  private:
+    uint64_t _hash;
+};
+
+// Gathers the content of a renderable element's upstream graph into a hash.
+class UpstreamGraphHasher
+{
+  public:
+    UpstreamGraphHasher(const ShaderCache& cache, GenContext& context, StableHash& hash) :
+        _cache(cache),
+        _context(context),
+        _target(context.getShaderGenerator().getTarget()),
+        _language(context.getShaderGenerator().getLanguage()),
+        _hash(hash)
+    {
+    }
+
+    void hashElement(ConstElementPtr element)
+    {
+        _doc = element->getDocument();
+
+        // Document attributes, such as the color space, apply to all elements.
+        for (const string& attrName : _doc->getAttributeNames())
+        {
+            _hash.add(attrName);
+            _hash.add(_doc->getAttribute(attrName));
+        }
+
+        // Gather top-level elements breadth first, starting from the top-level
+        // ancestor of the given element.
+        ConstElementPtr topLevel = element;
+        while (topLevel->getParent() && topLevel->getParent() != _doc)
+        {
+            topLevel = topLevel->getParent();
+        }
+        enqueue(topLevel);
+
+        // Light shaders bound to a hardware context are generated from the
+        // implementations of their node definitions.
+        HwLightShadersPtr lightShaders = _context.getUserData<HwLightShaders>(HW::USER_DATA_LIGHT_SHADERS);
+        if (lightShaders)
+        {
+            std::map<unsigned int, const ShaderNode*> sortedShaders;
+            for (const auto& pair : lightShaders->get())
+            {
+                sortedShaders[pair.first] = pair.second.get();
+            }
+            for (const auto& pair : sortedShaders)
+            {
+                const string& implName = pair.second->getImplementation().getName();
+                _hash.add(std::to_string(pair.first));
+                _hash.add(pair.second->getName());
+                _hash.add(implName);
+                enqueue(_doc->findLibraryElement(implName));
+            }
+        }
+
+        for (size_t i = 0; i < _queue.size(); i++)
+        {
+            hashTree(*_queue[i]);
+        }
+    }
+
+  private:
+    void enqueue(ConstElementPtr elem)
+    {
+        if (elem && _visited.insert(elem.get()).second)
+        {
+            _queue.push_back(elem);
+        }
+    }
+
+    void hashTree(const Element& elem)
+    {
+        _hash.add(elem.getCategory());
+        _hash.add(elem.getName());
+        const StringVec& attrNames = elem.getAttributeNames();
+        for (const string& attrName : attrNames)
+        {
+            const string& value = elem.getAttribute(attrName);
+            _hash.add(attrName);
+            _hash.add(value);
+
+            // Follow references to other top-level elements, such as node
+            // definitions, node graphs, type definitions and geometric
+            // properties.
+            if (!value.empty())
+            {
+                enqueue(_doc->findLibraryElement(value));
+            }
+        }
+
+        if (const Node* node = dynamic_cast<const Node*>(&elem))
+        {
+            if (!node->hasNodeDefString())
+            {
+                enqueue(node->getDeclaration(_target));
+            }
+        }
+        else if (const ShaderRef* shaderRef = dynamic_cast<const ShaderRef*>(&elem))
+        {
+            enqueue(shaderRef->getNodeDef());
+        }
+        else if (const NodeDef* nodeDef = dynamic_cast<const NodeDef*>(&elem))
+        {
+            enqueue(nodeDef->getImplementation(_target, _language));
+        }
+        else if (const Input* input = dynamic_cast<const Input*>(&elem))
+        {
+            if (input->hasDefaultGeomPropString())
+            {
+                // Default geometric properties are generated from the node
+                // definition of their geometric node.
+                GeomPropDefPtr geomProp = input->getDefaultGeomProp();
+                if (geomProp)
+                {
+                    enqueue(_doc->getNodeDef("ND_" + geomProp->getGeomProp() + "_" + input->getType()));
+                }
+            }
+        }
+        else if (const Implementation* impl = dynamic_cast<const Implementation*>(&elem))
+        {
+            if (impl->hasFile())
+            {
+                _hash.add(_cache.getFileHash(_context.resolveSourceFile(impl->getFile())));
+            }
+        }
+
+        // Include the child count, so that the nesting of elements is
+        // unambiguous.
+        const vector<ElementPtr>& children = elem.getChildren();
+        _hash.add(std::to_string(children.size()));
+        for (const ElementPtr& child : children)
+        {
+            hashTree(*child);
+        }
+    }
+
+  private:
+    const ShaderCache& _cache;
+    GenContext& _context;
+    const string& _target;
+    const string& _language;
+    StableHash& _hash;
+
+    ConstDocumentPtr _doc;
+    vector<ConstElementPtr> _queue;
+    std::unordered_set<const Element*> _visited;
+};
+
+} // anonymous namespace
+
+//
+// ShaderCache methods
+//
+
+ShaderCache::ShaderCache(const FilePath& directory, const string& salt) :
+    _directory(directory),
+    _salt(salt),
+    _memoryHitCount(0),
+    _diskHitCount(0),
+    _missCount(0)
+{
+}
+
+string ShaderCache::getKey(const string& name, ElementPtr element, GenContext& context) const
+{
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    const GenOptions& options = context.getOptions();
+
+    StableHash hash;
+    hash.add(SHADER_CACHE_VERSION);
+    hash.add(getVersionString());
+    hash.add(_salt);
+    hash.add(name);
+    hash.add(shadergen.getLanguage());
+    hash.add(shadergen.getTarget());
+    hash.add(shadergen.getColorManagementSystem() ? shadergen.getColorManagementSystem()->getName() : EMPTY_STRING);
+    hash.add(std::to_string(options.shaderInterfaceType));
+    hash.add(std::to_string(options.fileTextureVerticalFlip));
+    hash.add(options.targetColorSpaceOverride);
+    hash.add(std::to_string(options.hwTransparency));
+    hash.add(std::to_string(options.hwSpecularEnvironmentMethod));
+    hash.add(std::to_string(options.hwMaxActiveLightSources));
+    const FileSearchPath& searchPath = context.getSourceCodeSearchPath();
+    hash.add(std::to_string(searchPath.size()));
+    for (size_t i = 0; i < searchPath.size(); i++)
+    {
+        hash.add(searchPath[i].asString());
+    }
+    hash.add(element->getNamePath());
+    UpstreamGraphHasher(*this, context, hash).hashElement(element);
+    return hash.asString();
+}
+
+ShaderPtr ShaderCache::getShader(const string& name, ElementPtr element, GenContext& context)
+{
+    string key = getKey(name, element, context);
+    ShaderPtr shader = findShader(key);
+    if (shader)
+    {
+        _memoryHitCount++;
+        return shader;
+    }
+    return generateShader(key, name, element, context);
+}
+
+StringMap ShaderCache::getSourceCode(const string& name, ElementPtr element, GenContext& context)
+{
+    string key = getKey(name, element, context);
+    ShaderPtr shader = findShader(key);
+    StringMap sourceCode;
+    if (shader)
+    {
+        _memoryHitCount++;
+    }
+    else
+    {
+        if (readSourceCode(key, sourceCode))
+        {
+            _diskHitCount++;
+            return sourceCode;
+        }
+        shader = generateShader(key, name, element, context);
+    }
+
+    for (size_t i = 0; i < shader->numStages(); i++)
+    {
+        const ShaderStage& stage = shader->getStage(i);
+        sourceCode[stage.getName()] = stage.getSourceCode();
+    }
+    return sourceCode;
+}
+
+string ShaderCache::getFileHash(const FilePath& path) const
+{
+    // File hashes are held along with the contents they were computed from,
+    // so that files are hashed again only when the source file cache
+    // returns new contents.
+    ConstSourceFilePtr sourceFile = readSourceFile(path);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _fileHashes.find(path.asString());
+        if (it != _fileHashes.end() && it->second.first == sourceFile)
+        {
+            return it->second.second;
+        }
+    }
+
+    StableHash hash;
+    hash.add(sourceFile ? sourceFile->getContents() : EMPTY_STRING);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fileHashes[path.asString()] = std::make_pair(sourceFile, hash.asString());
+    return hash.asString();
+}
+
+void ShaderCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _shaders.clear();
+}
+
+ShaderPtr ShaderCache::findShader(const string& key) const
+{
+    CachedShader cachedShader;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _shaders.find(key);
+        if (it == _shaders.end())
+        {
+            return nullptr;
+        }
+        cachedShader = it->second;
+    }
+    return includesMatch(cachedShader.includeHashes) ? cachedShader.shader : nullptr;
+}
+
+ShaderPtr ShaderCache::generateShader(const string& key, const string& name, ElementPtr element, GenContext& context)
+{
+    ShaderPtr shader = context.getShaderGenerator().generate(name, element, context);
+    if (!shader)
+    {
+        return nullptr;
+    }
+
+    // Record the content of every file included into the stages of the
+    // shader, whose include statements are expanded during generation.
+    CachedShader cachedShader;
+    cachedShader.shader = shader;
+    for (size_t i = 0; i < shader->numStages(); i++)
+    {
+        for (const string& include : shader->getStage(i).getIncludes())
+        {
+            cachedShader.includeHashes[include] = getFileHash(include);
+        }
+    }
+    writeSourceCode(key, cachedShader);
+    _missCount++;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _shaders[key] = cachedShader;
+    return shader;
+}
+
+bool ShaderCache::includesMatch(const StringMap& includeHashes) const
+{
+    for (const auto& pair : includeHashes)
+    {
+        if (getFileHash(pair.first) != pair.second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShaderCache::readSourceCode(const string& key, StringMap& sourceCode) const
+{
+    if (_directory.isEmpty())
+    {
+        return false;
+    }
+
+    // Each file holds the number of included files, followed by the path
+    // and content hash of each included file, and then the number of
+    // stages, followed by the name, length and source code of each stage.
+    std::ifstream file((_directory / (key + SHADER_CACHE_EXTENSION)).asString(), std::ios::binary);
+    size_t includeCount = 0;
+    if (!(file >> includeCount) || file.get() != '\n')
+    {
+        return false;
+    }
+    StringMap includeHashes;
+    for (size_t i = 0; i < includeCount; i++)
+    {
+        string path, hash;
+        if (!std::getline(file, path) || !std::getline(file, hash))
+        {
+            return false;
+        }
+        includeHashes[path] = hash;
+    }
+    if (!includesMatch(includeHashes))
+    {
+        return false;
+    }
+    size_t stageCount = 0;
+    if (!(file >> stageCount))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < stageCount; i++)
+    {
+        string stageName;
+        size_t length = 0;
+        if (!(file >> stageName >> length) || file.get() != '\n')
+        {
+            return false;
+        }
+        string source(length, '\0');
+        if (!file.read(&source[0], length))
+        {
+            return false;
+        }
+        sourceCode[stageName] = source;
+    }
+    return true;
+}
+
+void ShaderCache::writeSourceCode(const string& key, const CachedShader& cachedShader) const
+{
+    if (_directory.isEmpty())
+    {
+        return;
+    }
+
+    // Write to a temporary file and then rename it, so that concurrent
+    // processes never read a partially written file.  The temporary file
+    // is never shared by concurrent writers.
+    FilePath path = _directory / (key + SHADER_CACHE_EXTENSION);
+    string tempFilename = path.asString() + getTemporarySuffix();
+    {
+        const Shader& shader = *cachedShader.shader;
+        std::ofstream file(tempFilename, std::ios::binary);
+        file << cachedShader.includeHashes.size() << '\n';
+        for (const auto& pair : cachedShader.includeHashes)
+        {
+            file << pair.first << '\n' << pair.second << '\n';
+        }
+        file << shader.numStages() << '\n';
+        for (size_t i = 0; i < shader.numStages(); i++)
+        {
+            const ShaderStage& stage = shader.getStage(i);
+            file << stage.getName() << '\n' << stage.getSourceCode().size() << '\n';
+            file.write(stage.getSourceCode().data(), stage.getSourceCode().size());
+        }
+        if (!file)
+        {
+            std::remove(tempFilename.c_str());
+            return;
+        }
+    }
+    if (std::rename(tempFilename.c_str(), path.asString().c_str()) != 0)
+    {
+        std::remove(tempFilename.c_str());
+    }
+}
+
+} // namespace MaterialX
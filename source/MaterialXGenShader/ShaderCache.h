@@ -0,0 +1,149 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERCACHE_H
+#define MATERIALX_SHADERCACHE_H
+
+/// @file
+/// Cache of generated shaders
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace MaterialX
+{
+
+class ShaderCache;
+
+/// Shared pointer to a ShaderCache
+using ShaderCachePtr = shared_ptr<ShaderCache>;
+
+/// @class ShaderCache
+/// A cache of generated shaders, keyed by a stable hash of the content that
+/// determines the generated code.
+///
+/// The key of a shader combines its name, the MaterialX library version,
+/// the language and target of the shader generator, the generation options,
+/// color management system, source code search path and bound light shaders
+/// of the context, and the content of the renderable element's upstream
+/// graph.  The upstream graph is gathered from the element's top-level
+/// ancestor, the node definitions and implementations it resolves, the
+/// source files of those implementations, and any top-level elements named
+/// by the attributes of these elements.  Other user data of the context is
+/// not part of the key, so callers that vary such data should provide a
+/// distinct salt for each configuration.
+///
+/// The files included into the stages of a shader are only known once it
+/// has been generated, so a cached shader records the content hash of each
+/// included file, and is generated again if any of them has changed.
+///
+/// Shaders are held in memory, and the source code of their stages may also
+/// be stored in a directory on disk, allowing separate processes to skip
+/// code generation for shaders that have been generated before.
+class ShaderCache
+{
+  public:
+    /// Constructor.
+    /// @param directory An optional directory in which the source code of
+    ///    generated shaders is stored.  If empty, shaders are cached in
+    ///    memory only.
+    /// @param salt An optional string that is combined with every key.
+    ShaderCache(const FilePath& directory = FilePath(), const string& salt = EMPTY_STRING);
+    ~ShaderCache() { }
+
+    /// Create a new shader cache.
+    static ShaderCachePtr create(const FilePath& directory = FilePath(), const string& salt = EMPTY_STRING)
+    {
+        return std::make_shared<ShaderCache>(directory, salt);
+    }
+
+    /// Return the directory in which shader source code is stored.
+    const FilePath& getDirectory() const
+    {
+        return _directory;
+    }
+
+    /// Return the cache key for a shader with the given name, generated from
+    /// the given element in the given context.
+    string getKey(const string& name, ElementPtr element, GenContext& context) const;
+
+    /// Return a shader with the given name for the given element, generating
+    /// it with the shader generator of the context if it is not held in
+    /// memory.  The returned shader is shared by all requests with the same
+    /// key, and should not be modified.
+    ShaderPtr getShader(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the source code of each stage of a shader with the given name
+    /// for the given element, as a map from stage name to source code.  The
+    /// source code is read from the cache directory if the shader is not
+    /// held in memory, and is otherwise generated.
+    StringMap getSourceCode(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return a stable hash of the content of the given source file, as read
+    /// through the source file cache.  Hashes are held in memory until the
+    /// source file cache returns new contents for the file.
+    string getFileHash(const FilePath& path) const;
+
+    /// Remove all shaders held in memory.  Files in the cache directory are
+    /// left in place.
+    void clear();
+
+    /// Return the number of requests that were served from memory.
+    size_t getMemoryHitCount() const
+    {
+        return _memoryHitCount;
+    }
+
+    /// Return the number of requests that were served from the cache
+    /// directory.
+    size_t getDiskHitCount() const
+    {
+        return _diskHitCount;
+    }
+
+    /// Return the number of requests that required code generation.
+    size_t getMissCount() const
+    {
+        return _missCount;
+    }
+
+  protected:
+    // A generated shader, with the content hashes of its included files.
+    struct CachedShader
+    {
+        ShaderPtr shader;
+        StringMap includeHashes;
+    };
+
+    ShaderPtr findShader(const string& key) const;
+    ShaderPtr generateShader(const string& key, const string& name, ElementPtr element, GenContext& context);
+    bool includesMatch(const StringMap& includeHashes) const;
+    bool readSourceCode(const string& key, StringMap& sourceCode) const;
+    void writeSourceCode(const string& key, const CachedShader& cachedShader) const;
+
+  protected:
+    FilePath _directory;
+    string _salt;
+
+    std::unordered_map<string, CachedShader> _shaders;
+    mutable std::unordered_map<string, std::pair<ConstSourceFilePtr, string>> _fileHashes;
+    mutable std::mutex _mutex;
+
+    std::atomic<size_t> _memoryHitCount;
+    std::atomic<size_t> _diskHitCount;
+    std::atomic<size_t> _missCount;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -13,6 +13,10 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <unordered_set>
+
 namespace MaterialX
 {
 
@@ -26,9 +30,95 @@ ShaderGraph::ShaderGraph(const ShaderGraph* parent, const string& name, ConstDoc
 {
 }
 
+namespace
+{
+    // Copy the ports of a node to another node with no ports, recording the
+    // port of the copy that corresponds to each port of the source.
+    void copyPorts(const ShaderNode& source, ShaderNode& dest, std::unordered_map<const ShaderPort*, ShaderPort*>& portMap)
+    {
+        for (const ShaderInput* input : source.getInputs())
+        {
+            ShaderInput* newInput = dest.addInput(input->getName(), input->getType());
+            newInput->setVariable(input->getVariable());
+            newInput->setSemantic(input->getSemantic());
+            newInput->setValue(input->getValue());
+            newInput->setPath(input->getPath());
+            newInput->setFlags(input->getFlags());
+            newInput->setChannels(input->getChannels());
+            portMap[input] = newInput;
+        }
+        for (const ShaderOutput* output : source.getOutputs())
+        {
+            ShaderOutput* newOutput = dest.addOutput(output->getName(), output->getType());
+            newOutput->setVariable(output->getVariable());
+            newOutput->setSemantic(output->getSemantic());
+            newOutput->setValue(output->getValue());
+            newOutput->setPath(output->getPath());
+            newOutput->setFlags(output->getFlags());
+            portMap[output] = newOutput;
+        }
+    }
+
+    // Copy the connections of the inputs of a node to the corresponding
+    // inputs of its copy.
+    void copyConnections(const ShaderNode& source, const std::unordered_map<const ShaderPort*, ShaderPort*>& portMap)
+    {
+        for (const ShaderInput* input : source.getInputs())
+        {
+            if (input->getConnection())
+            {
+                ShaderInput* newInput = static_cast<ShaderInput*>(portMap.at(input));
+                ShaderOutput* newOutput = static_cast<ShaderOutput*>(portMap.at(input->getConnection()));
+                newInput->makeConnection(newOutput);
+            }
+        }
+    }
+}
+
+ShaderGraphPtr ShaderGraph::clone(const ShaderGraph* parent, const string& name, ConstDocumentPtr document) const
+{
+    ShaderGraphPtr graph = std::make_shared<ShaderGraph>(parent, name, document);
+    graph->_classification = _classification;
+    graph->_impl = _impl;
+
+    // Copy the sockets of this graph and the ports of its nodes.
+    std::unordered_map<const ShaderPort*, ShaderPort*> portMap;
+    copyPorts(*this, *graph, portMap);
+    for (const ShaderNode* node : _nodeOrder)
+    {
+        ShaderNodePtr newNode = std::make_shared<ShaderNode>(graph.get(), node->getName());
+        newNode->_nodeString = node->_nodeString;
+        newNode->_classification = node->_classification;
+        newNode->_impl = node->_impl;
+        copyPorts(*node, *newNode, portMap);
+        graph->_nodeMap[node->getName()] = newNode;
+        graph->_nodeOrder.push_back(newNode.get());
+    }
+
+    // Copy connections.
+    copyConnections(*this, portMap);
+    for (const ShaderNode* node : _nodeOrder)
+    {
+        copyConnections(*node, portMap);
+    }
+
+    // Copy pending color transforms.
+    for (const auto& it : _inputColorTransformMap)
+    {
+        graph->_inputColorTransformMap.insert(std::make_pair(static_cast<ShaderInput*>(portMap.at(it.first)), it.second));
+    }
+    for (const auto& it : _outputColorTransformMap)
+    {
+        graph->_outputColorTransformMap.insert(std::make_pair(static_cast<ShaderOutput*>(portMap.at(it.first)), it.second));
+    }
+
+    return graph;
+}
+
 void ShaderGraph::addInputSockets(const InterfaceElement& elem, GenContext& context)
 {
-    for (ValueElementPtr port : elem.getActiveValueElements())
+    ConstActivePortTablePtr activePorts = elem.getActivePortTable();
+    for (ValueElementPtr port : activePorts->getValueElements())
     {
         if (!port->isA<Output>())
         {
@@ -53,7 +143,8 @@ void ShaderGraph::addInputSockets(const InterfaceElement& elem, GenContext& cont
 
 void ShaderGraph::addOutputSockets(const InterfaceElement& elem)
 {
-    for (const OutputPtr& output : elem.getActiveOutputs())
+    ConstActivePortTablePtr activePorts = elem.getActivePortTable();
+    for (const OutputPtr& output : activePorts->getOutputs())
     {
         ShaderGraphOutputSocket* outputSocket = addOutputSocket(output->getName(), TypeDesc::get(output->getType()));
         outputSocket->setChannels(output->getChannels());
@@ -71,31 +162,34 @@ void ShaderGraph::addUpstreamDependencies(const Element& root, ConstMaterialPtr
     // to make connections for BindInputs during traversal below.
     ShaderNode* rootNode = getNode(root.getName());
 
-    std::set<ElementPtr> processedOutputs;
-    for (Edge edge : root.traverseGraph(material))
+    // Early outs are tested on raw elements, so that skipped edges
+    // don't pay for shared pointer copies.
+    std::unordered_set<const Element*> processedOutputs;
+    for (GraphIterator it = root.traverseGraph(material).begin(); it != GraphIterator::end(); ++it)
     {
-        ElementPtr upstreamElement = edge.getUpstreamElement();
-        if (!upstreamElement)
+        if (!it.getUpstreamElementRaw())
         {
             continue;
         }
 
-        ElementPtr downstreamElement = edge.getDownstreamElement();
-
         // Early out if downstream element is an output that
         // we have already processed. This might happen since
         // we perform jumps over output elements below.
-        if (processedOutputs.count(downstreamElement))
+        if (processedOutputs.count(it.getDownstreamElementRaw()))
         {
             continue;
         }
 
+        Edge edge = *it;
+        ElementPtr upstreamElement = edge.getUpstreamElement();
+        ElementPtr downstreamElement = edge.getDownstreamElement();
+
         // If upstream is an output jump to the actual node connected to the output.
         if (upstreamElement->isA<Output>())
         {
             // Record this output so we don't process it again when it
             // shows up as a downstream element in the next iteration.
-            processedOutputs.insert(upstreamElement);
+            processedOutputs.insert(upstreamElement.get());
 
             upstreamElement = upstreamElement->asA<Output>()->getConnectedNode();
             if (!upstreamElement)
@@ -320,7 +414,8 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& n
     graph->addOutputSockets(nodeGraph);
 
     // Traverse all outputs and create all upstream dependencies
-    for (OutputPtr graphOutput : nodeGraph.getActiveOutputs())
+    ConstActivePortTablePtr activePorts = nodeGraph.getActivePortTable();
+    for (OutputPtr graphOutput : activePorts->getOutputs())
     {
         graph->addUpstreamDependencies(*graphOutput, nullptr, context);
     }
@@ -395,122 +490,62 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const string& name
             throw ExceptionShaderGenError("Could not find a nodedef for shader '" + shaderRef->getName() + "'");
         }
 
-        graph = std::make_shared<ShaderGraph>(parent, name, element->getDocument());
-
-        // Create input sockets
-        graph->addInputSockets(*nodeDef, context);
-
-        // Create output sockets
-        graph->addOutputSockets(*nodeDef);
-
-        // Create this shader node in the graph.
-        const string& newNodeName = shaderRef->getName();
-        ShaderNodePtr newNode = ShaderNode::create(graph.get(), newNodeName, *nodeDef, context);
-        graph->_nodeMap[newNodeName] = newNode;
-        graph->_nodeOrder.push_back(newNode.get());
-
-        // Connect it to the graph output
-        ShaderGraphOutputSocket* outputSocket = graph->getOutputSocket();
-        outputSocket->makeConnection(newNode->getOutput());
-
-        // Handle node parameters
-        for (ParameterPtr elem : nodeDef->getActiveParameters())
+        // The structure of the graph depends only on the nodedef, unless
+        // the shaderref connects inputs to nodegraph outputs, so shaderrefs
+        // that bind only values share a template that is built once for each
+        // nodedef, and copied for each shaderref.
+        bool hasConnections = false;
+        for (BindInputPtr bindInput : shaderRef->getBindInputs())
         {
-            ShaderGraphInputSocket* inputSocket = graph->getInputSocket(elem->getName());
-            ShaderInput* input = newNode->getInput(elem->getName());
-            if (!inputSocket || !input)
+            if (!bindInput->getOutputString().empty())
             {
-                throw ExceptionShaderGenError("Shader parameter '" + elem->getName() + "' doesn't match an existing input on graph '" + graph->getName() + "'");
+                hasConnections = true;
+                break;
             }
-
-            BindParamPtr bindParam = shaderRef->getBindParam(elem->getName());
-            if (bindParam)
-            {
-                // Copy value from binding
-                if (!bindParam->getValueString().empty())
-                {
-                    inputSocket->setValue(bindParam->getValue());
-                }
-                inputSocket->setPath(bindParam->getNamePath());
-                input->setPath(inputSocket->getPath());
-            }
-
-            // Connect to the graph input
-            inputSocket->makeConnection(input);
         }
-
-        // Handle node inputs
-        for (const InputPtr& nodeDefInput : nodeDef->getActiveInputs())
+        if (hasConnections)
         {
-            ShaderGraphInputSocket* inputSocket = graph->getInputSocket(nodeDefInput->getName());
-            ShaderInput* input = newNode->getInput(nodeDefInput->getName());
-            if (!inputSocket || !input)
-            {
-                throw ExceptionShaderGenError("Shader input '" + nodeDefInput->getName() + "' doesn't match an existing input on graph '" + graph->getName() + "'");
-            }
-
-            BindInputPtr bindInput = shaderRef->getBindInput(nodeDefInput->getName());
-
-            if (bindInput)
+            graph = std::make_shared<ShaderGraph>(parent, name, element->getDocument());
+            graph->addShaderNode(*nodeDef, shaderRef->getName(), shaderRef, context);
+        }
+        else
+        {
+            // Templates are keyed by nodedef, and the context only returns
+            // a template built from the same document, at its current
+            // nodedef revision and with the current generation options.
+            ConstDocumentPtr document = element->getDocument();
+            const string templateKey = ShaderRef::CATEGORY + ":" + nodeDef->getName();
+            ConstShaderGraphPtr graphTemplate = context.findShaderGraphTemplate(templateKey, document);
+            if (!graphTemplate)
             {
-                // Copy value from binding
-                if (!bindInput->getValueString().empty())
-                {
-                    inputSocket->setValue(bindInput->getValue());
-                }
-                inputSocket->setPath(bindInput->getNamePath());
-                input->setPath(inputSocket->getPath());
+                ShaderGraphPtr newTemplate = std::make_shared<ShaderGraph>(nullptr, templateKey, document);
+                newTemplate->addShaderNode(*nodeDef, nodeDef->getName(), nullptr, context);
+
+                // The cached template does not hold its document, which is
+                // given to each clone instead.
+                newTemplate->_document = nullptr;
+                context.addShaderGraphTemplate(templateKey, document, newTemplate);
+                graphTemplate = newTemplate;
             }
+            graph = graphTemplate->clone(parent, name, document);
 
-            // If no explicit connection, connect to geometric node if a geomprop is used
-            // or otherwise to the graph interface.
-            const string& connection = bindInput ? bindInput->getOutputString() : EMPTY_STRING;
-            if (connection.empty())
+            // Move aside any template node, such as a default geometric
+            // node, whose name is taken by the shaderref.
+            const string& nodeName = shaderRef->getName();
+            if (nodeName != nodeDef->getName() && graph->getNode(nodeName))
             {
-                GeomPropDefPtr geomprop = nodeDefInput->getDefaultGeomProp();
-                if (geomprop)
+                string uniqueName = nodeName;
+                for (size_t i = 1; graph->getNode(uniqueName); i++)
                 {
-                    graph->addDefaultGeomNode(input, *geomprop, context);
-                }
-                else
-                {
-                    inputSocket->makeConnection(input);
+                    uniqueName = nodeName + std::to_string(i);
                 }
+                graph->renameNode(nodeName, uniqueName);
             }
+            graph->renameNode(nodeDef->getName(), nodeName);
         }
 
-        // Add shareRef nodedef paths
-        const string& nodePath = shaderRef->getNamePath();
-        for (const ValueElementPtr& nodeInput : nodeDef->getActiveInputs())
-        {
-            const string& inputName = nodeInput->getName();
-            const string path = nodePath + NAME_PATH_SEPARATOR + inputName;
-            ShaderInput* input = newNode->getInput(inputName);
-            if (input && input->getPath().empty())
-            {
-                input->setPath(path);
-            }
-            ShaderGraphInputSocket* inputSocket = graph->getInputSocket(inputName);
-            if (inputSocket && inputSocket->getPath().empty())
-            {
-                inputSocket->setPath(path);
-            }
-        }
-        for (const ParameterPtr& nodeParameter : nodeDef->getActiveParameters())
-        {
-            const string& paramName = nodeParameter->getName();
-            const string path = nodePath + NAME_PATH_SEPARATOR + paramName;
-            ShaderInput* input = newNode->getInput(paramName);
-            if (input && input->getPath().empty())
-            {
-                input->setPath(path);
-            }
-            ShaderGraphInputSocket* inputSocket = graph->getInputSocket(paramName);
-            if (inputSocket && inputSocket->getPath().empty())
-            {
-                inputSocket->setPath(path);
-            }
-        }
+        // Apply values and paths from the shaderref bindings.
+        graph->addShaderRefBindings(*shaderRef, *nodeDef);
 
         // Start traversal from this shaderref and material
         root = shaderRef;
@@ -534,6 +569,165 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const string& name
     return graph;
 }
 
+void ShaderGraph::addShaderNode(const NodeDef& nodeDef, const string& nodeName, ConstShaderRefPtr shaderRef, GenContext& context)
+{
+    // Create input sockets
+    addInputSockets(nodeDef, context);
+
+    // Create output sockets
+    addOutputSockets(nodeDef);
+
+    // Create this shader node in the graph.
+    ShaderNodePtr newNode = ShaderNode::create(this, nodeName, nodeDef, context);
+    _nodeMap[nodeName] = newNode;
+    _nodeOrder.push_back(newNode.get());
+
+    // Connect it to the graph output
+    ShaderGraphOutputSocket* outputSocket = getOutputSocket();
+    outputSocket->makeConnection(newNode->getOutput());
+
+    // Handle node parameters
+    ConstActivePortTablePtr activePorts = nodeDef.getActivePortTable();
+    for (ParameterPtr elem : activePorts->getParameters())
+    {
+        ShaderGraphInputSocket* inputSocket = getInputSocket(elem->getName());
+        ShaderInput* input = newNode->getInput(elem->getName());
+        if (!inputSocket || !input)
+        {
+            throw ExceptionShaderGenError("Shader parameter '" + elem->getName() + "' doesn't match an existing input on graph '" + getName() + "'");
+        }
+
+        // Connect to the graph input
+        inputSocket->makeConnection(input);
+    }
+
+    // Handle node inputs
+    for (const InputPtr& nodeDefInput : activePorts->getInputs())
+    {
+        ShaderGraphInputSocket* inputSocket = getInputSocket(nodeDefInput->getName());
+        ShaderInput* input = newNode->getInput(nodeDefInput->getName());
+        if (!inputSocket || !input)
+        {
+            throw ExceptionShaderGenError("Shader input '" + nodeDefInput->getName() + "' doesn't match an existing input on graph '" + getName() + "'");
+        }
+
+        // If no explicit connection, connect to geometric node if a geomprop is used
+        // or otherwise to the graph interface.
+        BindInputPtr bindInput = shaderRef ? shaderRef->getBindInput(nodeDefInput->getName()) : nullptr;
+        const string& connection = bindInput ? bindInput->getOutputString() : EMPTY_STRING;
+        if (connection.empty())
+        {
+            GeomPropDefPtr geomprop = nodeDefInput->getDefaultGeomProp();
+            if (geomprop)
+            {
+                addDefaultGeomNode(input, *geomprop, context);
+            }
+            else
+            {
+                inputSocket->makeConnection(input);
+            }
+        }
+    }
+}
+
+void ShaderGraph::addShaderRefBindings(const ShaderRef& shaderRef, const NodeDef& nodeDef)
+{
+    ShaderNode* node = getNode(shaderRef.getName());
+    if (!node)
+    {
+        throw ExceptionShaderGenError("Could not find a node for shader '" + shaderRef.getName() + "'");
+    }
+
+    // Handle node parameters
+    ConstActivePortTablePtr activePorts = nodeDef.getActivePortTable();
+    for (ParameterPtr elem : activePorts->getParameters())
+    {
+        BindParamPtr bindParam = shaderRef.getBindParam(elem->getName());
+        if (bindParam)
+        {
+            ShaderGraphInputSocket* inputSocket = getInputSocket(elem->getName());
+            ShaderInput* input = node->getInput(elem->getName());
+
+            // Copy value from binding
+            if (!bindParam->getValueString().empty())
+            {
+                inputSocket->setValue(bindParam->getValue());
+            }
+            inputSocket->setPath(bindParam->getNamePath());
+            input->setPath(inputSocket->getPath());
+        }
+    }
+
+    // Handle node inputs
+    for (const InputPtr& nodeDefInput : activePorts->getInputs())
+    {
+        BindInputPtr bindInput = shaderRef.getBindInput(nodeDefInput->getName());
+        if (bindInput)
+        {
+            ShaderGraphInputSocket* inputSocket = getInputSocket(nodeDefInput->getName());
+            ShaderInput* input = node->getInput(nodeDefInput->getName());
+
+            // Copy value from binding
+            if (!bindInput->getValueString().empty())
+            {
+                inputSocket->setValue(bindInput->getValue());
+            }
+            inputSocket->setPath(bindInput->getNamePath());
+            input->setPath(inputSocket->getPath());
+        }
+    }
+
+    // Add shareRef nodedef paths
+    const string& nodePath = shaderRef.getNamePath();
+    for (const InputPtr& nodeInput : activePorts->getInputs())
+    {
+        const string& inputName = nodeInput->getName();
+        const string path = nodePath + NAME_PATH_SEPARATOR + inputName;
+        ShaderInput* input = node->getInput(inputName);
+        if (input && input->getPath().empty())
+        {
+            input->setPath(path);
+        }
+        ShaderGraphInputSocket* inputSocket = getInputSocket(inputName);
+        if (inputSocket && inputSocket->getPath().empty())
+        {
+            inputSocket->setPath(path);
+        }
+    }
+    for (const ParameterPtr& nodeParameter : activePorts->getParameters())
+    {
+        const string& paramName = nodeParameter->getName();
+        const string path = nodePath + NAME_PATH_SEPARATOR + paramName;
+        ShaderInput* input = node->getInput(paramName);
+        if (input && input->getPath().empty())
+        {
+            input->setPath(path);
+        }
+        ShaderGraphInputSocket* inputSocket = getInputSocket(paramName);
+        if (inputSocket && inputSocket->getPath().empty())
+        {
+            inputSocket->setPath(path);
+        }
+    }
+}
+
+void ShaderGraph::renameNode(const string& name, const string& newName)
+{
+    auto it = _nodeMap.find(name);
+    if (it == _nodeMap.end() || name == newName)
+    {
+        return;
+    }
+    if (_nodeMap.count(newName))
+    {
+        throw ExceptionShaderGenError("Node name '" + newName + "' is already in use in graph '" + getName() + "'");
+    }
+    ShaderNodePtr node = it->second;
+    _nodeMap.erase(it);
+    node->_name = newName;
+    _nodeMap[newName] = node;
+}
+
 ShaderNode* ShaderGraph::addNode(const Node& node, GenContext& context)
 {
     NodeDefPtr nodeDef = node.getNodeDef();
@@ -578,7 +772,8 @@ ShaderNode* ShaderGraph::addNode(const Node& node, GenContext& context)
 
     // Handle the "defaultgeomprop" directives on the nodedef inputs.
     // Create and connect default geometric nodes on unconnected inputs.
-    for (const InputPtr& nodeDefInput : nodeDef->getActiveInputs())
+    ConstActivePortTablePtr activePorts = nodeDef->getActivePortTable();
+    for (const InputPtr& nodeDefInput : activePorts->getInputs())
     {
         ShaderInput* input = newNode->getInput(nodeDefInput->getName());
         InputPtr nodeInput = node.getInput(nodeDefInput->getName());
@@ -764,6 +959,265 @@ void ShaderGraph::disconnect(ShaderNode* node) const
     }
 }
 
+namespace
+{
+    // Return the components of a float, color or vector value.
+    template <class T> bool getComponents(const Value& value, vector<float>& components)
+    {
+        if (!value.isA<T>())
+        {
+            return false;
+        }
+        const T& data = value.asA<T>();
+        components.assign(data.begin(), data.end());
+        return true;
+    }
+
+    bool getComponents(const Value& value, vector<float>& components)
+    {
+        if (value.isA<float>())
+        {
+            components.assign(1, value.asA<float>());
+            return true;
+        }
+        return getComponents<Color2>(value, components) ||
+               getComponents<Color3>(value, components) ||
+               getComponents<Color4>(value, components) ||
+               getComponents<Vector2>(value, components) ||
+               getComponents<Vector3>(value, components) ||
+               getComponents<Vector4>(value, components);
+    }
+
+    // Create a value of the given float, color or vector type from its components.
+    ValuePtr createValue(const TypeDesc* type, const vector<float>& components)
+    {
+        if (type == Type::FLOAT)
+        {
+            return Value::createValue(components[0]);
+        }
+        if (type == Type::COLOR2)
+        {
+            return Value::createValue(Color2(components));
+        }
+        if (type == Type::COLOR3)
+        {
+            return Value::createValue(Color3(components));
+        }
+        if (type == Type::COLOR4)
+        {
+            return Value::createValue(Color4(components));
+        }
+        if (type == Type::VECTOR2)
+        {
+            return Value::createValue(Vector2(components));
+        }
+        if (type == Type::VECTOR3)
+        {
+            return Value::createValue(Vector3(components));
+        }
+        if (type == Type::VECTOR4)
+        {
+            return Value::createValue(Vector4(components));
+        }
+        return nullptr;
+    }
+
+    // Return the value of an input that has no upstream connection,
+    // or nullptr if the input is connected or has no value.
+    ValuePtr getConstantValue(const ShaderNode& node, const string& inputName)
+    {
+        const ShaderInput* input = node.getInput(inputName);
+        if (!input || input->getConnection())
+        {
+            return nullptr;
+        }
+        return input->getValue();
+    }
+
+    // Evaluate a standard library math node whose inputs are all constant,
+    // returning the value of its output, or nullptr if the node cannot be
+    // evaluated.
+    ValuePtr evaluateConstantNode(const ShaderNode& node)
+    {
+        const string& nodeString = node.getNodeString();
+        const ShaderOutput* output = node.getOutput();
+        const TypeDesc* type = output->getType();
+
+        if (nodeString == "swizzle")
+        {
+            ValuePtr in = getConstantValue(node, "in");
+            ValuePtr channels = getConstantValue(node, "channels");
+            vector<float> components;
+            if (!in || !channels || !getComponents(*in, components))
+            {
+                return nullptr;
+            }
+            const TypeDesc* inType = node.getInput("in")->getType();
+            const string& pattern = channels->getValueString();
+            if (pattern.size() != type->getSize())
+            {
+                return nullptr;
+            }
+            vector<float> result;
+            for (char channel : pattern)
+            {
+                if (channel == '0' || channel == '1')
+                {
+                    result.push_back(channel == '1' ? 1.0f : 0.0f);
+                    continue;
+                }
+                const int channelIndex = components.size() == 1 ? 0 : inType->getChannelIndex(channel);
+                if (channelIndex < 0 || channelIndex >= (int) components.size())
+                {
+                    return nullptr;
+                }
+                result.push_back(components[channelIndex]);
+            }
+            return createValue(type, result);
+        }
+
+        StringVec inputNames;
+        if (nodeString == "add" || nodeString == "subtract" || nodeString == "multiply" ||
+            nodeString == "divide" || nodeString == "min" || nodeString == "max")
+        {
+            inputNames = { "in1", "in2" };
+        }
+        else if (nodeString == "mix")
+        {
+            inputNames = { "fg", "bg", "mix" };
+        }
+        else
+        {
+            return nullptr;
+        }
+
+        // Gather the components of each input, broadcasting scalar inputs
+        // to the size of the output.
+        const size_t size = type->getSize();
+        vector<vector<float>> args;
+        for (const string& inputName : inputNames)
+        {
+            ValuePtr value = getConstantValue(node, inputName);
+            vector<float> components;
+            if (!value || !getComponents(*value, components))
+            {
+                return nullptr;
+            }
+            if (components.size() == 1)
+            {
+                components.resize(size, components[0]);
+            }
+            if (components.size() != size)
+            {
+                return nullptr;
+            }
+            args.push_back(components);
+        }
+
+        vector<float> result(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            const float a = args[0][i];
+            const float b = args[1][i];
+            if (nodeString == "add")
+            {
+                result[i] = a + b;
+            }
+            else if (nodeString == "subtract")
+            {
+                result[i] = a - b;
+            }
+            else if (nodeString == "multiply")
+            {
+                result[i] = a * b;
+            }
+            else if (nodeString == "divide")
+            {
+                // Division by zero is left to the target language.
+                if (b == 0.0f)
+                {
+                    return nullptr;
+                }
+                result[i] = a / b;
+            }
+            else if (nodeString == "min")
+            {
+                result[i] = std::min(a, b);
+            }
+            else if (nodeString == "max")
+            {
+                result[i] = std::max(a, b);
+            }
+            else
+            {
+                const float m = args[2][i];
+                result[i] = b * (1.0f - m) + a * m;
+            }
+        }
+        return createValue(type, result);
+    }
+
+    // Append a string to a key, terminated so that adjacent strings are unambiguous.
+    void appendKey(string& key, const string& str)
+    {
+        key += str;
+        key += '\n';
+    }
+
+    // Return a key identifying the computation of a node, so that nodes with
+    // equal keys compute equal values.  An empty key is returned for nodes
+    // that should not be merged.
+    string getValueNumberKey(const ShaderNode& node, bool reducedInterface)
+    {
+        if (node.hasClassification(ShaderNode::Classification::DO_NOT_OPTIMIZE) ||
+            node.hasClassification(ShaderNode::Classification::CLOSURE) ||
+            node.hasClassification(ShaderNode::Classification::SHADER))
+        {
+            return EMPTY_STRING;
+        }
+
+        // Skip nodes that are no longer in use.
+        bool used = false;
+        for (const ShaderOutput* output : node.getOutputs())
+        {
+            used = used || !output->getConnections().empty();
+        }
+        if (!used)
+        {
+            return EMPTY_STRING;
+        }
+
+        string key;
+        appendKey(key, std::to_string(reinterpret_cast<uintptr_t>(&node.getImplementation())));
+        for (const ShaderInput* input : node.getInputs())
+        {
+            appendKey(key, input->getName());
+            appendKey(key, input->getType()->getName());
+            appendKey(key, input->getChannels());
+            if (input->getConnection())
+            {
+                appendKey(key, std::to_string(reinterpret_cast<uintptr_t>(input->getConnection())));
+            }
+            else if (reducedInterface || !input->getType()->isEditable() || !node.isEditable(*input))
+            {
+                appendKey(key, input->getValue() ? input->getValue()->getValueString() : EMPTY_STRING);
+            }
+            else
+            {
+                // Unconnected inputs are published as separate uniforms
+                // with the complete shader interface.
+                return EMPTY_STRING;
+            }
+        }
+        for (const ShaderOutput* output : node.getOutputs())
+        {
+            appendKey(key, output->getName());
+            appendKey(key, output->getType()->getName());
+        }
+        return key;
+    }
+}
+
 void ShaderGraph::optimize(GenContext& context)
 {
     size_t numEdits = 0;
@@ -819,6 +1273,16 @@ void ShaderGraph::optimize(GenContext& context)
         }
     }
 
+    // Unconnected inputs are published as uniforms with the complete shader
+    // interface, so constant folding is only done with the reduced interface,
+    // where these inputs are emitted as literals.
+    const bool reducedInterface = context.getOptions().shaderInterfaceType == SHADER_INTERFACE_REDUCED;
+    if (reducedInterface)
+    {
+        numEdits += foldConstants(context);
+    }
+    numEdits += mergeDuplicateNodes(reducedInterface);
+
     if (numEdits > 0)
     {
         std::set<ShaderNode*> usedNodes;
@@ -835,7 +1299,10 @@ void ShaderGraph::optimize(GenContext& context)
             }
         }
 
-        // Remove any unused nodes
+        // Remove any unused nodes, keeping the remaining nodes in their
+        // original order so that generated code is deterministic.
+        vector<ShaderNode*> usedNodeOrder;
+        usedNodeOrder.reserve(usedNodes.size());
         for (ShaderNode* node : _nodeOrder)
         {
             if (usedNodes.count(node) == 0)
@@ -846,10 +1313,13 @@ void ShaderGraph::optimize(GenContext& context)
                 // Erase from storage
                 _nodeMap.erase(node->getName());
             }
+            else
+            {
+                usedNodeOrder.push_back(node);
+            }
         }
 
-        _nodeOrder.resize(usedNodes.size());
-        _nodeOrder.assign(usedNodes.begin(), usedNodes.end());
+        _nodeOrder = usedNodeOrder;
     }
 }
 
@@ -875,29 +1345,111 @@ void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputInde
     {
         // No node connected upstream to re-route,
         // so push the input's value and element path downstream instead.
-        // Iterate a copy of the connection set since the
-        // original set will change when breaking connections.
-        ShaderInputSet downstreamConnections = output->getConnections();
-        for (ShaderInput* downstream : downstreamConnections)
+        for (ShaderInput* downstream : output->getConnections())
         {
-            output->breakConnection(downstream);
-            downstream->setValue(input->getValue());
             downstream->setPath(input->getPath());
+        }
+        setDownstreamValue(context, output, input->getValue(), input->getType());
+    }
+}
+
+void ShaderGraph::setDownstreamValue(GenContext& context, ShaderOutput* output, ValuePtr value, const TypeDesc* valueType)
+{
+    // Iterate a copy of the connection set since the
+    // original set will change when breaking connections.
+    ShaderInputSet downstreamConnections = output->getConnections();
+    for (ShaderInput* downstream : downstreamConnections)
+    {
+        output->breakConnection(downstream);
+        downstream->setValue(value);
+
+        // Swizzle the value. Once done clear the channel to indicate
+        // no further swizzling is reqiured.
+        const string& channels = downstream->getChannels();
+        if (!channels.empty())
+        {
+            downstream->setValue(context.getShaderGenerator().getSyntax().getSwizzledValue(value,
+                                                                                      valueType,
+                                                                                      channels,
+                                                                                      downstream->getType()));
+            downstream->setType(downstream->getType());
+            downstream->setChannels(EMPTY_STRING);
+        }
+    }
+}
+
+size_t ShaderGraph::foldConstants(GenContext& context)
+{
+    // Folding a node may make its downstream nodes constant,
+    // so repeat until no more nodes can be folded.
+    size_t numFolded = 0;
+    bool folded = true;
+    while (folded)
+    {
+        folded = false;
+        for (ShaderNode* node : _nodeOrder)
+        {
+            if (node->hasClassification(ShaderNode::Classification::DO_NOT_OPTIMIZE) ||
+                node->numOutputs() != 1 ||
+                node->getOutput()->getConnections().empty())
+            {
+                continue;
+            }
+            ValuePtr value = evaluateConstantNode(*node);
+            if (value)
+            {
+                setDownstreamValue(context, node->getOutput(), value, node->getOutput()->getType());
+                ++numFolded;
+                folded = true;
+            }
+        }
+    }
+    return numFolded;
+}
+
+size_t ShaderGraph::mergeDuplicateNodes(bool reducedInterface)
+{
+    // Merging nodes may make their downstream nodes identical,
+    // so repeat until no more nodes can be merged.
+    size_t numMerged = 0;
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        std::unordered_map<string, ShaderNode*> canonicalNodes;
+        for (ShaderNode* node : _nodeOrder)
+        {
+            const string key = getValueNumberKey(*node, reducedInterface);
+            if (key.empty())
+            {
+                continue;
+            }
+            auto it = canonicalNodes.find(key);
+            if (it == canonicalNodes.end())
+            {
+                canonicalNodes[key] = node;
+                continue;
+            }
 
-            // Swizzle the input value. Once done clear the channel to indicate
-            // no further swizzling is reqiured.
-            const string& channels = downstream->getChannels();
-            if (!channels.empty())
+            // Re-route the downstream connections of this node
+            // to the first node computing the same value.
+            ShaderNode* canonicalNode = it->second;
+            for (size_t i = 0; i < node->numOutputs(); ++i)
             {
-                downstream->setValue(context.getShaderGenerator().getSyntax().getSwizzledValue(input->getValue(),
-                                                                                          input->getType(), 
-                                                                                          channels,
-                                                                                          downstream->getType()));
-                downstream->setType(downstream->getType());
-                downstream->setChannels(EMPTY_STRING);
+                ShaderOutput* output = node->getOutput(i);
+                ShaderOutput* canonicalOutput = canonicalNode->getOutput(i);
+                ShaderInputSet downstreamConnections = output->getConnections();
+                for (ShaderInput* downstream : downstreamConnections)
+                {
+                    output->breakConnection(downstream);
+                    downstream->makeConnection(canonicalOutput);
+                }
             }
+            ++numMerged;
+            merged = true;
         }
     }
+    return numMerged;
 }
 
 void ShaderGraph::topologicalSort()
@@ -907,12 +1459,25 @@ void ShaderGraph::topologicalSort()
     //
     // Running time: O(numNodes + numEdges).
 
+    // Nodes that become ready at the same time are visited in their current
+    // order, rather than the pointer order of their connections, so that the
+    // generated code is deterministic.
+    std::unordered_map<ShaderNode*, size_t> nodeIndex(_nodeOrder.size());
+    for (size_t i = 0; i < _nodeOrder.size(); ++i)
+    {
+        nodeIndex[_nodeOrder[i]] = i;
+    }
+    auto compareIndex = [&nodeIndex](ShaderNode* a, ShaderNode* b)
+    {
+        return nodeIndex[a] < nodeIndex[b];
+    };
+
     // Calculate in-degrees for all nodes, and enqueue those with degree 0.
     std::unordered_map<ShaderNode*, int> inDegree(_nodeMap.size());
     std::deque<ShaderNode*> nodeQueue;
-    for (auto it : _nodeMap)
+    const vector<ShaderNode*> currentOrder = _nodeOrder;
+    for (ShaderNode* node : currentOrder)
     {
-        ShaderNode* node = it.second.get();
 
         int connectionCount = 0;
         for (const ShaderInput* input : node->getInputs())
@@ -934,6 +1499,7 @@ void ShaderGraph::topologicalSort()
     _nodeOrder.resize(_nodeMap.size(), nullptr);
     size_t count = 0;
 
+    vector<ShaderNode*> readyNodes;
     while (!nodeQueue.empty())
     {
         // Pop the queue and add to topological order.
@@ -943,6 +1509,7 @@ void ShaderGraph::topologicalSort()
 
         // Find connected nodes and decrease their in-degree,
         // adding node to the queue if in-degrees becomes 0.
+        readyNodes.clear();
         for (auto output : node->getOutputs())
         {
             for (auto input : output->getConnections())
@@ -951,11 +1518,13 @@ void ShaderGraph::topologicalSort()
                 {
                     if (--inDegree[input->getNode()] <= 0)
                     {
-                        nodeQueue.push_back(input->getNode());
+                        readyNodes.push_back(input->getNode());
                     }
                 }
             }
         }
+        std::sort(readyNodes.begin(), readyNodes.end(), compareIndex);
+        nodeQueue.insert(nodeQueue.end(), readyNodes.begin(), readyNodes.end());
     }
 
     // Check if there was a cycle.
@@ -34,9 +34,6 @@ using ShaderGraphInputSocket = ShaderOutput;
 /// used for connecting internal nodes to the outside
 using ShaderGraphOutputSocket = ShaderInput;
 
-/// A shared pointer to a shader graph
-using ShaderGraphPtr = shared_ptr<class ShaderGraph>;
-
 /// @class ShaderGraph
 /// Class representing a graph (DAG) for shader generation
 class ShaderGraph : public ShaderNode
@@ -57,6 +54,13 @@ class ShaderGraph : public ShaderNode
     static ShaderGraphPtr create(const ShaderGraph* parent, const NodeGraph& nodeGraph,
                                  GenContext& context);
 
+    /// Create a copy of this graph with the given parent, name and document.
+    /// The copy holds new nodes, ports and connections matching those of this
+    /// graph, and shares their values and implementations.  State that is
+    /// computed when a graph is finalized is not copied, so this should only
+    /// be called on graphs that have not been finalized.
+    ShaderGraphPtr clone(const ShaderGraph* parent, const string& name, ConstDocumentPtr document) const;
+
     /// Return true if this node is a graph.
     bool isAGraph() const override { return true; }
 
@@ -113,6 +117,19 @@ class ShaderGraph : public ShaderNode
     /// bind input elements in the traversal.
     void addUpstreamDependencies(const Element& root, ConstMaterialPtr material, GenContext& context);
 
+    /// Add sockets from the given nodedef, and a node of the given name that
+    /// instantiates the nodedef, connected to these sockets.  Inputs that are
+    /// connected to nodegraph outputs by the given shaderref, if any, are left
+    /// unconnected.
+    void addShaderNode(const NodeDef& nodeDef, const string& nodeName, ConstShaderRefPtr shaderRef, GenContext& context);
+
+    /// Apply the bound values and element paths of a shaderref to its node and
+    /// to the corresponding sockets.
+    void addShaderRefBindings(const ShaderRef& shaderRef, const NodeDef& nodeDef);
+
+    /// Rename an internal node.
+    void renameNode(const string& name, const string& newName);
+
     /// Add a default geometric node and connect to the given input.
     void addDefaultGeomNode(ShaderInput* input, const GeomPropDef& geomprop, GenContext& context);
 
@@ -133,6 +150,20 @@ class ShaderGraph : public ShaderNode
     /// with the output's downstream connections.
     void bypass(GenContext& context, ShaderNode* node, size_t inputIndex, size_t outputIndex = 0);
 
+    /// Assign a value to all inputs connected downstream of an output,
+    /// breaking their connections and applying any channel swizzles.
+    void setDownstreamValue(GenContext& context, ShaderOutput* output, ValuePtr value, const TypeDesc* valueType);
+
+    /// Evaluate standard library math nodes whose inputs are all constant,
+    /// assigning their values downstream.
+    /// Returns the number of nodes folded.
+    size_t foldConstants(GenContext& context);
+
+    /// Merge nodes that compute the same value from the same inputs,
+    /// routing all downstream connections to a single node.
+    /// Returns the number of nodes merged.
+    size_t mergeDuplicateNodes(bool reducedInterface);
+
     /// Sort the nodes in topological order.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
     void topologicalSort();
@@ -186,6 +186,7 @@ void ShaderNode::ScopeInfo::merge(const ScopeInfo &fromScope)
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, const NodeDef& nodeDef, GenContext& context)
 {
     ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    newNode->_nodeString = nodeDef.getNodeString();
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
@@ -221,7 +222,8 @@ ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name,
     }
 
     // Create interface from nodedef
-    for (const ValueElementPtr& port : nodeDef.getActiveValueElements())
+    ConstActivePortTablePtr activePorts = nodeDef.getActivePortTable();
+    for (const ValueElementPtr& port : activePorts->getValueElements())
     {
         const TypeDesc* portType = TypeDesc::get(port->getType());
         if (port->isA<Output>())
@@ -342,7 +344,8 @@ ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name,
 void ShaderNode::setPaths(const Node& node, const NodeDef& nodeDef, bool includeNodeDefInputs)
 {
     // Set element paths for children on the node
-    for (const ValueElementPtr& nodeValue : node.getActiveValueElements())
+    ConstActivePortTablePtr nodePorts = node.getActivePortTable();
+    for (const ValueElementPtr& nodeValue : nodePorts->getValueElements())
     {
         ShaderInput* input = getInput(nodeValue->getName());
         if (input)
@@ -361,7 +364,8 @@ void ShaderNode::setPaths(const Node& node, const NodeDef& nodeDef, bool include
     // are no inputs/parameters specified on the node itself
     //
     const string& nodePath = node.getNamePath();
-    for (const ValueElementPtr& nodeInput : nodeDef.getActiveInputs())
+    ConstActivePortTablePtr nodeDefPorts = nodeDef.getActivePortTable();
+    for (const InputPtr& nodeInput : nodeDefPorts->getInputs())
     {
         ShaderInput* input = getInput(nodeInput->getName());
         if (input && input->getPath().empty())
@@ -370,7 +374,7 @@ void ShaderNode::setPaths(const Node& node, const NodeDef& nodeDef, bool include
         }
     }
 
-    for (const ParameterPtr& nodeParameter : nodeDef.getActiveParameters())
+    for (const ParameterPtr& nodeParameter : nodeDefPorts->getParameters())
     {
         ShaderInput* input = getInput(nodeParameter->getName());
         if (input && input->getPath().empty())
@@ -383,7 +387,8 @@ void ShaderNode::setPaths(const Node& node, const NodeDef& nodeDef, bool include
 void ShaderNode::setValues(const Node& node, const NodeDef& nodeDef, GenContext& context)
 {
     // Copy input values from the given node
-    for (const ValueElementPtr& nodeValue : node.getActiveValueElements())
+    ConstActivePortTablePtr activePorts = node.getActivePortTable();
+    for (const ValueElementPtr& nodeValue : activePorts->getValueElements())
     {
         ShaderInput* input = getInput(nodeValue->getName());
         ValueElementPtr nodeDefInput = nodeDef.getActiveValueElement(nodeValue->getName());
@@ -308,6 +308,13 @@ class ShaderNode
         return _name;
     }
 
+    /// Return the node string of the nodedef this node was created from,
+    /// or an empty string if the node was not created from a nodedef.
+    const string& getNodeString() const
+    {
+        return _nodeString;
+    }
+
     /// Return the implementation used for this node.
     const ShaderNodeImpl& getImplementation() const
     {
@@ -384,6 +391,7 @@ class ShaderNode
   protected:
     const ShaderGraph* _parent;
     string _name;
+    string _nodeString;
     unsigned int _classification;
 
     std::unordered_map<string, ShaderInputPtr> _inputMap;
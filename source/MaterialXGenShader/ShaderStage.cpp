@@ -285,33 +285,38 @@ void ShaderStage::addComment(const string& str)
 
 void ShaderStage::addBlock(const string& str, GenContext& context)
 {
-    const string& INCLUDE = _syntax->getIncludeStatement();
-    const string& QUOTE   = _syntax->getStringQuote();
-
     // Add each line in the block seperatelly
     // to get correct indentation
     std::stringstream stream(str);
     for (string line; std::getline(stream, line); )
     {
-        size_t pos = line.find(INCLUDE);
-        if (pos != string::npos)
+        addBlockLine(line, context);
+    }
+}
+
+void ShaderStage::addBlockLine(const string& line, GenContext& context)
+{
+    const string& INCLUDE = _syntax->getIncludeStatement();
+    const string& QUOTE   = _syntax->getStringQuote();
+
+    size_t pos = line.find(INCLUDE);
+    if (pos != string::npos)
+    {
+        size_t startQuote = line.find_first_of(QUOTE);
+        size_t endQuote = line.find_last_of(QUOTE);
+        if (startQuote != string::npos && endQuote != string::npos && endQuote > startQuote)
         {
-            size_t startQuote = line.find_first_of(QUOTE);
-            size_t endQuote = line.find_last_of(QUOTE);
-            if (startQuote != string::npos && endQuote != string::npos && endQuote > startQuote)
+            size_t length = (endQuote - startQuote) - 1;
+            if (length)
             {
-                size_t length = (endQuote - startQuote) - 1;
-                if (length)
-                {
-                    const string filename = line.substr(startQuote + 1, length);
-                    addInclude(filename, context);
-                }
+                const string filename = line.substr(startQuote + 1, length);
+                addInclude(filename, context);
             }
         }
-        else
-        {
-            addLine(line, false);
-        }
+    }
+    else
+    {
+        addLine(line, false);
     }
 }
 
@@ -321,13 +326,18 @@ void ShaderStage::addInclude(const string& file, GenContext& context)
 
     if (!_includes.count(path))
     {
-        string content;
-        if (!readFile(path, content))
+        // Include files are shared through the source file cache, which
+        // holds their contents already split into lines.
+        ConstSourceFilePtr sourceFile = readSourceFile(path);
+        if (!sourceFile)
         {
             throw ExceptionShaderGenError("Could not find include file: '" + file + "'");
         }
         _includes.insert(path);
-        addBlock(content, context);
+        for (const string& line : sourceFile->getLines())
+        {
+            addBlockLine(line, context);
+        }
     }
 }
 
@@ -131,6 +131,9 @@ class ShaderStage
     /// Return the stage source code.
     const string& getSourceCode() const { return _code; }
 
+    /// Return the resolved paths of the files included into the stage.
+    const StringSet& getIncludes() const { return _includes; }
+
     /// Create a new uniform variable block.
     VariableBlockPtr createUniformBlock(const string& name, const string& instance = EMPTY_STRING);
 
@@ -181,6 +184,20 @@ class ShaderStage
     {
         return _outputs;
     }
+
+    /// Record the name of a function that is defined for a single node
+    /// rather than for its implementation.  Returns false if a function
+    /// with this name has already been recorded.
+    bool addFunctionName(const string& name)
+    {
+        return _definedFunctionNames.insert(name).second;
+    }
+
+    /// Return true if a function with the given name has been recorded.
+    bool hasFunctionName(const string& name) const
+    {
+        return _definedFunctionNames.count(name) > 0;
+    }
  
   protected:
     /// Start a new scope using the given bracket type.
@@ -226,6 +243,9 @@ class ShaderStage
     /// Add the function definition for a node.
     void addFunctionDefinition(const ShaderNode& node, GenContext& context);
 
+    /// Add a single line of a code block, expanding include statements.
+    void addBlockLine(const string& line, GenContext& context);
+
   private:
     /// Name of the stage
     const string _name;
@@ -245,6 +265,9 @@ class ShaderStage
     /// Set of hash ID's for functions that has been defined.
     std::set<size_t> _definedFunctions;
 
+    /// Set of names of functions that has been defined for single nodes.
+    StringSet _definedFunctionNames;
+
     /// Block holding constant variables for this stage.
     VariableBlock _constants;
 
@@ -5,13 +5,18 @@
 
 #include <MaterialXGenShader/Util.h>
 
+#include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 
+#include <MaterialXCore/ThreadPool.h>
+
 #include <MaterialXFormat/XmlIo.h>
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <unordered_set>
 
@@ -28,6 +33,75 @@
 namespace MaterialX
 {
 
+namespace {
+
+// A process-wide cache of shader source files, keyed by file path.
+class SourceFileCache
+{
+  public:
+    SourceFileCache() :
+        _readCount(0)
+    {
+    }
+
+    // Return the cached contents of the given file, or nullptr if the file
+    // has not been read, or has been modified since it was read.
+    ConstSourceFilePtr get(const string& filename, long long modificationTime)
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _entries.find(filename);
+        if (it != _entries.end() && it->second.modificationTime == modificationTime)
+        {
+            return it->second.file;
+        }
+        return nullptr;
+    }
+
+    // Cache the given contents of a file, returning the contents cached by
+    // a concurrent caller for the same modification time if there are any.
+    ConstSourceFilePtr set(const string& filename, long long modificationTime, ConstSourceFilePtr file)
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        Entry& entry = _entries[filename];
+        if (!entry.file || entry.modificationTime != modificationTime)
+        {
+            entry.modificationTime = modificationTime;
+            entry.file = file;
+        }
+        return entry.file;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _entries.clear();
+    }
+
+    std::atomic<size_t>& getReadCount()
+    {
+        return _readCount;
+    }
+
+  private:
+    struct Entry
+    {
+        long long modificationTime;
+        ConstSourceFilePtr file;
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<string, Entry> _entries;
+    std::atomic<size_t> _readCount;
+};
+
+SourceFileCache& getSourceFileCache()
+{
+    static SourceFileCache cache;
+    return cache;
+}
+
+} // anonymous namespace
+
 void makeDirectory(const string& directoryPath)
 {
 #if defined(_WIN32)
@@ -134,6 +208,58 @@ bool readFile(const string& filename, string& contents)
     return false;
 }
 
+SourceFile::SourceFile(const string& contents) :
+    _contents(contents)
+{
+    // Split lines as std::getline does, so that a final line ending does not
+    // produce an empty line.
+    size_t start = 0;
+    while (start < _contents.size())
+    {
+        size_t end = _contents.find('\n', start);
+        if (end == string::npos)
+        {
+            end = _contents.size();
+        }
+        _lines.push_back(_contents.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+ConstSourceFilePtr readSourceFile(const FilePath& file)
+{
+    string filename = file.asString();
+    long long modificationTime = file.getModificationTime();
+    SourceFileCache& cache = getSourceFileCache();
+
+    ConstSourceFilePtr cachedFile = cache.get(filename, modificationTime);
+    if (cachedFile)
+    {
+        return cachedFile;
+    }
+
+    // Read the file outside of the cache lock, so that concurrent callers
+    // are not serialized.  Concurrent readers of the same file may each read
+    // it once, and all of them return the first contents to be cached.
+    string contents;
+    cache.getReadCount()++;
+    if (!readFile(filename, contents))
+    {
+        return nullptr;
+    }
+    return cache.set(filename, modificationTime, std::make_shared<SourceFile>(contents));
+}
+
+void clearSourceFileCache()
+{
+    getSourceFileCache().clear();
+}
+
+size_t getSourceFileReadCount()
+{
+    return getSourceFileCache().getReadCount();
+}
+
 string getFileExtension(const string& filename)
 {
     size_t i = filename.rfind('.');
@@ -653,6 +779,79 @@ void findRenderableElements(const DocumentPtr& doc, std::vector<TypedElementPtr>
     }
 }
 
+vector<ShaderPtr> generateShaders(const vector<TypedElementPtr>& elements, const GenContext& context,
+                                  StringVec* errors, size_t threadCount)
+{
+    vector<ShaderPtr> shaders(elements.size());
+    vector<std::exception_ptr> exceptions(elements.size());
+
+    // Each worker has its own copy of the context, with its own shader node
+    // implementations, and claims the next unclaimed element until none
+    // remain, so that the work is balanced regardless of the cost of each
+    // shader.  Float formatting is held per thread, so the formatting of the
+    // calling thread is applied to each worker.
+    ThreadPool& pool = ThreadPool::getGlobal();
+    if (threadCount == 0)
+    {
+        threadCount = pool.getWorkerCount() + 1;
+    }
+    threadCount = std::min(threadCount, elements.size());
+    std::atomic<size_t> nextIndex(0);
+    Value::FloatFormat floatFormat = Value::getFloatFormat();
+    int floatPrecision = Value::getFloatPrecision();
+    pool.parallelFor(threadCount, [&elements, &context, &shaders, &exceptions, &nextIndex, floatFormat, floatPrecision](size_t)
+    {
+        Value::ScopedFloatFormatting formatting(floatFormat, floatPrecision);
+        GenContext workerContext(context);
+        for (size_t i = nextIndex++; i < elements.size(); i = nextIndex++)
+        {
+            try
+            {
+                shaders[i] = workerContext.getShaderGenerator().generate(elements[i]->getName(), elements[i], workerContext);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+            }
+        }
+    }, threadCount);
+
+    // Report failures in the order of the given elements.
+    if (errors)
+    {
+        errors->assign(elements.size(), EMPTY_STRING);
+    }
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        if (!exceptions[i])
+        {
+            continue;
+        }
+        if (!errors)
+        {
+            std::rethrow_exception(exceptions[i]);
+        }
+        try
+        {
+            std::rethrow_exception(exceptions[i]);
+        }
+        catch (std::exception& e)
+        {
+            (*errors)[i] = e.what();
+        }
+        catch (...)
+        {
+            (*errors)[i] = "Unknown error generating shader for element: " + elements[i]->getNamePath();
+        }
+        if ((*errors)[i].empty())
+        {
+            (*errors)[i] = "Failed to generate shader for element: " + elements[i]->getNamePath();
+        }
+    }
+
+    return shaders;
+}
+
 ValueElementPtr findNodeDefChild(const string& path, DocumentPtr doc, const string& target)
 {
     if (path.empty() || !doc)
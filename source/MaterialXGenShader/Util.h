@@ -38,6 +38,52 @@ void getFilesInDirectory(const string& directory, StringVec& files, const string
 /// Reads the contents of a file into the given string
 bool readFile(const string& filename, string& content);
 
+class SourceFile;
+
+/// Shared pointer to a constant SourceFile
+using ConstSourceFilePtr = shared_ptr<const SourceFile>;
+
+/// @class SourceFile
+/// The contents of a shader source file, as held by the source file cache.
+class SourceFile
+{
+  public:
+    explicit SourceFile(const string& contents);
+
+    /// Return the contents of the file.
+    const string& getContents() const
+    {
+        return _contents;
+    }
+
+    /// Return the lines of the file, without their line endings.
+    const StringVec& getLines() const
+    {
+        return _lines;
+    }
+
+  private:
+    string _contents;
+    StringVec _lines;
+};
+
+/// Read the given shader source file, returning contents that are shared
+/// between all callers.  Source files are cached by file path, and a cached
+/// file is read again once its modification time changes.  This function
+/// may be called concurrently from multiple threads.
+/// @param file The resolved path of the source file, as returned by
+///    GenContext::resolveSourceFile.
+/// @return The contents of the file, or nullptr if the file cannot be read
+///    or is empty.
+ConstSourceFilePtr readSourceFile(const FilePath& file);
+
+/// Clear all files from the source file cache.
+void clearSourceFileCache();
+
+/// Return the number of source files that have been read from disk through
+/// the source file cache.
+size_t getSourceFileReadCount();
+
 /// Returns the extension of the given filename
 string getFileExtension(const string& filename);
 
@@ -80,6 +126,22 @@ bool elementRequiresShading(const TypedElementPtr element);
 void findRenderableElements(const DocumentPtr& doc, std::vector<TypedElementPtr>& elements, 
                             bool includeReferencedGraphs=false, std::ostream* errorLog=nullptr);
 
+/// Generate shaders for the given renderable elements in parallel, on the
+/// shared thread pool.  Each worker generates shaders in its own copy of the
+/// given context, with its own shader node implementations.  Shaders are
+/// named after their elements.
+/// @param elements The renderable elements for which shaders are generated.
+/// @param context The context for generation, which is not modified.
+/// @param errors An optional output vector, to which an error message for
+///    each element is assigned.  If provided, an element that fails to
+///    generate has an empty shader and a non-empty message; otherwise the
+///    first failure, in the order of the given elements, is rethrown.
+/// @param threadCount The maximum number of threads, including the calling
+///    thread, or zero to use all threads of the shared pool.
+/// @return A vector of shaders, parallel to the given elements.
+vector<ShaderPtr> generateShaders(const vector<TypedElementPtr>& elements, const GenContext& context,
+                                  StringVec* errors = nullptr, size_t threadCount = 0);
+
 /// Given a path to a element, find the corresponding element with the same name
 /// on an associated nodedef if it exists. A target string should be provided
 /// if the path is to a Node as definitions for Nodes can be target specific.
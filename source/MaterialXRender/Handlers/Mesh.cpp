@@ -5,6 +5,11 @@
 
 #include <MaterialXRender/Handlers/Mesh.h>
 
+#include <MaterialXCore/ThreadPool.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <map>
 
 namespace MaterialX
@@ -19,6 +24,31 @@ const string MeshStream::GEOMETRY_PROPERTY_ATTRIBUTE("geomprop");
 
 const float MAX_FLOAT = std::numeric_limits<float>::max();
 
+namespace {
+
+// The number of elements in each range of a parallel loop.
+const size_t PARALLEL_RANGE_SIZE = 4096;
+
+// Return the number of ranges into which a parallel loop over the given
+// number of elements is divided.
+size_t getParallelRangeCount(size_t count)
+{
+    return (count + PARALLEL_RANGE_SIZE - 1) / PARALLEL_RANGE_SIZE;
+}
+
+// Call the given function with the index, beginning and end of each range
+// of a loop over the given number of elements, on the shared thread pool.
+template<class Function> void parallelForRanges(size_t count, const Function& func)
+{
+    ThreadPool::getGlobal().parallelFor(getParallelRangeCount(count), [count, &func](size_t range)
+    {
+        size_t begin = range * PARALLEL_RANGE_SIZE;
+        func(range, begin, std::min(begin + PARALLEL_RANGE_SIZE, count));
+    });
+}
+
+} // anonymous namespace
+
 Mesh::Mesh(const string& identifier) :
     _identifier(identifier),
     _minimumBounds(MAX_FLOAT, MAX_FLOAT, MAX_FLOAT),
@@ -32,16 +62,16 @@ Mesh::Mesh(const string& identifier) :
 bool Mesh::generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoordStream, MeshStreamPtr normalStream,
                             MeshStreamPtr tangentStream, MeshStreamPtr bitangentStream)
 {
-    MeshFloatBuffer& positions = positionStream->getData();
-    unsigned int positionStride = positionStream->getStride();
-    MeshFloatBuffer& texcoords = texcoordStream->getData();
-    unsigned int texcoordStride = texcoordStream->getStride();
-    MeshFloatBuffer& normals = normalStream->getData();
-    unsigned int normalStride = normalStream->getStride();
-
-    size_t vertexCount = positions.size() / positionStride;
-    size_t uvCount = texcoords.size() / texcoordStride;
-    size_t normalCount = normals.size() / normalStride;
+    const float* positions = positionStream->getData().data();
+    const size_t positionStride = positionStream->getStride();
+    const float* texcoords = texcoordStream->getData().data();
+    const size_t texcoordStride = texcoordStream->getStride();
+    const float* normals = normalStream->getData().data();
+    const size_t normalStride = normalStream->getStride();
+
+    size_t vertexCount = positionStream->getData().size() / positionStride;
+    size_t uvCount = texcoordStream->getData().size() / texcoordStride;
+    size_t normalCount = normalStream->getData().size() / normalStride;
     if (vertexCount != uvCount ||
         vertexCount != normalCount)
     {
@@ -49,94 +79,172 @@ bool Mesh::generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoord
     }
 
     // Prepare tangent stream data
-    MeshFloatBuffer& tangents = tangentStream->getData();
-    tangents.resize(positions.size());
-    std::fill(tangents.begin(), tangents.end(), 0.0f);
-    const unsigned int tangentStride = 3;
+    MeshFloatBuffer& tangentData = tangentStream->getData();
+    tangentData.assign(vertexCount * 3, 0.0f);
+    const size_t tangentStride = 3;
     tangentStream->setStride(tangentStride);
+    float* tangents = tangentData.data();
 
+    // Based on Eric Lengyel at http://www.terathon.com/code/tangent.html
+    //
+    // The tangent direction of each face is computed in parallel, and stored
+    // as a structure of arrays.  Face directions are then accumulated into
+    // their vertices in face order, so that the result is independent of the
+    // number of threads.
+    vector<float> dirX, dirY, dirZ;
     for (size_t i = 0; i < getPartitionCount(); i++)
     {
-        auto part = getPartition(i);
+        MeshPartitionPtr part = getPartition(i);
+        const unsigned int* indices = part->getIndices().data();
+        size_t faceCount = part->getFaceCount();
+        dirX.resize(faceCount);
+        dirY.resize(faceCount);
+        dirZ.resize(faceCount);
 
-        // Based on Eric Lengyel at http://www.terathon.com/code/tangent.html
+        parallelForRanges(faceCount, [&](size_t, size_t begin, size_t end)
+        {
+            for (size_t f = begin; f < end; f++)
+            {
+                const float* v1 = positions + indices[f * 3 + 0] * positionStride;
+                const float* v2 = positions + indices[f * 3 + 1] * positionStride;
+                const float* v3 = positions + indices[f * 3 + 2] * positionStride;
+                const float* w1 = texcoords + indices[f * 3 + 0] * texcoordStride;
+                const float* w2 = texcoords + indices[f * 3 + 1] * texcoordStride;
+                const float* w3 = texcoords + indices[f * 3 + 2] * texcoordStride;
+
+                float x1 = v2[0] - v1[0];
+                float x2 = v3[0] - v1[0];
+                float y1 = v2[1] - v1[1];
+                float y2 = v3[1] - v1[1];
+                float z1 = v2[2] - v1[2];
+                float z2 = v3[2] - v1[2];
+
+                float s1 = w2[0] - w1[0];
+                float s2 = w3[0] - w1[0];
+                float t1 = w2[1] - w1[1];
+                float t2 = w3[1] - w1[1];
+
+                float denom = s1 * t2 - s2 * t1;
+                float r = denom ? 1.0f / denom : 0.0f;
+                dirX[f] = (t2 * x1 - t1 * x2) * r;
+                dirY[f] = (t2 * y1 - t1 * y2) * r;
+                dirZ[f] = (t2 * z1 - t1 * z2) * r;
+            }
+        });
 
-        const MeshIndexBuffer& indicies = part->getIndices();
-        for (size_t faceIndex = 0; faceIndex < part->getFaceCount(); faceIndex++)
+        for (size_t f = 0; f < faceCount; f++)
         {
-            int i1 = indicies[faceIndex * 3 + 0];
-            int i2 = indicies[faceIndex * 3 + 1];
-            int i3 = indicies[faceIndex * 3 + 2];
-
-            Vector3& v1 = *reinterpret_cast<Vector3*>(&(positions[i1 * positionStride]));
-            Vector3& v2 = *reinterpret_cast<Vector3*>(&(positions[i2 * positionStride]));
-            Vector3& v3 = *reinterpret_cast<Vector3*>(&(positions[i3 * positionStride]));
-
-            Vector2& w1 = *reinterpret_cast<Vector2*>(&(texcoords[i1 * texcoordStride]));
-            Vector2& w2 = *reinterpret_cast<Vector2*>(&(texcoords[i2 * texcoordStride]));
-            Vector2& w3 = *reinterpret_cast<Vector2*>(&(texcoords[i3 * texcoordStride]));
-
-            float x1 = v2[0] - v1[0];
-            float x2 = v3[0] - v1[0];
-            float y1 = v2[1] - v1[1];
-            float y2 = v3[1] - v1[1];
-            float z1 = v2[2] - v1[2];
-            float z2 = v3[2] - v1[2];
-
-            float s1 = w2[0] - w1[0];
-            float s2 = w3[0] - w1[0];
-            float t1 = w2[1] - w1[1];
-            float t2 = w3[1] - w1[1];
-
-            float denom = s1 * t2 - s2 * t1;
-            float r = denom ? 1.0f / denom : 0.0f;
-            Vector3 dir((t2 * x1 - t1 * x2) * r,
-                (t2 * y1 - t1 * y2) * r,
-                (t2 * z1 - t1 * z2) * r);
-
-            Vector3& tan1 = *reinterpret_cast<Vector3*>(&(tangents[i1 * tangentStride]));
-            Vector3& tan2 = *reinterpret_cast<Vector3*>(&(tangents[i2 * tangentStride]));
-            Vector3& tan3 = *reinterpret_cast<Vector3*>(&(tangents[i3 * tangentStride]));
-            tan1 += dir;
-            tan2 += dir;
-            tan3 += dir;
+            for (size_t k = 0; k < 3; k++)
+            {
+                float* tan = tangents + indices[f * 3 + k] * tangentStride;
+                tan[0] += dirX[f];
+                tan[1] += dirY[f];
+                tan[2] += dirZ[f];
+            }
         }
     }
 
     // Prepare bitangent stream data
-    MeshFloatBuffer* bitangents = nullptr;
-    unsigned int bitangentStride = 0;
+    float* bitangents = nullptr;
+    size_t bitangentStride = 0;
     if (bitangentStream)
     {
-        bitangents = &(bitangentStream->getData());
-        bitangents->resize(positions.size());
-        std::fill(bitangents->begin(), bitangents->end(), 0.0f);
+        MeshFloatBuffer& bitangentData = bitangentStream->getData();
+        bitangentData.assign(vertexCount * bitangentStream->getStride(), 0.0f);
         bitangentStride = bitangentStream->getStride();
+        bitangents = bitangentData.data();
     }
 
-    for (size_t v = 0; v < vertexCount; v++)
+    parallelForRanges(vertexCount, [&](size_t, size_t begin, size_t end)
     {
-        Vector3& n = *reinterpret_cast<Vector3*>(&(normals[v * normalStride]));
-        Vector3& t = *reinterpret_cast<Vector3*>(&(tangents[v * tangentStride]));
-        Vector3* b = bitangents ? reinterpret_cast<Vector3*>(&((*bitangents)[v * bitangentStride])) : nullptr;
-
-        // Gram-Schmidt orthogonalize
-        if (t != Vector3(0.0f))
+        for (size_t v = begin; v < end; v++)
         {
-            t = (t - n * n.dot(t)).getNormalized();
+            const float* n = normals + v * normalStride;
+            float* t = tangents + v * tangentStride;
+
+            // Gram-Schmidt orthogonalize
+            if (t[0] != 0.0f || t[1] != 0.0f || t[2] != 0.0f)
+            {
+                float d = n[0] * t[0] + n[1] * t[1] + n[2] * t[2];
+                float tx = t[0] - n[0] * d;
+                float ty = t[1] - n[1] * d;
+                float tz = t[2] - n[2] * d;
+                float magnitude = std::sqrt(tx * tx + ty * ty + tz * tz);
+                t[0] = tx / magnitude;
+                t[1] = ty / magnitude;
+                t[2] = tz / magnitude;
+            }
+            else
+            {
+                // Tangent vector is zero length so set a default direction
+                // to avoid sending invalid data to the renderer.
+                t[0] = 0.0f;
+                t[1] = 0.0f;
+                t[2] = 1.0f;
+            }
+            if (bitangents)
+            {
+                float* b = bitangents + v * bitangentStride;
+                b[0] = n[1] * t[2] - n[2] * t[1];
+                b[1] = n[2] * t[0] - n[0] * t[2];
+                b[2] = n[0] * t[1] - n[1] * t[0];
+            }
         }
-        else
+    });
+    return true;
+}
+
+void Mesh::computeBounds()
+{
+    MeshStreamPtr positionStream = getStream(MeshStream::POSITION_ATTRIBUTE, 0);
+    if (!positionStream)
+    {
+        return;
+    }
+    const float* positions = positionStream->getData().data();
+    const size_t positionStride = positionStream->getStride();
+
+    // Bounds are computed over the vertices referenced by faces, with a
+    // partial result for each range of faces.
+    Vector3 boxMin(MAX_FLOAT, MAX_FLOAT, MAX_FLOAT);
+    Vector3 boxMax(-MAX_FLOAT, -MAX_FLOAT, -MAX_FLOAT);
+    vector<std::array<float, 6>> rangeBounds;
+    for (size_t p = 0; p < getPartitionCount(); p++)
+    {
+        MeshPartitionPtr part = getPartition(p);
+        const unsigned int* indices = part->getIndices().data();
+        size_t indexCount = part->getFaceCount() * 3;
+        rangeBounds.assign(getParallelRangeCount(indexCount), { MAX_FLOAT, MAX_FLOAT, MAX_FLOAT, -MAX_FLOAT, -MAX_FLOAT, -MAX_FLOAT });
+
+        parallelForRanges(indexCount, [&](size_t range, size_t begin, size_t end)
         {
-            // Tangent vector is zero length so set a default direction
-            // to avoid sending invalid data to the renderer.
-            t = Vector3(0.0f, 0.0f, 1.0f);
-        }
-        if (b)
+            std::array<float, 6>& bounds = rangeBounds[range];
+            for (size_t i = begin; i < end; i++)
+            {
+                const float* v = positions + indices[i] * positionStride;
+                for (size_t k = 0; k < 3; k++)
+                {
+                    bounds[k] = std::min(v[k], bounds[k]);
+                    bounds[k + 3] = std::max(v[k], bounds[k + 3]);
+                }
+            }
+        });
+
+        for (const std::array<float, 6>& bounds : rangeBounds)
         {
-            *b = n.cross(t);
+            for (size_t k = 0; k < 3; k++)
+            {
+                boxMin[k] = std::min(bounds[k], boxMin[k]);
+                boxMax[k] = std::max(bounds[k + 3], boxMax[k]);
+            }
         }
     }
-    return true;
+
+    setMinimumBounds(boxMin);
+    setMaximumBounds(boxMax);
+    Vector3 sphereCenter = (boxMax + boxMin) / 2.0;
+    setSphereCenter(sphereCenter);
+    setSphereRadius((sphereCenter - boxMin).getMagnitude());
 }
 
 void Mesh::mergePartitions()
@@ -146,8 +254,15 @@ void Mesh::mergePartitions()
         return;
     }
 
+    size_t indexCount = 0;
+    for (size_t p = 0; p < getPartitionCount(); p++)
+    {
+        indexCount += getPartition(p)->getIndices().size();
+    }
+
     MeshPartitionPtr merged = MeshPartition::create();
     merged->setIdentifier("merged");
+    merged->getIndices().reserve(indexCount);
     for (size_t p = 0; p < getPartitionCount(); p++)
     {
         MeshPartitionPtr part = getPartition(p);
@@ -163,38 +278,82 @@ void Mesh::mergePartitions()
 
 void Mesh::splitByUdims()
 {
-    MeshStreamPtr texcoords = getStream(MeshStream::TEXCOORD_ATTRIBUTE, 0);
-    if (!texcoords)
+    MeshStreamPtr texcoordStream = getStream(MeshStream::TEXCOORD_ATTRIBUTE, 0);
+    if (!texcoordStream)
     {
         return;
     }
+    const float* texcoords = texcoordStream->getData().data();
+    const size_t texcoordStride = texcoordStream->getStride();
+
+    // Compute the UDIM of each face in parallel, from the texture
+    // coordinates of its first vertex.
+    vector<uint32_t> faceUdims;
+    for (size_t p = 0; p < getPartitionCount(); p++)
+    {
+        MeshPartitionPtr part = getPartition(p);
+        const unsigned int* indices = part->getIndices().data();
+        size_t offset = faceUdims.size();
+        faceUdims.resize(offset + part->getFaceCount());
+        uint32_t* udims = faceUdims.data() + offset;
+
+        parallelForRanges(part->getFaceCount(), [&](size_t, size_t begin, size_t end)
+        {
+            for (size_t f = begin; f < end; f++)
+            {
+                const float* uv = texcoords + indices[f * 3] * texcoordStride;
+                uint32_t udimU = (uint32_t) uv[0];
+                uint32_t udimV = (uint32_t) uv[1];
+                udims[f] = 1001 + udimU + (10 * udimV);
+            }
+        });
+    }
 
+    // Count the faces of each UDIM, so that the indices of each new partition
+    // are allocated once.  Consecutive faces usually share a UDIM, so the map
+    // is searched only when the UDIM changes.
     using UdimMap = std::map<uint32_t, MeshPartitionPtr>;
     UdimMap udimMap;
+    MeshPartitionPtr udimPart;
+    uint32_t currentUdim = 0;
+    for (uint32_t udim : faceUdims)
+    {
+        if (!udimPart || udim != currentUdim)
+        {
+            MeshPartitionPtr& part = udimMap[udim];
+            if (!part)
+            {
+                part = MeshPartition::create();
+                part->setIdentifier(std::to_string(udim));
+            }
+            udimPart = part;
+            currentUdim = udim;
+        }
+        udimPart->setFaceCount(udimPart->getFaceCount() + 1);
+    }
+    for (auto pair : udimMap)
+    {
+        pair.second->getIndices().reserve(pair.second->getFaceCount() * 3);
+    }
+
+    // Copy the indices of each face to the partition of its UDIM.
+    size_t faceIndex = 0;
+    udimPart = nullptr;
     for (size_t p = 0; p < getPartitionCount(); p++)
     {
         MeshPartitionPtr part = getPartition(p);
-        for (size_t f = 0; f < part->getFaceCount(); f++)
+        const MeshIndexBuffer& indices = part->getIndices();
+        for (size_t f = 0; f < part->getFaceCount(); f++, faceIndex++)
         {
-            uint32_t i0 = part->getIndices()[f * 3 + 0];
-            uint32_t i1 = part->getIndices()[f * 3 + 1];
-            uint32_t i2 = part->getIndices()[f * 3 + 2];
-
-            const Vector2& uv0 = reinterpret_cast<Vector2*>(&texcoords->getData()[0])[i0];
-            uint32_t udimU = (uint32_t) uv0[0];
-            uint32_t udimV = (uint32_t) uv0[1];
-            uint32_t udim = 1001 + udimU + (10 * udimV);
-            if (!udimMap.count(udim))
+            uint32_t udim = faceUdims[faceIndex];
+            if (!udimPart || udim != currentUdim)
             {
-                udimMap[udim] = MeshPartition::create();
-                udimMap[udim]->setIdentifier(std::to_string(udim));
+                udimPart = udimMap[udim];
+                currentUdim = udim;
             }
-
-            MeshPartitionPtr udimPart = udimMap[udim];
-            udimPart->getIndices().push_back(i0);
-            udimPart->getIndices().push_back(i1);
-            udimPart->getIndices().push_back(i2);
-            udimPart->setFaceCount(udimPart->getFaceCount() + 1);
+            udimPart->getIndices().insert(udimPart->getIndices().end(),
+                                          indices.begin() + f * 3,
+                                          indices.begin() + f * 3 + 3);
         }
     }
 
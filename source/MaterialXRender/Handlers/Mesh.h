@@ -12,6 +12,7 @@
 #include <MaterialXCore/Types.h>
 #include <string>
 #include <vector>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 
@@ -368,6 +369,10 @@ class Mesh
     bool generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoordStream, MeshStreamPtr normalStream,
                           MeshStreamPtr tangentStream, MeshStreamPtr bitangentStream);   
 
+    /// Compute the bounding box and bounding sphere of the vertices
+    /// referenced by the partitions of the mesh.
+    void computeBounds();
+
     /// Merge all mesh partitions into one.
     void mergePartitions();
 
@@ -68,10 +68,6 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
     texcoords.resize(vertexCount * 2);
     tangents.resize(vertexCount * 3);
 
-    const float MAX_FLOAT = std::numeric_limits<float>::max();
-    Vector3 boxMin = { MAX_FLOAT, MAX_FLOAT, MAX_FLOAT };
-    Vector3 boxMax = { -MAX_FLOAT, -MAX_FLOAT, -MAX_FLOAT };
-
     for (size_t partIndex = 0; partIndex < shapes.size(); partIndex++)
     {
         const tinyobj::shape_t& shape = shapes[partIndex];
@@ -114,21 +110,13 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
             indices[faceIndex * 3 + 1] = writeIndex1;
             indices[faceIndex * 3 + 2] = writeIndex2;
 
-            // Copy positions and compute bounding box.
+            // Copy positions.
             Vector3 v[3];
             for (int k = 0; k < 3; k++)
             {
                 v[0][k] = attrib.vertices[indexObj0.vertex_index * 3 + k];
                 v[1][k] = attrib.vertices[indexObj1.vertex_index * 3 + k];
                 v[2][k] = attrib.vertices[indexObj2.vertex_index * 3 + k];
-
-                boxMin[k] = std::min(v[0][k], boxMin[k]);
-                boxMin[k] = std::min(v[1][k], boxMin[k]);
-                boxMin[k] = std::min(v[2][k], boxMin[k]);
-
-                boxMax[k] = std::max(v[0][k], boxMax[k]);
-                boxMax[k] = std::max(v[1][k], boxMax[k]);
-                boxMax[k] = std::max(v[2][k], boxMax[k]);
             }
 
             // Copy or compute normals
@@ -189,12 +177,7 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
         }
     }
 
-    mesh->setMinimumBounds(boxMin);
-    mesh->setMaximumBounds(boxMax);
-    Vector3 sphereCenter = (boxMax + boxMin) / 2.0;
-    mesh->setSphereCenter(sphereCenter);
-    mesh->setSphereRadius((sphereCenter - boxMin).getMagnitude());
-
+    mesh->computeBounds();
     mesh->generateTangents(positionStream, texCoordStream, normalStream, tangentStream, nullptr);
 
     return true;
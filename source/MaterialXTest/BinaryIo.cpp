@@ -0,0 +1,79 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/TestUtil.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Binary round trip", "[binaryio]")
+{
+    std::string exampleFilenames[] =
+    {
+        "CustomNode.mtlx",
+        "Looks.mtlx",
+        "MaterialBasic.mtlx",
+        "MultiOutput.mtlx",
+        "NodeGraphs.mtlx",
+        "PaintMaterials.mtlx",
+        "PostShaderComposite.mtlx",
+        "PreShaderComposite.mtlx"
+    };
+    std::string searchPath = "libraries/stdlib" +
+                             mx::PATH_LIST_SEPARATOR +
+                             "resources/Materials/Examples";
+    TestUtil::TemporaryDirectory tempDir;
+
+    for (std::string filename : exampleFilenames)
+    {
+        // Read the example document, including its XInclude references.
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, filename, searchPath);
+        REQUIRE(doc->validate());
+
+        // Verify that a binary round trip preserves the document.
+        std::string binaryString = mx::writeToBinaryString(doc);
+        mx::DocumentPtr binaryDoc = mx::createDocument();
+        mx::readFromBinaryString(binaryDoc, binaryString);
+        REQUIRE(*binaryDoc == *doc);
+        REQUIRE(binaryDoc->validate());
+
+        // Verify that source URIs are preserved.
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            mx::ElementPtr binaryElem = binaryDoc->getDescendant(elem->getNamePath());
+            REQUIRE(binaryElem);
+            REQUIRE(binaryElem->getSourceUri() == elem->getSourceUri());
+        }
+
+        // Verify a round trip through a memory-mapped file.
+        std::string binaryFilename = tempDir.getPath() / mx::FilePath(filename + ".bin");
+        mx::writeToBinaryFile(doc, binaryFilename);
+        mx::DocumentPtr fileDoc = mx::createDocument();
+        mx::readFromBinaryFile(fileDoc, binaryFilename);
+        REQUIRE(*fileDoc == *doc);
+        REQUIRE(fileDoc->getSourceUri() == binaryFilename);
+    }
+
+    // Verify that invalid binary data is rejected.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->addNodeGraph("graph1")->addNode("constant", "node1");
+    std::string binaryString = mx::writeToBinaryString(doc);
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalidDoc, mx::writeToXmlString(doc)), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalidDoc, binaryString.substr(0, binaryString.size() - 1)), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalidDoc, std::string()), mx::ExceptionParseError&);
+
+    // Read a non-existent document.
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(invalidDoc, "NonExistent.bin"), mx::ExceptionFileMissing&);
+
+    // Write to a path that cannot be opened.
+    std::string invalidFilename = tempDir.getPath() / mx::FilePath("NonExistent/Invalid.bin");
+    REQUIRE_THROWS_AS(mx::writeToBinaryFile(doc, invalidFilename), mx::ExceptionFileMissing&);
+}
@@ -7,8 +7,58 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+
 namespace mx = MaterialX;
 
+namespace
+{
+
+mx::StringSet getNodeDefNames(mx::DocumentPtr doc, const std::string& nodeString)
+{
+    mx::StringSet names;
+    for (mx::NodeDefPtr nodeDef : doc->getMatchingNodeDefs(nodeString))
+    {
+        names.insert(nodeDef->getNamePath());
+    }
+    return names;
+}
+
+mx::StringSet getImplementationNames(mx::DocumentPtr doc, const std::string& nodeDefString)
+{
+    mx::StringSet names;
+    for (mx::InterfaceElementPtr impl : doc->getMatchingImplementations(nodeDefString))
+    {
+        names.insert(impl->getNamePath());
+    }
+    return names;
+}
+
+mx::StringSet getPortNames(mx::DocumentPtr doc, const std::string& nodeName)
+{
+    mx::StringSet names;
+    for (mx::PortElementPtr port : doc->getMatchingPorts(nodeName))
+    {
+        names.insert(port->getNamePath());
+    }
+    return names;
+}
+
+// Verify that the incrementally maintained cache of the given document
+// matches a cache built from scratch on a copy of the document.
+void verifyDocumentCache(mx::DocumentPtr doc, const mx::StringVec& keys)
+{
+    mx::DocumentPtr reference = doc->copy();
+    for (const std::string& key : keys)
+    {
+        REQUIRE(getNodeDefNames(doc, key) == getNodeDefNames(reference, key));
+        REQUIRE(getImplementationNames(doc, key) == getImplementationNames(reference, key));
+        REQUIRE(getPortNames(doc, key) == getPortNames(reference, key));
+    }
+}
+
+} // anonymous namespace
+
 TEST_CASE("Document", "[document]")
 {
     // Create a document.
@@ -108,3 +158,262 @@ TEST_CASE("Document", "[document]")
     // Validate the combined document.
     REQUIRE(doc->validate());
 }
+
+TEST_CASE("Parallel validation", "[document]")
+{
+    // Create node graphs, some of which contain type mismatches or cycles.
+    mx::DocumentPtr doc = mx::createDocument();
+    for (int i = 0; i < 100; i++)
+    {
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+        mx::NodePtr constant = nodeGraph->addNode("constant");
+        constant->setParameterValue("value", mx::Color3(0.5f));
+        mx::NodePtr add1 = nodeGraph->addNode("add");
+        mx::NodePtr add2 = nodeGraph->addNode("add");
+        add1->setConnectedNode("in1", constant);
+        add2->setConnectedNode("in1", add1);
+        mx::OutputPtr output = nodeGraph->addOutput();
+        output->setConnectedNode(add2);
+        if (i % 10 == 0)
+        {
+            output->setType("float");
+        }
+        if (i % 25 == 0)
+        {
+            add1->setConnectedNode("in2", add2);
+        }
+    }
+    REQUIRE(!doc->validateParallel());
+
+    // Compare sequential and parallel validation.
+    std::string message;
+    bool valid = doc->validate(&message);
+    REQUIRE(!valid);
+    std::vector<mx::ValidationDiagnostic> reference;
+    REQUIRE(doc->validateParallel(&reference, 1) == valid);
+    mx::StringVec messageLines = mx::splitString(message, "\n");
+    mx::StringVec diagnosticLines;
+    for (const mx::ValidationDiagnostic& diagnostic : reference)
+    {
+        REQUIRE(doc->getDescendant(diagnostic.elementPath));
+        REQUIRE(diagnostic.message.find(diagnostic.rule) == 0);
+        diagnosticLines.push_back(diagnostic.message);
+    }
+    std::sort(messageLines.begin(), messageLines.end());
+    std::sort(diagnosticLines.begin(), diagnosticLines.end());
+    REQUIRE(messageLines == diagnosticLines);
+
+    // Verify that diagnostics are independent of thread count.
+    for (size_t threadCount : { 2, 3, 8, 0 })
+    {
+        std::vector<mx::ValidationDiagnostic> diagnostics;
+        REQUIRE(doc->validateParallel(&diagnostics, threadCount) == valid);
+        REQUIRE(diagnostics == reference);
+    }
+}
+
+TEST_CASE("Document cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_add_float", "float", "add");
+    nodeDef->addInput("in1", "float");
+    mx::ImplementationPtr impl = doc->addImplementation("IM_add_float");
+    impl->setNodeDef(nodeDef);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node1 = nodeGraph->addNode("add", "node1", "float");
+    mx::NodePtr node2 = nodeGraph->addNode("add", "node2", "float");
+    mx::InputPtr input = node2->addInput("in1", "float");
+    input->setNodeName("node1");
+
+    const mx::StringVec keys = { "add", "multiply", "ND_add_float", "ND_multiply_float",
+                                 "custom:add", "custom:ND_add_float", "node1", "node2" };
+    verifyDocumentCache(doc, keys);
+    REQUIRE(node2->getNodeDef() == nodeDef);
+    REQUIRE(node1->getDownstreamPorts().size() == 1);
+
+    // Edit indexed attributes.
+    nodeDef->setNodeString("multiply");
+    verifyDocumentCache(doc, keys);
+    REQUIRE(node2->getNodeDef() == nullptr);
+    nodeDef->setNodeString("add");
+    impl->setNodeDefString("ND_multiply_float");
+    input->setNodeName("node2");
+    verifyDocumentCache(doc, keys);
+    REQUIRE(node1->getDownstreamPorts().empty());
+    input->removeAttribute(mx::PortElement::NODE_NAME_ATTRIBUTE);
+    impl->removeAttribute(mx::InterfaceElement::NODE_DEF_ATTRIBUTE);
+    verifyDocumentCache(doc, keys);
+
+    // Edit non-indexed attributes.
+    node1->setName("node3");
+    input->setValue(1.0f);
+    verifyDocumentCache(doc, keys);
+
+    // Add and remove elements.
+    mx::NodeDefPtr nodeDef2 = doc->addNodeDef("ND_multiply_float", "float", "multiply");
+    verifyDocumentCache(doc, keys);
+    doc->removeNodeDef(nodeDef->getName());
+    doc->removeNodeGraph(nodeGraph->getName());
+    verifyDocumentCache(doc, keys);
+
+    // Apply namespaces.
+    mx::DocumentPtr library = mx::createDocument();
+    library->addNodeDef("ND_add_float", "float", "add");
+    library->addImplementation("IM_add_float")->setNodeDefString("ND_add_float");
+    library->setNamespace("custom");
+    doc->importLibrary(library);
+    verifyDocumentCache(doc, keys);
+    REQUIRE(getNodeDefNames(doc, "custom:add").size() == 1);
+    nodeDef2->setNamespace("custom");
+    verifyDocumentCache(doc, keys);
+    nodeDef2->removeAttribute(mx::Element::NAMESPACE_ATTRIBUTE);
+    verifyDocumentCache(doc, keys);
+
+    // Copy and clear content.
+    mx::NodeDefPtr nodeDef3 = doc->addNodeDef("ND_add_float");
+    nodeDef3->copyContentFrom(library->getNodeDef("ND_add_float"));
+    verifyDocumentCache(doc, keys);
+    nodeDef3->clearContent();
+    verifyDocumentCache(doc, keys);
+    doc->initialize();
+    verifyDocumentCache(doc, keys);
+}
+
+TEST_CASE("Document arena storage", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    REQUIRE(!doc->getArena());
+    doc->enableArenaStorage();
+    REQUIRE(doc->getArena());
+
+    // Create content in arena storage.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr constant = nodeGraph->addNode("constant");
+    constant->setParameterValue("value", mx::Color3(0.5f));
+    mx::OutputPtr output = nodeGraph->addOutput();
+    output->setConnectedNode(constant);
+    REQUIRE(doc->getArena()->getAllocatedBytes() > 0);
+    REQUIRE(doc->validate());
+
+    // Edit attributes.
+    output->setAttribute("custom", "value1");
+    output->setAttribute("custom", "value2");
+    REQUIRE(output->getAttribute("custom") == "value2");
+    REQUIRE(output->getAttributeNames().back() == "custom");
+    output->removeAttribute("custom");
+    REQUIRE(!output->hasAttribute("custom"));
+
+    // Verify that the storage of removed elements is reused.
+    nodeGraph->addNode("constant", "temp");
+    nodeGraph->removeNode("temp");
+    size_t allocatedBytes = doc->getArena()->getAllocatedBytes();
+    size_t blockCount = doc->getArena()->getBlockCount();
+    for (int i = 0; i < 1000; i++)
+    {
+        nodeGraph->addNode("constant", "temp");
+        nodeGraph->removeNode("temp");
+    }
+    REQUIRE(doc->getArena()->getAllocatedBytes() == allocatedBytes);
+    REQUIRE(doc->getArena()->getBlockCount() == blockCount);
+
+    // Copy the document.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getArena());
+    REQUIRE(copy->getArena() != doc->getArena());
+    REQUIRE(*copy == *doc);
+
+    // Verify that elements remain valid after their document is released.
+    mx::ElementPtr child = copy->getChildren()[0];
+    mx::NodePtr copiedNode = copy->getNodeGraph(nodeGraph->getName())->getNode(constant->getName());
+    copy = nullptr;
+    REQUIRE(child->getName() == nodeGraph->getName());
+    REQUIRE(!copiedNode->getAttributeNames().empty());
+    REQUIRE(copiedNode->getAttributeNames() == constant->getAttributeNames());
+    REQUIRE(copiedNode->getType() == constant->getType());
+}
+
+TEST_CASE("Referenced libraries", "[document]")
+{
+    // Create a library with a custom type, nodedef and implementation.
+    mx::DocumentPtr library = mx::createDocument();
+    library->addTypeDef("customtype");
+    mx::NodeDefPtr nodeDef = library->addNodeDef("ND_custom", "float", "custom");
+    nodeDef->addInput("in", "float");
+    mx::ImplementationPtr impl = library->addImplementation("IM_custom");
+    impl->setNodeDef(nodeDef);
+
+    // Create a document that references the library.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->referenceLibrary(library);
+    REQUIRE(doc->getReferencedLibraries().size() == 1);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node = nodeGraph->addNode("custom", "node1", "float");
+    node->setInputValue("in", 0.5f);
+    mx::NodePtr explicitNode = nodeGraph->addNode("custom", "node2", "float");
+    explicitNode->setNodeDefString("ND_custom");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "customtype");
+    REQUIRE(doc->getChildren().size() == 1);
+
+    // Verify that const lookups fall through to the library, returning the
+    // shared library elements themselves.
+    REQUIRE(doc->findLibraryNodeDef("ND_custom") == nodeDef);
+    REQUIRE(doc->findLibraryTypeDef("customtype"));
+    REQUIRE(doc->findLibraryImplementation("IM_custom") == impl);
+    REQUIRE(doc->findLibraryElement("ND_custom") == nodeDef);
+    REQUIRE(doc->findLibraryMatchingNodeDefs("custom").size() == 1);
+    REQUIRE(doc->findLibraryMatchingNodeDefs("custom")[0] == nodeDef);
+    REQUIRE(doc->findLibraryMatchingImplementations("ND_custom").size() == 1);
+    REQUIRE(node->getDeclaration() == nodeDef);
+    REQUIRE(explicitNode->getDeclaration() == nodeDef);
+    REQUIRE(doc->getChildren().size() == 1);
+    REQUIRE(doc->validate());
+
+    // Verify that lookups of mutable elements consider only the document.
+    REQUIRE(!doc->getNodeDef("ND_custom"));
+    REQUIRE(doc->getNodeDefs().empty());
+    REQUIRE(doc->getMatchingNodeDefs("custom").empty());
+    REQUIRE(!doc->getTypeDef("customtype"));
+    REQUIRE(!doc->getImplementation("IM_custom"));
+    REQUIRE(doc->getMatchingImplementations("ND_custom").empty());
+    REQUIRE(!node->getNodeDef());
+    REQUIRE(!explicitNode->getNodeDef());
+    REQUIRE(!output->getTypeDef());
+
+    // Verify that document elements shadow library elements.
+    mx::NodeDefPtr localNodeDef = doc->addNodeDef("ND_custom", "float", "custom");
+    localNodeDef->addInput("in", "float");
+    REQUIRE(doc->findLibraryNodeDef("ND_custom") == localNodeDef);
+    REQUIRE(doc->findLibraryMatchingNodeDefs("custom").size() == 1);
+    REQUIRE(node->getNodeDef() == localNodeDef);
+    REQUIRE(node->getDeclaration() == localNodeDef);
+    REQUIRE(explicitNode->getNodeDef() == localNodeDef);
+    REQUIRE(explicitNode->getDeclaration() == localNodeDef);
+    doc->removeNodeDef("ND_custom");
+    REQUIRE(!node->getNodeDef());
+    REQUIRE(node->getDeclaration() == nodeDef);
+
+    // Verify that library elements are modified through an imported copy.
+    mx::DocumentPtr imported = mx::createDocument();
+    imported->importLibrary(library);
+    mx::NodeDefPtr importedNodeDef = imported->getNodeDef("ND_custom");
+    REQUIRE(importedNodeDef);
+    REQUIRE(importedNodeDef != nodeDef);
+    importedNodeDef->addInput("extra", "float");
+    REQUIRE(nodeDef->getInputs().size() == 1);
+
+    // Verify that copies share library references.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getReferencedLibraries() == doc->getReferencedLibraries());
+    REQUIRE(*copy == *doc);
+    REQUIRE(copy->findLibraryNodeDef("ND_custom") == nodeDef);
+
+    // Verify that library cycles are rejected.
+    REQUIRE_THROWS_AS(library->referenceLibrary(doc), mx::Exception&);
+    REQUIRE_THROWS_AS(doc->referenceLibrary(doc), mx::Exception&);
+
+    // Remove library references.
+    doc->removeReferencedLibraries();
+    REQUIRE(!doc->findLibraryNodeDef("ND_custom"));
+    REQUIRE(!node->getDeclaration());
+    REQUIRE(!doc->findLibraryTypeDef("customtype"));
+}
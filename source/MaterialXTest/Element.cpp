@@ -57,6 +57,32 @@ TEST_CASE("Element", "[element]")
     REQUIRE_THROWS_AS(doc2->setChildIndex("elem1", 100), mx::Exception&);
     REQUIRE(*doc2 == *doc);
 
+    // Move elements between documents.
+    mx::DocumentPtr doc4 = mx::createDocument();
+    mx::NodeDefPtr baseDef = doc4->addNodeDef("ND_base", "float", "base");
+    baseDef->addInput("in", "float");
+    mx::NodeDefPtr derivedDef = doc4->addNodeDef("ND_derived", "float", "derived");
+    derivedDef->setInheritString(baseDef->getName());
+    REQUIRE(derivedDef->getActiveInputs().size() == 1);
+    mx::DocumentPtr doc5 = doc->copy();
+    doc5->moveChild(derivedDef);
+    REQUIRE(!doc4->getNodeDef("ND_derived"));
+    REQUIRE(doc5->getNodeDef("ND_derived") == derivedDef);
+    REQUIRE(doc5->getChildIndex("ND_derived") == 2);
+    REQUIRE(derivedDef->getDocument() == doc5);
+    REQUIRE(derivedDef->getInheritString() == baseDef->getName());
+    REQUIRE(derivedDef->getActiveInputs().empty());
+    doc5->moveChild(baseDef);
+    REQUIRE(baseDef->getInput("in")->getDocument() == doc5);
+    REQUIRE(doc5->getMatchingNodeDefs("base") == std::vector<mx::NodeDefPtr>({ baseDef }));
+    REQUIRE(derivedDef->getActiveInputs().size() == 1);
+    baseDef->setAttribute("doc", "Base nodedef");
+    REQUIRE(baseDef->getAttributeNames() == mx::StringVec({ "type", "node", "doc" }));
+    REQUIRE(doc4->getChildren().empty());
+    REQUIRE_THROWS_AS(doc5->moveChild(baseDef), mx::Exception&);
+    REQUIRE_THROWS_AS(baseDef->getInput("in")->moveChild(baseDef), mx::Exception&);
+    REQUIRE_THROWS_AS(baseDef->moveChild(baseDef), mx::Exception&);
+
     // Create and test an orphaned element.
     mx::ElementPtr orphan;
     {
@@ -66,3 +92,42 @@ TEST_CASE("Element", "[element]")
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement&);    
 }
+
+TEST_CASE("Cached values", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr constant = nodeGraph->addNode("constant");
+    mx::InputPtr input = constant->setInputValue("value", mx::Color3(0.5f));
+
+    // Repeated reads share a single parsed value.
+    mx::ValuePtr value = input->getValue();
+    REQUIRE(value->asA<mx::Color3>() == mx::Color3(0.5f));
+    REQUIRE(input->getValue() == value);
+    REQUIRE(input->getResolvedValue() == value);
+    REQUIRE(input->getDefaultValue() == value);
+
+    // Changes to the value string invalidate the cached value.
+    input->setValueString("0.25, 0.25, 0.25");
+    REQUIRE(input->getValue() != value);
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.25f));
+
+    // Changes to the type invalidate the cached value.
+    input->setValue(mx::Vector3(1.0f));
+    REQUIRE(input->getValue()->asA<mx::Vector3>() == mx::Vector3(1.0f));
+    input->setType("color3");
+    REQUIRE(input->getValue()->isA<mx::Color3>());
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(1.0f));
+
+    // Removing the value, clearing content and copying content invalidate the
+    // cached value.
+    input->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!input->getValue());
+    input->setValueString("0.75, 0.75, 0.75");
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.75f));
+    mx::InputPtr other = constant->setInputValue("other", mx::Color3(0.1f));
+    input->copyContentFrom(other);
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.1f));
+    input->clearContent();
+    REQUIRE(!input->getValue());
+}
@@ -66,3 +66,51 @@ TEST_CASE("File search path operations", "[file]")
         REQUIRE(mx::FileSearchPath(searchPath, mx::PATH_LIST_SEPARATOR).find(path).exists());
     }
 }
+
+TEST_CASE("File search path cache", "[file]")
+{
+    std::string searchPath = "libraries/stdlib" +
+                             mx::PATH_LIST_SEPARATOR +
+                             "resources/Materials/Examples";
+    mx::FilePath filename("MaterialBasic.mtlx");
+    mx::FilePath missing("MissingMaterial.mtlx");
+
+    // Without a cache, each query probes the file system.
+    mx::FileSearchPath fileSearchPath(searchPath);
+    REQUIRE(!fileSearchPath.getCacheEnabled());
+    size_t probeCount = mx::FileSearchPath::getProbeCount();
+    mx::FilePath resolved = fileSearchPath.find(filename);
+    REQUIRE(resolved.exists());
+    REQUIRE(mx::FileSearchPath::getProbeCount() == probeCount + 3);
+    fileSearchPath.find(filename);
+    REQUIRE(mx::FileSearchPath::getProbeCount() == probeCount + 6);
+
+    // With a cache, repeated queries for found and missing files don't
+    // probe the file system.
+    fileSearchPath.setCacheEnabled(true);
+    REQUIRE(fileSearchPath.getCacheEnabled());
+    REQUIRE(fileSearchPath.find(filename) == resolved);
+    REQUIRE(fileSearchPath.find(missing) == missing);
+    probeCount = mx::FileSearchPath::getProbeCount();
+    REQUIRE(fileSearchPath.find(filename) == resolved);
+    REQUIRE(fileSearchPath.find(missing) == missing);
+    REQUIRE(mx::FileSearchPath::getProbeCount() == probeCount);
+
+    // Copies share the cache until they are modified.
+    mx::FileSearchPath copy = fileSearchPath;
+    REQUIRE(copy.find(filename) == resolved);
+    REQUIRE(mx::FileSearchPath::getProbeCount() == probeCount);
+    copy.append(mx::FilePath("resources/Materials/TestSuite"));
+    REQUIRE(copy.find(filename) == resolved);
+    REQUIRE(mx::FileSearchPath::getProbeCount() > probeCount);
+    probeCount = mx::FileSearchPath::getProbeCount();
+    REQUIRE(fileSearchPath.find(filename) == resolved);
+    REQUIRE(mx::FileSearchPath::getProbeCount() == probeCount);
+
+    // Clearing the cache causes the file system to be probed again.
+    fileSearchPath.clearCache();
+    REQUIRE(fileSearchPath.find(missing) == missing);
+    REQUIRE(mx::FileSearchPath::getProbeCount() == probeCount + 3);
+    fileSearchPath.setCacheEnabled(false);
+    REQUIRE(!fileSearchPath.getCacheEnabled());
+}
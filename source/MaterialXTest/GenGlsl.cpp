@@ -15,6 +15,14 @@
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
 #include <MaterialXGenGlsl/GlslSyntax.h>
 
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderGraph.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <algorithm>
+#include <sstream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("GenShader: GLSL Syntax Check", "[genglsl]")
@@ -133,3 +141,373 @@ TEST_CASE("GenShader: GLSL Shader Generation", "[genglsl]")
 {
     generateGLSLCode();
 }
+
+TEST_CASE("GenShader: GLSL parallel generation", "[genglsl]")
+{
+    const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite/stdlib");
+    const mx::FilePath libSearchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    const size_t THREAD_COUNT = 8;
+    const int ROUND_COUNT = 3;
+
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, libSearchPath, libraries);
+
+    // Gather the renderable elements of the stdlib test suite.
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::loadDocuments(testRootPath, { "_options.mtlx" }, documents, documentPaths);
+    mx::XmlReadOptions importOptions;
+    importOptions.skipDuplicateElements = true;
+    std::vector<mx::TypedElementPtr> elements;
+    for (mx::DocumentPtr doc : documents)
+    {
+        doc->importLibrary(libraries, &importOptions);
+        mx::findRenderableElements(doc, elements);
+    }
+    REQUIRE(!elements.empty());
+
+    // Generate all shaders serially.
+    mx::GenContext serialContext(mx::GlslShaderGenerator::create());
+    serialContext.registerSourceCodeSearchPath(libSearchPath);
+    std::vector<mx::ShaderPtr> serialShaders;
+    for (mx::TypedElementPtr element : elements)
+    {
+        try
+        {
+            serialShaders.push_back(serialContext.getShaderGenerator().generate(element->getName(), element, serialContext));
+        }
+        catch (mx::Exception&)
+        {
+            serialShaders.push_back(nullptr);
+        }
+    }
+
+    // Verify that a copied context has its own implementation cache.
+    REQUIRE(serialContext.findNodeImplementation("IM_constant_color3_genglsl"));
+    mx::GenContext copiedContext(serialContext);
+    REQUIRE(!copiedContext.findNodeImplementation("IM_constant_color3_genglsl"));
+
+    // Verify that repeated parallel generation produces identical shaders.
+    mx::GenContext parallelContext(mx::GlslShaderGenerator::create());
+    parallelContext.registerSourceCodeSearchPath(libSearchPath);
+    for (int round = 0; round < ROUND_COUNT; round++)
+    {
+        mx::StringVec errors;
+        std::vector<mx::ShaderPtr> parallelShaders = mx::generateShaders(elements, parallelContext, &errors, THREAD_COUNT);
+        REQUIRE(parallelShaders.size() == elements.size());
+        REQUIRE(errors.size() == elements.size());
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            REQUIRE((serialShaders[i] == nullptr) == (parallelShaders[i] == nullptr));
+            REQUIRE(errors[i].empty() == (parallelShaders[i] != nullptr));
+            if (!serialShaders[i])
+            {
+                continue;
+            }
+            REQUIRE(parallelShaders[i]->numStages() == serialShaders[i]->numStages());
+            for (size_t j = 0; j < serialShaders[i]->numStages(); j++)
+            {
+                REQUIRE(parallelShaders[i]->getStage(j).getSourceCode() == serialShaders[i]->getStage(j).getSourceCode());
+            }
+        }
+    }
+
+    // Verify that failures are rethrown when no error vector is provided.
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    invalidDoc->importLibrary(libraries);
+    mx::NodePtr invalidNode = invalidDoc->addNode("unknown_category", "invalid", "color3");
+    std::vector<mx::TypedElementPtr> invalidElements = { elements[0], invalidNode };
+    REQUIRE_THROWS(mx::generateShaders(invalidElements, parallelContext, nullptr, THREAD_COUNT));
+}
+
+TEST_CASE("GenShader: GLSL shader graph templates", "[genglsl]")
+{
+    const mx::FilePath libSearchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    const int MATERIAL_COUNT = 3;
+
+    const std::string TEMPLATE_KEY = "shaderref:ND_standard_surface_surfaceshader";
+
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, libSearchPath, doc);
+
+    // Create materials that bind different values to the same nodedef.
+    std::vector<mx::ShaderRefPtr> shaderRefs;
+    for (int i = 0; i < MATERIAL_COUNT; i++)
+    {
+        mx::MaterialPtr material = doc->addMaterial("material" + std::to_string(i));
+        mx::ShaderRefPtr shaderRef = material->addShaderRef("surface" + std::to_string(i), "standard_surface");
+        shaderRef->addBindInput("base_color", "color3")->setValue(mx::Color3(i * 0.25f));
+        shaderRefs.push_back(shaderRef);
+    }
+
+    // Generate all shaders in a shared context, which builds a single
+    // template for the nodedef.
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(libSearchPath);
+    REQUIRE(!context.findShaderGraphTemplate(TEMPLATE_KEY, doc));
+    std::vector<mx::ShaderPtr> shaders;
+    for (mx::ShaderRefPtr shaderRef : shaderRefs)
+    {
+        shaders.push_back(context.getShaderGenerator().generate(shaderRef->getName(), shaderRef, context));
+        REQUIRE(shaders.back());
+    }
+    mx::ConstShaderGraphPtr graphTemplate = context.findShaderGraphTemplate(TEMPLATE_KEY, doc);
+    REQUIRE(graphTemplate);
+
+    for (int i = 0; i < MATERIAL_COUNT; i++)
+    {
+        // Verify that each shader holds the values and paths of its own bindings.
+        const mx::ShaderStage& stage = shaders[i]->getStage(mx::Stage::PIXEL);
+        const mx::ShaderPort* baseColor = stage.getUniformBlock(mx::HW::PUBLIC_UNIFORMS).find("base_color");
+        REQUIRE(baseColor);
+        REQUIRE(baseColor->getValue()->asA<mx::Color3>() == mx::Color3(i * 0.25f));
+        REQUIRE(baseColor->getPath() == shaderRefs[i]->getBindInput("base_color")->getNamePath());
+        const mx::ShaderPort* baseWeight = stage.getUniformBlock(mx::HW::PUBLIC_UNIFORMS).find("base");
+        REQUIRE(baseWeight);
+        REQUIRE(baseWeight->getPath() == shaderRefs[i]->getNamePath() + mx::NAME_PATH_SEPARATOR + "base");
+
+        // Verify that shaders built from the shared template match shaders
+        // built in a fresh context.
+        mx::GenContext freshContext(mx::GlslShaderGenerator::create());
+        freshContext.registerSourceCodeSearchPath(libSearchPath);
+        mx::ShaderPtr freshShader = freshContext.getShaderGenerator().generate(shaderRefs[i]->getName(), shaderRefs[i], freshContext);
+        REQUIRE(freshShader->numStages() == shaders[i]->numStages());
+        for (size_t j = 0; j < freshShader->numStages(); j++)
+        {
+            REQUIRE(freshShader->getStage(j).getSourceCode() == shaders[i]->getStage(j).getSourceCode());
+        }
+    }
+
+    // Verify that the template is not modified by generation.
+    REQUIRE(context.findShaderGraphTemplate(TEMPLATE_KEY, doc) == graphTemplate);
+    REQUIRE(graphTemplate->getNode("ND_standard_surface_surfaceshader"));
+    REQUIRE(!graphTemplate->getNode("surface0"));
+
+    // Verify that a shaderref may take the name of a default geometric node
+    // of the template.
+    mx::MaterialPtr geomMaterial = doc->addMaterial("geom_material");
+    mx::ShaderRefPtr geomShaderRef = geomMaterial->addShaderRef("geomprop_Nworld", "standard_surface");
+    REQUIRE(graphTemplate->getNode("geomprop_Nworld"));
+    mx::ShaderPtr geomShader = context.getShaderGenerator().generate(geomShaderRef->getName(), geomShaderRef, context);
+    REQUIRE(geomShader);
+    const mx::ShaderNode* geomShaderNode = geomShader->getGraph().getNode("geomprop_Nworld");
+    REQUIRE(geomShaderNode);
+    REQUIRE(geomShaderNode->hasClassification(mx::ShaderNode::Classification::SHADER));
+    REQUIRE(context.findShaderGraphTemplate(TEMPLATE_KEY, doc) == graphTemplate);
+
+    // Verify that templates are not shared between documents, and that a
+    // template does not keep its document alive.
+    mx::DocumentPtr otherDoc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, libSearchPath, otherDoc);
+    mx::ShaderRefPtr otherShaderRef = otherDoc->addMaterial("material")->addShaderRef("surface", "standard_surface");
+    REQUIRE(context.getShaderGenerator().generate(otherShaderRef->getName(), otherShaderRef, context));
+    mx::ConstShaderGraphPtr otherTemplate = context.findShaderGraphTemplate(TEMPLATE_KEY, otherDoc);
+    REQUIRE(otherTemplate);
+    REQUIRE(otherTemplate != graphTemplate);
+    REQUIRE(!context.findShaderGraphTemplate(TEMPLATE_KEY, doc));
+    std::weak_ptr<mx::Document> otherDocRef = otherDoc;
+    otherShaderRef = nullptr;
+    otherDoc = nullptr;
+    REQUIRE(otherDocRef.expired());
+
+    // Verify that templates are rebuilt across edits to the nodedefs of a
+    // document, and across changes to the generation options.
+    REQUIRE(context.getShaderGenerator().generate(shaderRefs[0]->getName(), shaderRefs[0], context));
+    graphTemplate = context.findShaderGraphTemplate(TEMPLATE_KEY, doc);
+    REQUIRE(graphTemplate);
+    doc->addNodeDef("ND_template_test", "float", "template_test");
+    REQUIRE(!context.findShaderGraphTemplate(TEMPLATE_KEY, doc));
+    REQUIRE(context.getShaderGenerator().generate(shaderRefs[0]->getName(), shaderRefs[0], context));
+    mx::ConstShaderGraphPtr editedTemplate = context.findShaderGraphTemplate(TEMPLATE_KEY, doc);
+    REQUIRE(editedTemplate);
+    REQUIRE(editedTemplate != graphTemplate);
+
+    context.getOptions().hwTransparency = true;
+    REQUIRE(!context.findShaderGraphTemplate(TEMPLATE_KEY, doc));
+    REQUIRE(context.getShaderGenerator().generate(shaderRefs[0]->getName(), shaderRefs[0], context));
+    mx::ConstShaderGraphPtr optionsTemplate = context.findShaderGraphTemplate(TEMPLATE_KEY, doc);
+    REQUIRE(optionsTemplate);
+    REQUIRE(optionsTemplate != editedTemplate);
+
+    // Verify that templates may be cleared.
+    context.clearShaderGraphTemplates();
+    REQUIRE(!context.findShaderGraphTemplate(TEMPLATE_KEY, doc));
+}
+
+TEST_CASE("GenShader: GLSL graph optimization", "[genglsl]")
+{
+    const mx::FilePath libSearchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib" }, libSearchPath, doc);
+
+    // Create a graph with two identical branches and arithmetic on constants.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("optimize_graph");
+    mx::NodePtr scaled[2];
+    for (int i = 0; i < 2; i++)
+    {
+        mx::NodePtr position = nodeGraph->addNode("position", "position" + std::to_string(i), "vector3");
+        scaled[i] = nodeGraph->addNode("multiply", "scaled" + std::to_string(i), "vector3");
+        scaled[i]->setConnectedNode("in1", position);
+        scaled[i]->setInputValue("in2", mx::Vector3(2.0f));
+    }
+    mx::NodePtr sum = nodeGraph->addNode("add", "sum", "vector3");
+    sum->setConnectedNode("in1", scaled[0]);
+    sum->setConnectedNode("in2", scaled[1]);
+
+    mx::NodePtr unit = nodeGraph->addNode("multiply", "unit", "vector3");
+    unit->setInputValue("in1", mx::Vector3(0.5f));
+    unit->setInputValue("in2", 2.0f);
+    mx::NodePtr blend = nodeGraph->addNode("mix", "blend", "vector3");
+    blend->setInputValue("fg", mx::Vector3(1.0f, 0.0f, 0.0f));
+    blend->setInputValue("bg", mx::Vector3(0.0f, 0.0f, 1.0f));
+    blend->setInputValue("mix", 0.25f);
+    mx::NodePtr offset = nodeGraph->addNode("add", "offset", "vector3");
+    offset->setConnectedNode("in1", unit);
+    offset->setConnectedNode("in2", blend);
+    mx::NodePtr swizzle = nodeGraph->addNode("swizzle", "swizzle", "vector3");
+    swizzle->setConnectedNode("in", offset);
+    swizzle->setParameterValue("channels", std::string("zyx"));
+
+    mx::NodePtr result = nodeGraph->addNode("add", "result", "vector3");
+    result->setConnectedNode("in1", sum);
+    result->setConnectedNode("in2", swizzle);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "vector3");
+    output->setConnectedNode(result);
+    REQUIRE(doc->validate());
+
+    // Count the statements in the main function of the pixel stage,
+    // skipping the declarations of literal constants.
+    auto countStatements = [](const mx::Shader& shader)
+    {
+        const std::string& source = shader.getStage(mx::Stage::PIXEL).getSourceCode();
+        std::istringstream mainBody(source.substr(source.find("void main()")));
+        size_t count = 0;
+        for (std::string line; std::getline(mainBody, line); )
+        {
+            const size_t start = line.find_first_not_of(' ');
+            if (line.find(';') != std::string::npos && line.compare(start, 6, "const ") != 0)
+            {
+                count++;
+            }
+        }
+        return count;
+    };
+
+    // With the complete interface, all unconnected inputs are published as
+    // uniforms, so no nodes can be folded or merged, and each node and the
+    // final output take one statement.
+    mx::GenContext completeContext(mx::GlslShaderGenerator::create());
+    completeContext.registerSourceCodeSearchPath(libSearchPath);
+    completeContext.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    mx::ShaderPtr completeShader = completeContext.getShaderGenerator().generate("optimize_complete", output, completeContext);
+    REQUIRE(completeShader);
+    REQUIRE(completeShader->getGraph().getNodes().size() == nodeGraph->getNodes().size());
+    REQUIRE(countStatements(*completeShader) == nodeGraph->getNodes().size() + 1);
+    REQUIRE(completeShader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS).find("blend_mix"));
+
+    // With the reduced interface, constant arithmetic is folded and the
+    // duplicate branch is merged, leaving one position node, one multiply
+    // and two adds.
+    mx::GenContext reducedContext(mx::GlslShaderGenerator::create());
+    reducedContext.registerSourceCodeSearchPath(libSearchPath);
+    reducedContext.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderPtr reducedShader = reducedContext.getShaderGenerator().generate("optimize_reduced", output, reducedContext);
+    REQUIRE(reducedShader);
+    REQUIRE(reducedShader->getGraph().getNodes().size() == 4);
+    REQUIRE(reducedShader->getGraph().getNode("position0"));
+    REQUIRE(!reducedShader->getGraph().getNode("position1"));
+    REQUIRE(!reducedShader->getGraph().getNode("swizzle"));
+    REQUIRE(countStatements(*reducedShader) == 5);
+    REQUIRE(countStatements(*reducedShader) < countStatements(*completeShader));
+
+    // The folded constant is (0.5 * 2) + mix((0, 0, 1), (1, 0, 0), 0.25), swizzled.
+    const mx::ShaderInput* folded = reducedShader->getGraph().getNode("result")->getInput("in2");
+    REQUIRE(!folded->getConnection());
+    REQUIRE(folded->getValue()->asA<mx::Vector3>() == mx::Vector3(1.75f, 1.0f, 1.25f));
+    const std::string& reducedSource = reducedShader->getStage(mx::Stage::PIXEL).getSourceCode();
+    REQUIRE(reducedSource.find("vec3(1.750000, 1.000000, 1.250000)") != std::string::npos);
+}
+
+TEST_CASE("GenShader: GLSL nested convolution", "[genglsl]")
+{
+    const mx::FilePath libSearchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    const int MAX_DEPTH = 4;
+
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib" }, libSearchPath, doc);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(libSearchPath);
+
+    // Generate shaders for chains of 7x7 blurs of increasing depth.
+    std::vector<size_t> sourceSizes;
+    for (int depth = 1; depth <= MAX_DEPTH; depth++)
+    {
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("blur_graph" + std::to_string(depth));
+        mx::NodePtr upstream = nodeGraph->addNode("image", "image", "color3");
+        upstream->setParameterValue("file", std::string("image.png"), mx::FILENAME_TYPE_STRING);
+        for (int i = 0; i < depth; i++)
+        {
+            mx::NodePtr blur = nodeGraph->addNode("blur", "blur" + std::to_string(i), "color3");
+            blur->setConnectedNode("in", upstream);
+            blur->setParameterValue("size", 1.0f);
+            upstream = blur;
+        }
+        mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+        output->setConnectedNode(upstream);
+
+        mx::ShaderPtr shader = context.getShaderGenerator().generate(nodeGraph->getName(), output, context);
+        REQUIRE(shader);
+        const std::string& source = shader->getStage(mx::Stage::PIXEL).getSourceCode();
+        sourceSizes.push_back(source.size());
+
+        // Each blur evaluates its upstream graph through a single function.
+        for (int i = 0; i < depth; i++)
+        {
+            const std::string functionName = "blur" + std::to_string(i) + "_out_upstream";
+            REQUIRE(source.find("vec3 " + functionName + "(") != std::string::npos);
+        }
+
+        // The image is sampled only within its definition, the main function
+        // and the upstream function of the first blur.
+        size_t imageCalls = 0;
+        for (size_t pos = source.find("mx_image_color3("); pos != std::string::npos; pos = source.find("mx_image_color3(", pos + 1))
+        {
+            imageCalls++;
+        }
+        REQUIRE(imageCalls == 3);
+    }
+
+    // Each additional blur adds a similar amount of code, rather than
+    // multiplying the code of the blurs upstream of it.
+    const size_t firstIncrease = sourceSizes[1] - sourceSizes[0];
+    for (int i = 2; i < MAX_DEPTH; i++)
+    {
+        const size_t increase = sourceSizes[i] - sourceSizes[i - 1];
+        REQUIRE(increase < firstIncrease * 3 / 2);
+    }
+
+    // A nested blur with a single sample also evaluates its upstream graph
+    // through its function, since the upstream nodes are not emitted
+    // within the function of the outer blur.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("single_sample_graph");
+    mx::NodePtr image = nodeGraph->addNode("image", "image", "color3");
+    image->setParameterValue("file", std::string("image.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr innerBlur = nodeGraph->addNode("blur", "inner", "color3");
+    innerBlur->setConnectedNode("in", image);
+    innerBlur->setParameterValue("size", 0.0f);
+    mx::NodePtr outerBlur = nodeGraph->addNode("blur", "outer", "color3");
+    outerBlur->setConnectedNode("in", innerBlur);
+    outerBlur->setParameterValue("size", 1.0f);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(outerBlur);
+
+    mx::ShaderPtr shader = context.getShaderGenerator().generate(nodeGraph->getName(), output, context);
+    REQUIRE(shader);
+    const std::string& source = shader->getStage(mx::Stage::PIXEL).getSourceCode();
+    const size_t outerFunction = source.find("vec3 outer_out_upstream(");
+    REQUIRE(outerFunction != std::string::npos);
+    const size_t outerFunctionEnd = source.find("return ", outerFunction);
+    REQUIRE(source.find("inner_out_upstream(", outerFunction) < outerFunctionEnd);
+}
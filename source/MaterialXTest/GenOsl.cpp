@@ -6,18 +6,23 @@
 #include <MaterialXTest/Catch/catch.hpp>
 
 #include <MaterialXTest/GenShaderUtil.h>
+#include <MaterialXTest/TestUtil.h>
 
 #include <MaterialXCore/Document.h>
 
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
 
 #include <MaterialXGenOsl/OslShaderGenerator.h>
 #include <MaterialXGenOsl/OslSyntax.h>
 
 #include <MaterialXGenShader/DefaultColorManagementSystem.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderCache.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <fstream>
+
 
 namespace mx = MaterialX;
 
@@ -110,6 +115,128 @@ TEST_CASE("GenShader: OSL Unique Names", "[genosl]")
     GenShaderUtil::testUniqueNames(context, mx::Stage::PIXEL);
 }
 
+TEST_CASE("GenShader: OSL Shader Cache", "[genosl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("cache_graph");
+    mx::NodePtr constant = nodeGraph->addNode("constant", "constant1", "color3");
+    constant->setParameterValue("value", mx::Color3(0.1f, 0.2f, 0.3f));
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", constant);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(multiply);
+
+    mx::GenContext context(mx::OslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/osl"));
+
+    // Verify that repeated requests are served from memory.
+    mx::ShaderCache cache;
+    mx::ShaderPtr shader = cache.getShader("cached", output, context);
+    REQUIRE(shader);
+    REQUIRE(cache.getShader("cached", output, context) == shader);
+    REQUIRE(cache.getMissCount() == 1);
+    REQUIRE(cache.getMemoryHitCount() == 1);
+
+    // Verify that the key reflects the upstream graph, its node definitions,
+    // the generation options and the shader name.
+    const std::string key = cache.getKey("cached", output, context);
+    constant->setParameterValue("value", mx::Color3(0.4f, 0.5f, 0.6f));
+    REQUIRE(cache.getKey("cached", output, context) != key);
+    constant->setParameterValue("value", mx::Color3(0.1f, 0.2f, 0.3f));
+    REQUIRE(cache.getKey("cached", output, context) == key);
+    mx::NodeDefPtr multiplyNodeDef = multiply->getNodeDef();
+    REQUIRE(multiplyNodeDef);
+    mx::InputPtr nodeDefInput = multiplyNodeDef->getInput("in2");
+    REQUIRE(!nodeDefInput->hasValue());
+    nodeDefInput->setValueString("2.0, 2.0, 2.0");
+    REQUIRE(cache.getKey("cached", output, context) != key);
+    nodeDefInput->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(cache.getKey("cached", output, context) == key);
+    context.getOptions().fileTextureVerticalFlip = true;
+    REQUIRE(cache.getKey("cached", output, context) != key);
+    context.getOptions().fileTextureVerticalFlip = false;
+    REQUIRE(cache.getKey("renamed", output, context) != key);
+    REQUIRE(mx::ShaderCache(mx::FilePath(), "salt").getKey("cached", output, context) != key);
+    mx::GenContext searchContext(mx::OslShaderGenerator::create());
+    searchContext.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/osl"));
+    searchContext.registerSourceCodeSearchPath(searchPath);
+    REQUIRE(cache.getKey("cached", output, searchContext) != key);
+
+    // Verify that source code is shared through the cache directory.
+    TestUtil::TemporaryDirectory cacheDirectory;
+    mx::ShaderCache writingCache(cacheDirectory.getPath());
+    mx::StringMap sourceCode = writingCache.getSourceCode("cached", output, context);
+    REQUIRE(writingCache.getMissCount() == 1);
+    REQUIRE(sourceCode[mx::Stage::PIXEL] == shader->getSourceCode(mx::Stage::PIXEL));
+    mx::ShaderCache readingCache(cacheDirectory.getPath());
+    REQUIRE(readingCache.getSourceCode("cached", output, context) == sourceCode);
+    REQUIRE(readingCache.getDiskHitCount() == 1);
+    REQUIRE(readingCache.getMissCount() == 0);
+}
+
+TEST_CASE("GenShader: OSL Shader Cache Includes", "[genosl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    // Write an implementation whose source includes another file.
+    TestUtil::TemporaryDirectory sourceDirectory;
+    const mx::FilePath includePath = sourceDirectory.getPath() / mx::FilePath("cache_include.h");
+    {
+        std::ofstream file((sourceDirectory.getPath() / mx::FilePath("cache_impl.osl")).asString());
+        file << "#include \"cache_include.h\"\n";
+        file << "void mx_cache_test(float in, output float result)\n{\n    result = cache_scale(in);\n}\n";
+    }
+    {
+        std::ofstream file(includePath.asString());
+        file << "float cache_scale(float x) { return x * 2.0; }\n";
+    }
+
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_cache_test", "float", "cache_test");
+    nodeDef->addInput("in", "float");
+    mx::ImplementationPtr impl = doc->addImplementation("IM_cache_test_genosl");
+    impl->setNodeDef(nodeDef);
+    impl->setFile("cache_impl.osl");
+    impl->setFunction("mx_cache_test");
+    impl->setLanguage(mx::OslShaderGenerator::LANGUAGE);
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("include_graph");
+    mx::NodePtr node = nodeGraph->addNode("cache_test", "cache_test1", "float");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(node);
+
+    mx::GenContext context(mx::OslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/osl"));
+    context.registerSourceCodeSearchPath(sourceDirectory.getPath());
+
+    mx::ShaderCache cache;
+    mx::ShaderPtr shader = cache.getShader("included", output, context);
+    REQUIRE(shader);
+    REQUIRE(shader->getSourceCode(mx::Stage::PIXEL).find("return x * 2.0;") != std::string::npos);
+    REQUIRE(cache.getShader("included", output, context) == shader);
+    REQUIRE(cache.getMissCount() == 1);
+
+    // Verify that editing the included file on disk regenerates the shader.
+    {
+        std::ofstream file(includePath.asString());
+        file << "float cache_scale(float x) { return x * 3.0; }\n";
+    }
+    TestUtil::setModificationTime(includePath, 1000000000);
+    mx::ShaderPtr editedShader = cache.getShader("included", output, context);
+    REQUIRE(editedShader);
+    REQUIRE(editedShader != shader);
+    REQUIRE(editedShader->getSourceCode(mx::Stage::PIXEL).find("return x * 3.0;") != std::string::npos);
+    REQUIRE(cache.getMissCount() == 2);
+    REQUIRE(cache.getShader("included", output, context) == editedShader);
+    REQUIRE(cache.getMissCount() == 2);
+}
+
 class OslShaderGeneratorTester : public GenShaderUtil::ShaderGeneratorTester
 {
   public:
@@ -152,6 +279,35 @@ class OslShaderGeneratorTester : public GenShaderUtil::ShaderGeneratorTester
     }
 };
 
+TEST_CASE("GenShader: OSL convolution", "[genosl]")
+{
+    const mx::FilePath libSearchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    const mx::FilePath testPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite/stdlib/convolution/blur.mtlx");
+
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib" }, libSearchPath, doc);
+    mx::readFromXmlFile(doc, testPath);
+
+    mx::GenContext context(mx::OslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(libSearchPath);
+    context.registerSourceCodeSearchPath(libSearchPath / mx::FilePath("stdlib/osl"));
+
+    std::vector<mx::TypedElementPtr> elements;
+    mx::findRenderableElements(doc, elements);
+    REQUIRE(!elements.empty());
+    for (mx::TypedElementPtr element : elements)
+    {
+        // Constants and uniforms are declared within the OSL shader body,
+        // so samples are emitted inline rather than through upstream
+        // functions that could not reference them.
+        mx::ShaderPtr shader = context.getShaderGenerator().generate(element->getParent()->getName(), element, context);
+        REQUIRE(shader);
+        const std::string& source = shader->getSourceCode(mx::Stage::PIXEL);
+        REQUIRE(source.find("_upstream(") == std::string::npos);
+        REQUIRE(source.find("_samples[0] = ") != std::string::npos);
+    }
+}
+
 static void generateOSLCode()
 {
     const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
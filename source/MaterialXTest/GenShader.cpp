@@ -17,6 +17,7 @@
 #include <MaterialXGenShader/Util.h>
 
 #include <MaterialXTest/GenShaderUtil.h>
+#include <MaterialXTest/TestUtil.h>
 
 #include <cstdlib>
 #include <fstream>
@@ -85,6 +86,47 @@ TEST_CASE("GenShader: TypeDesc Check", "[genshader]")
     REQUIRE_THROWS(mx::TypeDesc::get("bar"));
 }
 
+TEST_CASE("GenShader: Source File Cache", "[genshader]")
+{
+    // Write a source file and read it through the cache.
+    TestUtil::TemporaryDirectory tempDir;
+    mx::FilePath sourcePath = tempDir.getPath() / mx::FilePath("source_file_cache_test.glsl");
+    {
+        std::ofstream file(sourcePath.asString());
+        file << "void first()\n{\n}\n";
+    }
+    size_t readCount = mx::getSourceFileReadCount();
+    mx::ConstSourceFilePtr sourceFile = mx::readSourceFile(sourcePath);
+    REQUIRE(sourceFile);
+    REQUIRE(sourceFile->getContents() == "void first()\n{\n}\n");
+    REQUIRE(sourceFile->getLines() == mx::StringVec({ "void first()", "{", "}" }));
+    REQUIRE(mx::getSourceFileReadCount() == readCount + 1);
+
+    // Verify that repeated reads share the cached contents.
+    REQUIRE(mx::readSourceFile(sourcePath) == sourceFile);
+    REQUIRE(mx::getSourceFileReadCount() == readCount + 1);
+
+    // Verify that a modified file is read again.
+    {
+        std::ofstream file(sourcePath.asString());
+        file << "void second()\n{\n}";
+    }
+    TestUtil::setModificationTime(sourcePath, 1000000000);
+    sourceFile = mx::readSourceFile(sourcePath);
+    REQUIRE(sourceFile->getLines() == mx::StringVec({ "void second()", "{", "}" }));
+    REQUIRE(mx::getSourceFileReadCount() == readCount + 2);
+    REQUIRE(mx::readSourceFile(sourcePath) == sourceFile);
+    REQUIRE(mx::getSourceFileReadCount() == readCount + 2);
+
+    // Verify that a file is read again once the cache is cleared.
+    mx::clearSourceFileCache();
+    REQUIRE(mx::readSourceFile(sourcePath) != sourceFile);
+    REQUIRE(mx::getSourceFileReadCount() == readCount + 3);
+
+    // Read a non-existent file.
+    REQUIRE(!mx::readSourceFile(mx::FilePath("NonExistent.glsl")));
+}
+
 TEST_CASE("GenShader: OSL Reference Implementation Check", "[genshader]")
 {
     mx::DocumentPtr doc = mx::createDocument();
@@ -10,6 +10,8 @@
 #include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <MaterialXFormat/Util.h>
+
 namespace mx = MaterialX;
 
 namespace GenShaderUtil
@@ -17,9 +19,7 @@ namespace GenShaderUtil
 
 void loadLibrary(const mx::FilePath& file, mx::DocumentPtr doc)
 {
-    mx::DocumentPtr libDoc = mx::createDocument();
-    mx::readFromXmlFile(libDoc, file);
-    libDoc->setSourceUri(file);
+    mx::ConstDocumentPtr libDoc = mx::readLibraryFile(file);
     mx::CopyOptions copyOptions;
     copyOptions.skipDuplicateElements = true;
     doc->importLibrary(libDoc, &copyOptions);
@@ -31,6 +31,7 @@ void loadLibraries(const mx::StringVec& libraryNames,
                    const mx::StringSet* excludeFiles)
 {
     const std::string MTLX_EXTENSION("mtlx");
+    std::vector<mx::FilePath> libraryFiles;
     for (const std::string& library : libraryNames)
     {
         mx::StringVec librarySubPaths;
@@ -48,10 +49,14 @@ void loadLibraries(const mx::StringVec& libraryNames,
                 {
                     continue;
                 }
-                loadLibrary(mx::FilePath(path)/ filename, doc);
+                libraryFiles.push_back(mx::FilePath(path) / filename);
             }
         }
     }
+
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+    mx::loadLibraries(libraryFiles, doc, &copyOptions);
 }
 
 bool getShaderSource(mx::GenContext& context,
@@ -85,6 +85,57 @@ TEST_CASE("Geom elements", "[geom]")
     REQUIRE(!collection1->matchesGeomString("/root/scene2"));
 }
 
+TEST_CASE("Flattened collections", "[geom]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Create a chain of nested collections.
+    mx::CollectionPtr collection1 = doc->addCollection("collection1");
+    collection1->setIncludeGeom("/scene1, /scene2");
+    collection1->setExcludeGeom("/scene1/sphere2");
+    mx::CollectionPtr collection2 = doc->addCollection("collection2");
+    collection2->setIncludeGeom("/scene3");
+    collection2->setIncludeCollection(collection1);
+    mx::CollectionPtr collection3 = doc->addCollection("collection3");
+    collection3->setExcludeGeom("/scene2/cube1");
+    collection3->setIncludeCollection(collection2);
+
+    // Test the flattened form of the outermost collection.
+    mx::ConstFlattenedCollectionPtr flattened = collection3->getFlattenedCollection();
+    REQUIRE(flattened->getName() == "collection3");
+    REQUIRE(flattened->getMembers().size() == 3);
+    REQUIRE(flattened->getMembers()[2].includeGeom.size() == 2);
+    REQUIRE(!flattened->hasIncludeCycle());
+    REQUIRE(collection3->getFlattenedCollection() == flattened);
+
+    // Test single and batch membership queries.
+    mx::StringVec geoms = { "/scene1/sphere1", "/scene1/sphere2", "/scene2/cube1",
+                            "/scene2/cube2", "/scene3", "/scene4", "/scene1/sphere2, /scene3" };
+    std::vector<bool> expected = { true, false, false, true, true, false, true };
+    REQUIRE(collection3->matchesGeomStrings(geoms) == expected);
+    for (size_t i = 0; i < geoms.size(); i++)
+    {
+        REQUIRE(collection3->matchesGeomString(geoms[i]) == expected[i]);
+    }
+
+    // Verify that modifying a collection in the chain is reflected.
+    collection1->setExcludeGeom("");
+    REQUIRE(collection3->getFlattenedCollection() != flattened);
+    REQUIRE(collection3->matchesGeomString("/scene1/sphere2"));
+    doc->removeCollection(collection2->getName());
+    REQUIRE(!collection3->matchesGeomString("/scene1/sphere1"));
+    REQUIRE(collection3->getFlattenedCollection()->getMembers().size() == 1);
+
+    // Create and test an include cycle.
+    collection2 = doc->addCollection("collection2");
+    collection2->setIncludeCollection(collection3);
+    collection3->setIncludeCollection(collection2);
+    REQUIRE(collection3->getFlattenedCollection()->hasIncludeCycle());
+    REQUIRE(!collection3->matchesGeomString("/scene2/cube1"));
+    REQUIRE_THROWS_AS(collection3->matchesGeomString("/scene1"), mx::ExceptionFoundCycle&);
+    REQUIRE_THROWS_AS(collection3->matchesGeomStrings({ "/scene1" }), mx::ExceptionFoundCycle&);
+}
+
 TEST_CASE("GeomPropDef", "[geom]")
 {
     mx::DocumentPtr doc = mx::createDocument();
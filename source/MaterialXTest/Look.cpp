@@ -7,8 +7,89 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <random>
+
 namespace mx = MaterialX;
 
+namespace {
+
+// Return the material assignments that bind the given material to the given
+// geometry string, by scanning all looks of the document.
+std::vector<mx::MaterialAssignPtr> scanGeometryBindings(mx::MaterialPtr material, const std::string& geom)
+{
+    std::vector<mx::MaterialAssignPtr> matAssigns;
+    for (mx::LookPtr look : material->getDocument()->getLooks())
+    {
+        for (mx::MaterialAssignPtr matAssign : look->getMaterialAssigns())
+        {
+            if (matAssign->getReferencedMaterial() == material)
+            {
+                mx::CollectionPtr coll = matAssign->getCollection();
+                if (mx::geomStringsMatch(geom, matAssign->getActiveGeom()) ||
+                    (coll && coll->matchesGeomString(geom)))
+                {
+                    matAssigns.push_back(matAssign);
+                }
+            }
+        }
+    }
+    return matAssigns;
+}
+
+// Return a random geometry path with up to the given depth.
+std::string randomGeomPath(std::mt19937& rng, size_t maxDepth, size_t branching)
+{
+    std::string path;
+    size_t depth = 1 + rng() % maxDepth;
+    for (size_t i = 0; i < depth; i++)
+    {
+        path += "/node" + std::to_string(rng() % branching);
+    }
+    return path;
+}
+
+// Add random looks, collections and material assignments to a document.
+void addRandomAssignments(mx::DocumentPtr doc, std::mt19937& rng, size_t assignCount, size_t maxDepth, size_t branching)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        doc->addMaterial("material" + std::to_string(i));
+    }
+    std::vector<mx::CollectionPtr> collections;
+    for (size_t i = 0; i < assignCount / 4 + 1; i++)
+    {
+        mx::CollectionPtr collection = doc->addCollection("collection" + std::to_string(i));
+        collection->setIncludeGeom(randomGeomPath(rng, maxDepth, branching) + ", " + randomGeomPath(rng, maxDepth, branching));
+        if (rng() % 2)
+        {
+            collection->setExcludeGeom(randomGeomPath(rng, maxDepth + 1, branching));
+        }
+        if (!collections.empty() && rng() % 3 == 0)
+        {
+            collection->setIncludeCollection(collections[rng() % collections.size()]);
+        }
+        collections.push_back(collection);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        mx::LookPtr look = doc->addLook("look" + std::to_string(i));
+        for (size_t j = 0; j < assignCount / 2; j++)
+        {
+            mx::MaterialAssignPtr matAssign = look->addMaterialAssign("", "material" + std::to_string(rng() % 3));
+            if (rng() % 2)
+            {
+                matAssign->setGeom(rng() % 50 ? randomGeomPath(rng, maxDepth, branching) : mx::UNIVERSAL_GEOM_NAME);
+            }
+            else
+            {
+                matAssign->setCollection(collections[rng() % collections.size()]);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
 TEST_CASE("Look", "[look]")
 {
     mx::DocumentPtr doc = mx::createDocument();
@@ -89,3 +170,63 @@ TEST_CASE("Look", "[look]")
     REQUIRE(look2->getActivePropertySetAssigns().empty());
     REQUIRE(look2->getActiveVisibilities().empty());
 }
+
+TEST_CASE("Geometry binding index", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    std::mt19937 rng(1);
+    addRandomAssignments(doc, rng, 200, 4, 3);
+    doc->getCollection("collection0")->setGeomPrefix("/node1");
+
+    // Verify that indexed bindings match a scan of all assignments.
+    std::vector<std::string> geoms = { mx::UNIVERSAL_GEOM_NAME, mx::EMPTY_STRING, "/node0, /node1/node2", "/unknown" };
+    for (int i = 0; i < 200; i++)
+    {
+        geoms.push_back(randomGeomPath(rng, 6, 3));
+    }
+    for (mx::MaterialPtr material : doc->getMaterials())
+    {
+        for (const std::string& geom : geoms)
+        {
+            REQUIRE(material->getGeometryBindings(geom) == scanGeometryBindings(material, geom));
+        }
+    }
+
+    // Verify batch resolution, with and without a material.
+    mx::ConstGeomBindingIndexPtr index = doc->getGeomBindingIndex();
+    REQUIRE(index->getMaterialAssignCount() == 200);
+    mx::MaterialPtr material = doc->getMaterial("material0");
+    std::vector<std::vector<mx::MaterialAssignPtr>> batch = index->getMaterialAssigns(geoms, material);
+    REQUIRE(batch.size() == geoms.size());
+    for (size_t i = 0; i < geoms.size(); i++)
+    {
+        REQUIRE(batch[i] == scanGeometryBindings(material, geoms[i]));
+    }
+    REQUIRE(index->getMaterialAssigns(mx::UNIVERSAL_GEOM_NAME).size() == index->getMaterialAssignCount());
+
+    // Verify that the index is shared until assignments are modified.
+    doc->addNodeGraph();
+    REQUIRE(doc->getGeomBindingIndex() == index);
+    mx::MaterialAssignPtr matAssign = doc->getLook("look0")->addMaterialAssign("newAssign", "material0");
+    matAssign->setGeom("/newGeom");
+    REQUIRE(doc->getGeomBindingIndex() != index);
+    REQUIRE(material->getGeometryBindings("/newGeom/child") == std::vector<mx::MaterialAssignPtr>({ matAssign }));
+    doc->getCollection("collection1")->setExcludeGeom(mx::UNIVERSAL_GEOM_NAME);
+    for (const std::string& geom : geoms)
+    {
+        REQUIRE(material->getGeometryBindings(geom) == scanGeometryBindings(material, geom));
+    }
+
+    // Verify that a collection cycle is reported as by Collection::matchesGeomString.
+    mx::CollectionPtr cycle1 = doc->addCollection("cycle1");
+    mx::CollectionPtr cycle2 = doc->addCollection("cycle2");
+    cycle1->setIncludeCollection(cycle2);
+    cycle2->setIncludeCollection(cycle1);
+    cycle1->setIncludeGeom("/cycleGeom");
+    doc->getLook("look1")->addMaterialAssign("cycleAssign", "material1")->setCollection(cycle1);
+    REQUIRE(doc->getMaterial("material1")->getGeometryBindings("/cycleGeom").size() ==
+            scanGeometryBindings(doc->getMaterial("material1"), "/cycleGeom").size());
+    REQUIRE_THROWS_AS(doc->getMaterial("material1")->getGeometryBindings("/node9"), mx::ExceptionFoundCycle&);
+    REQUIRE_THROWS_AS(scanGeometryBindings(doc->getMaterial("material1"), "/node9"), mx::ExceptionFoundCycle&);
+    REQUIRE_NOTHROW(material->getGeometryBindings("/node9"));
+}
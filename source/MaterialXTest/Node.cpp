@@ -4,6 +4,7 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/GenShaderUtil.h>
 
 #include <MaterialXCore/Definition.h>
 #include <MaterialXCore/Document.h>
@@ -135,6 +136,196 @@ TEST_CASE("Node", "[node]")
     REQUIRE(doc->getOutputs().empty());
 }
 
+TEST_CASE("Active ports", "[node]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Create a nodedef that inherits from another.
+    mx::NodeDefPtr baseDef = doc->addNodeDef("ND_base", "color3", "base");
+    baseDef->addInput("in1", "color3");
+    baseDef->addParameter("param1", "float");
+    baseDef->addToken("token1");
+    mx::NodeDefPtr derivedDef = doc->addNodeDef("ND_derived", "color3", "derived");
+    derivedDef->addInput("in2", "color3");
+    derivedDef->setInheritsFrom(baseDef);
+
+    // Test active ports across the inheritance chain.
+    REQUIRE(derivedDef->getActiveInputs().size() == 2);
+    REQUIRE(derivedDef->getActiveInputs()[0]->getName() == "in2");
+    REQUIRE(derivedDef->getActiveParameters().size() == 1);
+    REQUIRE(derivedDef->getActiveTokens().size() == 1);
+    REQUIRE(derivedDef->getActiveOutputs().empty());
+    REQUIRE(derivedDef->getActiveValueElements().size() == 4);
+    REQUIRE(derivedDef->getActiveInput("in1") == baseDef->getInput("in1"));
+    REQUIRE(derivedDef->getActiveParameter("param1") == baseDef->getParameter("param1"));
+    REQUIRE(derivedDef->getActiveValueElement("token1") == baseDef->getToken("token1"));
+    REQUIRE(!derivedDef->getActiveInput("param1"));
+    REQUIRE(!derivedDef->getActiveOutput("in1"));
+
+    // Returned vectors are unaffected by later changes to the interface.
+    std::vector<mx::InputPtr> activeInputs = derivedDef->getActiveInputs();
+    derivedDef->addInput("in4", "color3");
+    REQUIRE(activeInputs.size() == 2);
+    REQUIRE(derivedDef->getActiveInputs().size() == 3);
+    derivedDef->removeInput("in4");
+
+    // A port that is hidden by a port of another type is still found.
+    mx::ParameterPtr hidden = derivedDef->addParameter("in1", "color3");
+    REQUIRE(derivedDef->getActiveValueElement("in1") == hidden);
+    REQUIRE(derivedDef->getActiveInput("in1") == baseDef->getInput("in1"));
+    derivedDef->removeParameter("in1");
+
+    // Verify that active ports reflect changes to the inheritance chain.
+    baseDef->addOutput("out", "color3");
+    REQUIRE(derivedDef->getActiveOutputs().size() == 1);
+    baseDef->removeInput("in1");
+    REQUIRE(derivedDef->getActiveInputs().size() == 1);
+    REQUIRE(!derivedDef->getActiveInput("in1"));
+    derivedDef->addInput("in3", "color3");
+    derivedDef->setChildIndex("in3", 0);
+    REQUIRE(derivedDef->getActiveInputs()[0]->getName() == "in3");
+    derivedDef->getInput("in3")->setName("in4");
+    REQUIRE(derivedDef->getActiveInput("in4"));
+    REQUIRE(!derivedDef->getActiveInput("in3"));
+    baseDef->setName("ND_base2");
+    REQUIRE(derivedDef->getActiveInputs().size() == 2);
+    REQUIRE(derivedDef->getActiveParameters().empty());
+    derivedDef->setInheritsFrom(baseDef);
+    REQUIRE(derivedDef->getActiveParameters().size() == 1);
+    derivedDef->setInheritsFrom(nullptr);
+    REQUIRE(derivedDef->getActiveValueElements().size() == 2);
+
+    // Verify that the active port table is shared until the ports or the
+    // inheritance of the interface change.
+    derivedDef->setInheritsFrom(baseDef);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::ConstActivePortTablePtr table = derivedDef->getActivePortTable();
+    REQUIRE(table->getValueElements().size() == 5);
+    REQUIRE(table->getValueElement("out") == baseDef->getOutput("out"));
+    REQUIRE(derivedDef->getActivePortTable() == table);
+    nodeGraph->addNode("constant", "node1", "color3")->setInputValue("value", mx::Color3(0.5f));
+    REQUIRE(derivedDef->getActivePortTable() == table);
+    baseDef->setChildIndex("out", 0);
+    REQUIRE(derivedDef->getActivePortTable() != table);
+    REQUIRE(derivedDef->getActiveValueElements()[2] == baseDef->getOutput("out"));
+    REQUIRE(table->getValueElements()[2] != baseDef->getOutput("out"));
+}
+
+// Resolve the nodedef of a node by scanning all matching nodedefs, including
+// those of referenced libraries.
+mx::ConstNodeDefPtr scanNodeDefs(mx::NodePtr node, const std::string& target = mx::EMPTY_STRING)
+{
+    mx::DocumentPtr doc = node->getDocument();
+    if (node->hasNodeDefString())
+    {
+        return doc->findLibraryNodeDef(node->getNodeDefString());
+    }
+    std::vector<mx::ConstNodeDefPtr> nodeDefs = doc->findLibraryMatchingNodeDefs(node->getQualifiedName(node->getCategory()));
+    std::vector<mx::ConstNodeDefPtr> secondary = doc->findLibraryMatchingNodeDefs(node->getCategory());
+    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
+    for (mx::ConstNodeDefPtr nodeDef : nodeDefs)
+    {
+        if (mx::targetStringsMatch(nodeDef->getTarget(), target) &&
+            nodeDef->isVersionCompatible(node) &&
+            node->isTypeCompatible(nodeDef))
+        {
+            return nodeDef;
+        }
+    }
+    return nullptr;
+}
+
+// Add an instance of each nodedef in the library to the given graph, with
+// the node category, type and inputs of the nodedef but no nodedef string.
+void addNodeDefInstances(mx::GraphElementPtr graph, mx::ConstDocumentPtr library)
+{
+    for (mx::NodeDefPtr nodeDef : library->getNodeDefs())
+    {
+        mx::NodePtr node = graph->addNode(nodeDef->getNodeString(), mx::EMPTY_STRING, nodeDef->getType());
+        for (mx::InputPtr input : nodeDef->getActiveInputs())
+        {
+            node->addInput(input->getName(), input->getType());
+        }
+        for (mx::ParameterPtr param : nodeDef->getActiveParameters())
+        {
+            node->addParameter(param->getName(), param->getType());
+        }
+    }
+}
+
+TEST_CASE("NodeDef resolution", "[node]")
+{
+    mx::DocumentPtr library = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, mx::FilePath::getCurrentPath() / mx::FilePath("libraries"), library);
+
+    // Compare memoized and bulk resolution of local nodedefs to a scan of
+    // matching nodedefs.
+    mx::DocumentPtr localDoc = mx::createDocument();
+    localDoc->importLibrary(library);
+    mx::NodeGraphPtr localGraph = localDoc->addNodeGraph();
+    addNodeDefInstances(localGraph, library);
+    localGraph->addNode("unknown", mx::EMPTY_STRING, "float");
+    std::vector<mx::NodePtr> localNodes = localGraph->getNodes();
+    for (const std::string& target : { mx::EMPTY_STRING, std::string("genglsl") })
+    {
+        std::vector<mx::NodeDefPtr> bulkNodeDefs = localGraph->getNodeDefsForNodes(target);
+        REQUIRE(bulkNodeDefs.size() == localNodes.size());
+        for (size_t i = 0; i < localNodes.size(); i++)
+        {
+            mx::ConstNodeDefPtr nodeDef = scanNodeDefs(localNodes[i], target);
+            REQUIRE(localNodes[i]->getNodeDef(target) == nodeDef);
+            REQUIRE(localNodes[i]->getNodeDef(target) == nodeDef);
+            REQUIRE(bulkNodeDefs[i] == nodeDef);
+        }
+    }
+    REQUIRE(!localNodes.back()->getNodeDef());
+
+    // Compare resolution through a referenced library to the same scan.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->referenceLibrary(library);
+    mx::NodeGraphPtr graph = doc->addNodeGraph();
+    addNodeDefInstances(graph, library);
+    graph->addNode("unknown", mx::EMPTY_STRING, "float");
+    std::vector<mx::NodePtr> nodes = graph->getNodes();
+    for (const std::string& target : { mx::EMPTY_STRING, std::string("genglsl") })
+    {
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            mx::ConstNodeDefPtr nodeDef = scanNodeDefs(nodes[i], target);
+            REQUIRE(nodes[i]->getDeclaration(target) == nodeDef);
+            REQUIRE(nodes[i]->getDeclaration(target) == nodeDef);
+            REQUIRE(!nodes[i]->getNodeDef(target));
+        }
+    }
+    REQUIRE(!nodes.back()->getDeclaration());
+
+    // Verify that nodes with a changed signature are resolved again.
+    mx::NodePtr add = graph->addNode("add", mx::EMPTY_STRING, "float");
+    add->addInput("in1", "float");
+    mx::InputPtr in2 = add->addInput("in2", "float");
+    REQUIRE(add->getDeclaration()->getName() == "ND_add_float");
+    add->setType("color3");
+    add->getInput("in1")->setType("color3");
+    in2->setType("color3");
+    REQUIRE(add->getDeclaration()->getName() == "ND_add_color3");
+    in2->setType("float");
+    REQUIRE(add->getDeclaration()->getName() == "ND_add_color3FA");
+
+    // Verify that adding and removing nodedefs is reflected.
+    mx::NodeDefPtr localDef = doc->addNodeDef("ND_unknown_float", "float", "unknown");
+    REQUIRE(nodes.back()->getNodeDef() == localDef);
+    REQUIRE(nodes.back()->getDeclaration() == localDef);
+    doc->removeNodeDef(localDef->getName());
+    REQUIRE(!nodes.back()->getNodeDef());
+    REQUIRE(!nodes.back()->getDeclaration());
+    mx::NodeDefPtr libraryDef = library->addNodeDef("ND_unknown_float", "float", "unknown");
+    REQUIRE(!nodes.back()->getNodeDef());
+    REQUIRE(nodes.back()->getDeclaration() == libraryDef);
+    doc->removeReferencedLibraries();
+    REQUIRE(!nodes.back()->getDeclaration());
+    REQUIRE(!add->getDeclaration());
+}
+
 TEST_CASE("Flatten", "[nodegraph]")
 {
     std::string searchPath = "resources/Materials/Examples" + mx::PATH_LIST_SEPARATOR + "libraries/stdlib";
@@ -44,11 +44,13 @@
 #include <MaterialXRender/Handlers/OiioImageLoader.h>
 #endif
 #include <MaterialXRender/Handlers/StbImageLoader.h>
+#include <MaterialXRender/Handlers/TinyObjLoader.h>
 
 #include <fstream>
 #include <iostream>
 #include <unordered_set>
 #include <chrono>
+#include <cmath>
 #include <ctime>
 
 namespace mx = MaterialX;
@@ -1670,5 +1672,139 @@ TEST_CASE("Render: TestSuite", "[render]")
     );
 }
 
+// Load the bundled OBJ assets.
+mx::MeshList loadGeometryAssets()
+{
+    mx::TinyObjLoaderPtr loader = mx::TinyObjLoader::create();
+    mx::MeshList meshes;
+    for (const char* filename : { "plane.obj", "sphere.obj", "teapot.obj", "shaderball.obj" })
+    {
+        loader->load(mx::FilePath("resources/Geometry") / mx::FilePath(filename), meshes);
+    }
+    return meshes;
+}
+
+// Return a mesh holding the given number of copies of the given mesh, with
+// the texture coordinates of each copy offset into a different UDIM.
+mx::MeshPtr createScaledMesh(mx::MeshPtr mesh, size_t copyCount)
+{
+    mx::MeshPtr scaled = mx::Mesh::create(mesh->getIdentifier());
+    size_t vertexCount = mesh->getVertexCount();
+    for (const std::string& type : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE, mx::MeshStream::TEXCOORD_ATTRIBUTE })
+    {
+        mx::MeshStreamPtr stream = mesh->getStream(type, 0);
+        mx::MeshStreamPtr scaledStream = mx::MeshStream::create(stream->getName(), type, 0);
+        scaledStream->setStride(stream->getStride());
+        for (size_t copy = 0; copy < copyCount; copy++)
+        {
+            mx::MeshFloatBuffer& data = scaledStream->getData();
+            data.insert(data.end(), stream->getData().begin(), stream->getData().end());
+            if (type == mx::MeshStream::TEXCOORD_ATTRIBUTE)
+            {
+                for (size_t i = data.size() - stream->getData().size(); i < data.size(); i += stream->getStride())
+                {
+                    data[i] += (float) (copy % 10);
+                }
+            }
+        }
+        scaled->addStream(scaledStream);
+    }
+    for (size_t copy = 0; copy < copyCount; copy++)
+    {
+        for (size_t p = 0; p < mesh->getPartitionCount(); p++)
+        {
+            mx::MeshPartitionPtr part = mesh->getPartition(p);
+            mx::MeshPartitionPtr scaledPart = mx::MeshPartition::create();
+            scaledPart->setIdentifier(part->getIdentifier());
+            for (unsigned int index : part->getIndices())
+            {
+                scaledPart->getIndices().push_back(index + (unsigned int) (copy * vertexCount));
+            }
+            scaledPart->setFaceCount(part->getFaceCount());
+            scaled->addPartition(scaledPart);
+        }
+    }
+    scaled->setVertexCount(vertexCount * copyCount);
+    return scaled;
+}
+
+size_t getTotalFaceCount(mx::MeshPtr mesh)
+{
+    size_t faceCount = 0;
+    for (size_t p = 0; p < mesh->getPartitionCount(); p++)
+    {
+        faceCount += mesh->getPartition(p)->getFaceCount();
+    }
+    return faceCount;
+}
+
+TEST_CASE("Render: Mesh preprocessing", "[rendercore]")
+{
+    mx::MeshList meshes = loadGeometryAssets();
+    REQUIRE(meshes.size() == 4);
+
+    for (mx::MeshPtr asset : meshes)
+    {
+        mx::MeshPtr mesh = createScaledMesh(asset, 3);
+        mx::MeshStreamPtr positions = mesh->getStream(mx::MeshStream::POSITION_ATTRIBUTE, 0);
+        mx::MeshStreamPtr normals = mesh->getStream(mx::MeshStream::NORMAL_ATTRIBUTE, 0);
+        mx::MeshStreamPtr texcoords = mesh->getStream(mx::MeshStream::TEXCOORD_ATTRIBUTE, 0);
+        size_t faceCount = getTotalFaceCount(mesh);
+
+        // Verify that tangents are normalized and orthogonal to normals, and
+        // that bitangents complete the basis.
+        mx::MeshStreamPtr tangents = mx::MeshStream::create("tangent", mx::MeshStream::TANGENT_ATTRIBUTE, 0);
+        mx::MeshStreamPtr bitangents = mx::MeshStream::create("bitangent", mx::MeshStream::BITANGENT_ATTRIBUTE, 0);
+        REQUIRE(mesh->generateTangents(positions, texcoords, normals, tangents, bitangents));
+        REQUIRE(tangents->getData().size() == mesh->getVertexCount() * 3);
+        REQUIRE(bitangents->getData().size() == mesh->getVertexCount() * 3);
+        for (size_t v = 0; v < mesh->getVertexCount(); v++)
+        {
+            const float* n = &normals->getData()[v * 3];
+            const float* t = &tangents->getData()[v * 3];
+            const float* b = &bitangents->getData()[v * 3];
+            float tangentLength = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+            float normalLength = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            bool defaultTangent = (t[0] == 0.0f && t[1] == 0.0f && t[2] == 1.0f);
+            if (std::isnan(tangentLength) || std::abs(normalLength - 1.0f) > 1e-3f || defaultTangent)
+            {
+                continue;
+            }
+            REQUIRE(std::abs(tangentLength - 1.0f) < 1e-3f);
+            REQUIRE(std::abs(n[0] * t[0] + n[1] * t[1] + n[2] * t[2]) < 1e-3f);
+            REQUIRE(std::abs(b[0] - (n[1] * t[2] - n[2] * t[1])) < 1e-5f);
+            REQUIRE(std::abs(b[1] - (n[2] * t[0] - n[0] * t[2])) < 1e-5f);
+            REQUIRE(std::abs(b[2] - (n[0] * t[1] - n[1] * t[0])) < 1e-5f);
+        }
+
+        // Verify that bounds contain every referenced vertex and match those
+        // computed by the loader.
+        mesh->computeBounds();
+        REQUIRE(mesh->getMinimumBounds() == asset->getMinimumBounds());
+        REQUIRE(mesh->getMaximumBounds() == asset->getMaximumBounds());
+
+        // Verify that each face is assigned to the partition of its UDIM.
+        mesh->splitByUdims();
+        REQUIRE(getTotalFaceCount(mesh) == faceCount);
+        for (size_t p = 0; p < mesh->getPartitionCount(); p++)
+        {
+            mx::MeshPartitionPtr part = mesh->getPartition(p);
+            REQUIRE(part->getIndices().size() == part->getFaceCount() * 3);
+            for (size_t f = 0; f < part->getFaceCount(); f++)
+            {
+                const float* uv = &texcoords->getData()[part->getIndices()[f * 3] * 2];
+                unsigned int udim = 1001 + (unsigned int) uv[0] + 10 * (unsigned int) uv[1];
+                REQUIRE(part->getIdentifier() == std::to_string(udim));
+            }
+        }
+
+        // Verify that merged partitions hold every face.
+        mesh->mergePartitions();
+        REQUIRE(mesh->getPartitionCount() == 1);
+        REQUIRE(mesh->getPartition(0)->getFaceCount() == faceCount);
+        REQUIRE(mesh->getPartition(0)->getIndices().size() == faceCount * 3);
+    }
+}
+
 #endif
 #endif
@@ -0,0 +1,106 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/TestUtil.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <direct.h>
+#include <sys/types.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+namespace TestUtil
+{
+
+TemporaryDirectory::TemporaryDirectory()
+{
+#if defined(_WIN32)
+    // Reserve a unique name with a temporary file, and replace the file with
+    // a directory of the same name.
+    char tempPath[MAX_PATH];
+    char tempName[MAX_PATH];
+    if (!GetTempPathA(MAX_PATH, tempPath) ||
+        !GetTempFileNameA(tempPath, "mtx", 0, tempName) ||
+        !DeleteFileA(tempName) ||
+        _mkdir(tempName) != 0)
+    {
+        throw mx::Exception("Failed to create a temporary directory");
+    }
+    _path = mx::FilePath(tempName);
+#else
+    const char* tempPath = std::getenv("TMPDIR");
+    std::string pattern = std::string(tempPath && *tempPath ? tempPath : "/tmp") + "/MaterialXTest.XXXXXX";
+    std::vector<char> tempName(pattern.begin(), pattern.end());
+    tempName.push_back('\0');
+    if (!mkdtemp(tempName.data()))
+    {
+        throw mx::Exception("Failed to create a temporary directory");
+    }
+    _path = mx::FilePath(tempName.data());
+#endif
+}
+
+TemporaryDirectory::~TemporaryDirectory()
+{
+    std::string directory = _path.asString();
+#if defined(_WIN32)
+    WIN32_FIND_DATAA fd;
+    HANDLE hFind = FindFirstFileA((directory + "\\*").c_str(), &fd);
+    if (hFind != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                std::remove((_path / mx::FilePath(fd.cFileName)).asString().c_str());
+            }
+        } while (FindNextFileA(hFind, &fd));
+        FindClose(hFind);
+    }
+    _rmdir(directory.c_str());
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir)
+    {
+        while (struct dirent* entry = readdir(dir))
+        {
+            if (entry->d_type != DT_DIR)
+            {
+                std::remove((_path / mx::FilePath(entry->d_name)).asString().c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(directory.c_str());
+#endif
+}
+
+void setModificationTime(const mx::FilePath& file, long long seconds)
+{
+#if defined(_WIN32)
+    struct _utimbuf times;
+    times.actime = (time_t) seconds;
+    times.modtime = (time_t) seconds;
+    if (_utime(file.asString().c_str(), &times) != 0)
+#else
+    struct utimbuf times;
+    times.actime = (time_t) seconds;
+    times.modtime = (time_t) seconds;
+    if (utime(file.asString().c_str(), &times) != 0)
+#endif
+    {
+        throw mx::Exception("Failed to set the modification time of " + file.asString());
+    }
+}
+
+} // namespace TestUtil
@@ -0,0 +1,46 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <MaterialXFormat/File.h>
+
+namespace mx = MaterialX;
+
+namespace TestUtil
+{
+    //
+    // A uniquely named directory within the system temporary directory,
+    // which is created on construction and removed along with the files
+    // it contains on destruction.
+    //
+    class TemporaryDirectory
+    {
+      public:
+        TemporaryDirectory();
+        ~TemporaryDirectory();
+
+        const mx::FilePath& getPath() const
+        {
+            return _path;
+        }
+
+      private:
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+      private:
+        mx::FilePath _path;
+    };
+
+    //
+    // Set the modification time of the given file, in seconds since the
+    // epoch.
+    //
+    void setModificationTime(const mx::FilePath& file, long long seconds);
+}
+
+#endif
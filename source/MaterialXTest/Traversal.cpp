@@ -7,6 +7,8 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <MaterialXFormat/XmlIo.h>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Traversal", "[traversal]")
@@ -124,6 +126,9 @@ TEST_CASE("Traversal", "[traversal]")
         mx::ElementPtr upstreamElem = it.getUpstreamElement();
         mx::ElementPtr connectingElem = it.getConnectingElement();
         mx::ElementPtr downstreamElem = it.getDownstreamElement();
+        REQUIRE(it.getUpstreamElementRaw() == upstreamElem.get());
+        REQUIRE(it.getConnectingElementRaw() == connectingElem.get());
+        REQUIRE(it.getDownstreamElementRaw() == downstreamElem.get());
         if (upstreamElem->isA<mx::Node>())
         {
             nodeCount++;
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Document.h>
+#include <MaterialXCore/ThreadPool.h>
+
+#include <atomic>
 
 namespace mx = MaterialX;
 
@@ -30,6 +33,58 @@ TEST_CASE("String utilities", "[util]")
     REQUIRE(mx::splitString("[one...two...three]", "[.]") == (std::vector<std::string>{"one", "two", "three"}));
 }
 
+TEST_CASE("Symbols", "[util]")
+{
+    mx::Symbol empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty == mx::Symbol(""));
+    REQUIRE(empty == mx::Symbol(std::string()));
+
+    // Identical strings are interned as a single symbol.
+    std::string input = "input";
+    mx::Symbol symbol1(input);
+    mx::Symbol symbol2("input");
+    REQUIRE(symbol1 == symbol2);
+    REQUIRE(&symbol1.str() == &symbol2.str());
+    REQUIRE(symbol1.str() == input);
+    REQUIRE(std::hash<mx::Symbol>()(symbol1) == std::hash<mx::Symbol>()(symbol2));
+    REQUIRE(symbol1 != mx::Symbol("output"));
+
+    // Strings are found without being interned, and changes to a string are
+    // reflected in symbols constructed from it.
+    mx::Symbol found;
+    REQUIRE(mx::Symbol::find(input, found));
+    REQUIRE(found == symbol1);
+    size_t symbolCount = mx::Symbol::getSymbolCount();
+    REQUIRE(!mx::Symbol::find("symbolNeverInterned", found));
+    REQUIRE(mx::Symbol::getSymbolCount() == symbolCount);
+    input = "inputChanged";
+    REQUIRE(mx::Symbol(input).str() == "inputChanged");
+    REQUIRE(mx::Symbol(input) != symbol1);
+
+    // Element categories are stored as symbols.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node = nodeGraph->addNode("image");
+    REQUIRE(node->getCategory() == "image");
+    REQUIRE(node->getCategorySymbol() == mx::Symbol("image"));
+    node->setCategory("constant");
+    REQUIRE(node->getCategorySymbol() == mx::Symbol("constant"));
+    REQUIRE(nodeGraph->getCategorySymbol() == mx::Symbol(mx::NodeGraph::CATEGORY));
+    mx::ElementPtr child = nodeGraph->addChildOfCategory(mx::Symbol("add"));
+    REQUIRE(child->isA<mx::Node>());
+    REQUIRE(child->getCategory() == "add");
+
+    // Attributes may be accessed by symbol or by string.
+    mx::Symbol uiName("uiname");
+    node->setAttribute(uiName, "Image");
+    REQUIRE(node->hasAttribute(uiName));
+    REQUIRE(node->getAttribute(uiName) == "Image");
+    REQUIRE(node->getAttribute("uiname") == "Image");
+    REQUIRE(!node->hasAttribute("symbolNeverInterned"));
+    REQUIRE(!node->hasAttribute(mx::Symbol("uifolder")));
+}
+
 TEST_CASE("Print utilities", "[util]")
 {
     // Create a document.
@@ -103,3 +158,58 @@ TEST_CASE("Print utilities", "[util]")
 
     REQUIRE(nodeGraph->asStringDot() == blessed);
 }
+
+TEST_CASE("Thread pool", "[util]")
+{
+    mx::ThreadPool pool(3);
+    REQUIRE(pool.getWorkerCount() == 3);
+
+    // Each index is visited exactly once.
+    std::vector<int> visits(1000, 0);
+    pool.parallelFor(visits.size(), [&](size_t i)
+    {
+        visits[i]++;
+    });
+    REQUIRE(std::count(visits.begin(), visits.end(), 1) == (int) visits.size());
+
+    // Nested loops complete, even when all workers are busy.
+    std::atomic<size_t> nestedCount(0);
+    pool.parallelFor(8, [&](size_t)
+    {
+        pool.parallelFor(8, [&](size_t)
+        {
+            nestedCount++;
+        });
+    });
+    REQUIRE(nestedCount == 64);
+
+    // The exception of the first failing index is rethrown, once all indices
+    // have been visited.
+    std::atomic<size_t> visitCount(0);
+    try
+    {
+        pool.parallelFor(100, [&](size_t i)
+        {
+            visitCount++;
+            if (i % 10 == 5)
+            {
+                throw mx::Exception("Index " + std::to_string(i));
+            }
+        });
+        FAIL("No exception was thrown");
+    }
+    catch (mx::Exception& e)
+    {
+        REQUIRE(std::string(e.what()) == "Index 5");
+    }
+    REQUIRE(visitCount == 100);
+
+    // The calling thread alone runs loops limited to one thread.
+    std::thread::id callingThread = std::this_thread::get_id();
+    bool callingThreadOnly = true;
+    mx::ThreadPool::getGlobal().parallelFor(100, [&](size_t)
+    {
+        callingThreadOnly = callingThreadOnly && std::this_thread::get_id() == callingThread;
+    }, 1);
+    REQUIRE(callingThreadOnly);
+}
@@ -5,11 +5,49 @@
 
 #include <MaterialXTest/Catch/catch.hpp>
 
+#include <MaterialXCore/Document.h>
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <MaterialXFormat/XmlIo.h>
+
+#include <locale>
+#include <thread>
+
 namespace mx = MaterialX;
 
+// A numeric punctuation facet that uses a comma as the decimal point and
+// groups digits in thousands, as in many European locales.
+class CommaNumpunct : public std::numpunct<char>
+{
+  protected:
+    char do_decimal_point() const override { return ','; }
+    char do_thousands_sep() const override { return '.'; }
+    std::string do_grouping() const override { return "\3"; }
+};
+
+// Verify that value strings are written and read in the classic locale on
+// the calling thread and on a new thread.
+void testClassicValueStrings()
+{
+    REQUIRE(mx::toValueString(0.5f) == "0.5");
+    REQUIRE(mx::toValueString(1234567.5, mx::Value::FloatFormatFixed, 1) == "1234567.5");
+    REQUIRE(mx::toValueString(mx::Vector2(0.25f, 1000.0f)) == "0.25, 1000");
+    REQUIRE(mx::fromValueString<float>("1234.5") == 1234.5f);
+    REQUIRE(mx::fromValueString<mx::Vector2>("0.25, 1000") == mx::Vector2(0.25f, 1000.0f));
+    REQUIRE(mx::fromValueString<float>("1.234,5") == 1.234f);
+    std::string threadString;
+    float threadFloat = 0.0f;
+    std::thread thread([&threadString, &threadFloat]()
+    {
+        threadString = mx::toValueString(1234.5f);
+        threadFloat = mx::fromValueString<float>("1234.5");
+    });
+    thread.join();
+    REQUIRE(threadString == "1234.5");
+    REQUIRE(threadFloat == 1234.5f);
+}
+
 template<class T> void testTypedValue(const T& v1, const T& v2)
 {
     T v0{};
@@ -65,6 +103,48 @@ TEST_CASE("Value strings", "[value]")
         mx::Value::ScopedFloatFormatting fmt(mx::Value::FloatFormatDefault, 2);
         REQUIRE(mx::toValueString(0.1234f) == "0.12");
     }
+    REQUIRE(mx::toValueString(1.0e30f, mx::Value::FloatFormatFixed, 1).size() > 30);
+    REQUIRE(mx::toValueString(-0.5, mx::Value::FloatFormatDefault, 6) == "-0.5");
+    REQUIRE(mx::toValueString(1.0e-7f) == "1e-07");
+
+    // Convert from data values to value strings using per-call float
+    // formatting, which is independent of the formatting of each thread.
+    REQUIRE(mx::toValueString(0.1234f, mx::Value::FloatFormatFixed, 3) == "0.123");
+    REQUIRE(mx::toValueString(mx::Color3(1.0f), mx::Value::FloatFormatFixed, 1) == "1.0, 1.0, 1.0");
+    REQUIRE(mx::Value::createValue(0.1234f)->getValueString(mx::Value::FloatFormatScientific, 2) == "1.23e-01");
+    REQUIRE(mx::Value::createValue(std::vector<float>{0.5f, 1.0f})->getValueString(mx::Value::FloatFormatFixed, 2) == "0.50, 1.00");
+    REQUIRE(mx::Value::getFloatFormat() == mx::Value::FloatFormatDefault);
+    {
+        mx::Value::ScopedFloatFormatting fmt(mx::Value::FloatFormatFixed, 3);
+        std::string threadString;
+        std::thread thread([&threadString]()
+        {
+            threadString = mx::toValueString(0.5f);
+        });
+        thread.join();
+        REQUIRE(threadString == "0.5");
+        REQUIRE(mx::toValueString(0.5f) == "0.500");
+    }
+
+    // Verify that value strings are independent of the global locale, using
+    // a custom locale and any installed locale with a comma decimal point.
+    {
+        std::locale previousLocale = std::locale::global(std::locale(std::locale::classic(), new CommaNumpunct()));
+        testClassicValueStrings();
+        for (const char* localeName : { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8" })
+        {
+            try
+            {
+                std::locale::global(std::locale(localeName));
+            }
+            catch (std::runtime_error&)
+            {
+                continue;
+            }
+            testClassicValueStrings();
+        }
+        std::locale::global(previousLocale);
+    }
 
     // Convert from value strings to data values.
     REQUIRE(mx::fromValueString<int>("1") == 1);
@@ -79,6 +159,29 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE_THROWS_AS(mx::fromValueString<float>("text"), mx::ExceptionTypeError&);
     REQUIRE_THROWS_AS(mx::fromValueString<bool>("1"), mx::ExceptionTypeError&);
     REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1, 1, 1, 1"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1, text, 1"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<int>("99999999999"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e99"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("text"), mx::ExceptionTypeError&);
+
+    // Values are read from the start of each token, ignoring any trailing
+    // characters.
+    REQUIRE(mx::fromValueString<float>("1.5text") == 1.5f);
+    REQUIRE(mx::fromValueString<double>("0.5.0") == 0.5);
+    REQUIRE(mx::fromValueString<int>("1.0") == 1);
+    REQUIRE(mx::fromValueString<mx::Color3>("1, 2x, 3") == mx::Color3(1.0f, 2.0f, 3.0f));
+    REQUIRE_THROWS_AS(mx::fromValueString<std::vector<bool>>("true, 1"), mx::ExceptionTypeError&);
+
+    // Convert from value strings with varied separators.
+    REQUIRE(mx::fromValueString<mx::Vector3>("1,2 ,  3") == mx::Vector3(1.0f, 2.0f, 3.0f));
+    REQUIRE(mx::fromValueString<mx::Vector2>(" -0.5, 1e-1 ") == mx::Vector2(-0.5f, 0.1f));
+    REQUIRE(mx::fromValueString<mx::Matrix33>("1, 2, 3, 4, 5, 6, 7, 8, 9")[1][0] == 4.0f);
+    REQUIRE(mx::fromValueString<std::vector<int>>("1, 2, 3") == std::vector<int>({1, 2, 3}));
+    REQUIRE(mx::fromValueString<std::vector<bool>>("true, false") == std::vector<bool>({true, false}));
+    REQUIRE(mx::fromValueString<mx::StringVec>("a, b") == mx::StringVec({"a", "b"}));
+    REQUIRE(mx::fromValueString<std::vector<float>>("").empty());
+    REQUIRE(mx::fromValueString<float>(" 0.5 ") == 0.5f);
 }
 
 TEST_CASE("Typed values", "[value]")
@@ -4,13 +4,58 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/TestUtil.h>
 
 #include <MaterialXFormat/Environ.h>
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <MaterialXGenShader/Util.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+
 namespace mx = MaterialX;
 
+namespace
+{
+
+// Return the data library files of the stdlib, pbrlib and bxdf libraries.
+std::vector<mx::FilePath> getLibraryFiles()
+{
+    mx::FilePath librariesPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    std::vector<mx::FilePath> libraryFiles;
+    for (std::string library : { "stdlib", "pbrlib", "bxdf" })
+    {
+        mx::StringVec filenames;
+        mx::getFilesInDirectory(librariesPath / library, filenames, "mtlx");
+        for (const std::string& filename : filenames)
+        {
+            libraryFiles.push_back(librariesPath / library / filename);
+        }
+    }
+    return libraryFiles;
+}
+
+// Import the given library files into a document, reading them serially
+// without the library cache.
+void importLibraryFiles(const std::vector<mx::FilePath>& libraryFiles, mx::DocumentPtr doc)
+{
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+    for (const mx::FilePath& file : libraryFiles)
+    {
+        mx::DocumentPtr libDoc = mx::createDocument();
+        mx::readFromXmlFile(libDoc, file);
+        libDoc->setSourceUri(file);
+        doc->importLibrary(libDoc, &copyOptions);
+    }
+}
+
+} // anonymous namespace
+
 TEST_CASE("Load content", "[xmlio]")
 {
     std::string libraryFilenames[] =
@@ -220,3 +265,267 @@ TEST_CASE("Load content", "[xmlio]")
     mx::DocumentPtr nonExistentDoc = mx::createDocument();
     REQUIRE_THROWS_AS(mx::readFromXmlFile(nonExistentDoc, "NonExistent.mtlx"), mx::ExceptionFileMissing&);
 }
+
+TEST_CASE("Incremental read", "[xmlio]")
+{
+    // Read a document that spans many blocks of the input stream.
+    mx::DocumentPtr doc = mx::createDocument();
+    for (int i = 0; i < 100; i++)
+    {
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+        for (int j = 0; j < 20; j++)
+        {
+            mx::NodePtr node = nodeGraph->addNode("constant", mx::EMPTY_STRING, "color3");
+            node->setParameterValue("value", mx::Color3(0.1f * j, 0.2f, 0.3f));
+            node->setAttribute("doc", "Node <" + std::to_string(j) + "> & \"doc\"");
+        }
+    }
+    std::string xmlString = mx::writeToXmlString(doc);
+    REQUIRE(xmlString.size() > (1 << 18));
+    std::istringstream stream(xmlString);
+    mx::DocumentPtr streamDoc = mx::createDocument();
+    mx::readFromXmlStreamIncremental(streamDoc, stream);
+    REQUIRE(*streamDoc == *doc);
+    REQUIRE(streamDoc->getNodeGraphs().back()->getNodes().back()->getDocument() == streamDoc);
+
+    // Verify that elements are read into the arena of the target document.
+    mx::DocumentPtr arenaDoc = mx::createDocument();
+    arenaDoc->enableArenaStorage();
+    size_t arenaBytes = arenaDoc->getArena()->getAllocatedBytes();
+    stream.clear();
+    stream.seekg(0);
+    mx::readFromXmlStreamIncremental(arenaDoc, stream);
+    REQUIRE(*arenaDoc == *doc);
+    REQUIRE(arenaDoc->getArena()->getAllocatedBytes() > arenaBytes);
+
+    // Verify that markup is read as by the default reader, and that
+    // attribute values are decoded.
+    std::string markupString =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!DOCTYPE materialx [ <!ENTITY example \"a>b\"> ]>\n"
+        "<!-- A comment -- with dashes --->\n"
+        "<materialx version=\"1.36\">\n"
+        "  <nodegraph name='graph1' doc='&lt;&amp;&gt; &quot;&apos; &#65;&#x42; &unknown; a\tb\r\nc'>\n"
+        "    <![CDATA[ <notanode name=\"cdata\"/> ]]>Character data\n"
+        "    <?instruction ?>\n"
+        "    <node name=\"node1\" />\n"
+        "  </nodegraph >\n"
+        "</materialx>\n";
+    mx::DocumentPtr markupDoc = mx::createDocument();
+    std::istringstream markupStream(markupString);
+    mx::readFromXmlStreamIncremental(markupDoc, markupStream);
+    mx::NodeGraphPtr graph1 = markupDoc->getNodeGraph("graph1");
+    REQUIRE(graph1);
+    REQUIRE(graph1->getAttribute("doc") == "<&> \"' AB &unknown; a b c");
+    REQUIRE(graph1->getChildren().size() == 3);
+    REQUIRE(graph1->getChild("node1"));
+    mx::DocumentPtr defaultMarkupDoc = mx::createDocument();
+    mx::readFromXmlString(defaultMarkupDoc, markupString);
+    REQUIRE(*markupDoc == *defaultMarkupDoc);
+
+    // Verify that XInclude references precede and take precedence over
+    // local elements, regardless of their position in the document.
+    TestUtil::TemporaryDirectory tempDir;
+    mx::FilePath includeFile = tempDir.getPath() / mx::FilePath("StreamInclude.mtlx");
+    mx::DocumentPtr includeDoc = mx::createDocument();
+    includeDoc->addNodeGraph("graph1");
+    includeDoc->addNodeGraph("graph2");
+    mx::writeToXmlFile(includeDoc, includeFile);
+    std::string includingString =
+        "<materialx version=\"1.36\">\n"
+        "  <nodegraph name=\"graph3\" />\n"
+        "  <nodegraph name=\"graph2\" doc=\"local\" />\n"
+        "  <xi:include href=\"" + includeFile.asString() + "\" />\n"
+        "</materialx>\n";
+    mx::XmlReadOptions readOptions;
+    readOptions.skipDuplicateElements = true;
+    mx::DocumentPtr includingDoc = mx::createDocument();
+    std::istringstream includingStream(includingString);
+    mx::readFromXmlStreamIncremental(includingDoc, includingStream, &readOptions);
+    REQUIRE(includingDoc->getChildIndex("graph1") == 0);
+    REQUIRE(includingDoc->getChildIndex("graph2") == 1);
+    REQUIRE(includingDoc->getChildIndex("graph3") == 2);
+    REQUIRE(!includingDoc->getNodeGraph("graph2")->hasAttribute("doc"));
+    mx::DocumentPtr defaultIncludingDoc = mx::createDocument();
+    mx::readFromXmlString(defaultIncludingDoc, includingString, &readOptions);
+    REQUIRE(*includingDoc == *defaultIncludingDoc);
+    includingStream.clear();
+    includingStream.seekg(0);
+    REQUIRE_THROWS_AS(mx::readFromXmlStreamIncremental(mx::createDocument(), includingStream), mx::Exception&);
+
+    // Verify that malformed documents and unsupported encodings are
+    // rejected, and leave the document unchanged.
+    std::string invalidStrings[] =
+    {
+        "",
+        "<!-- No document element -->",
+        "<materialx><nodegraph name=\"graph1\"></materialx>",
+        "<materialx><nodegraph name=\"graph1\"/>",
+        "<materialx><nodegraph name=graph1/></materialx>",
+        "<materialx><nodegraph name=\"graph1\"doc=\"\"/></materialx>",
+        "<materialx><1nodegraph name=\"graph1\"/></materialx>",
+        "<materialx/><materialx/>",
+        "<?xml version=\"1.0\" encoding=\"UTF-16\"?><materialx/>",
+        std::string("\xFF\xFE<\0m\0/\0>\0", 8)
+    };
+    mx::DocumentPtr unchangedDoc = doc->copy();
+    for (const std::string& invalidString : invalidStrings)
+    {
+        std::istringstream invalidStream(invalidString);
+        REQUIRE_THROWS_AS(mx::readFromXmlStreamIncremental(doc, invalidStream), mx::ExceptionParseError&);
+        REQUIRE(*doc == *unchangedDoc);
+    }
+
+    // Read from a file.
+    mx::DocumentPtr fileDoc = mx::createDocument();
+    mx::readFromXmlFileIncremental(fileDoc, includeFile);
+    REQUIRE(*fileDoc == *includeDoc);
+    REQUIRE(fileDoc->getSourceUri() == includeFile.asString());
+    REQUIRE_THROWS_AS(mx::readFromXmlFileIncremental(fileDoc, "NonExistent.mtlx"), mx::ExceptionFileMissing&);
+}
+
+TEST_CASE("XInclude resolution", "[xmlio]")
+{
+    TestUtil::TemporaryDirectory tempDir;
+    std::string searchPath = tempDir.getPath();
+    auto writeDocument = [&tempDir](const std::string& filename, const std::string& content)
+    {
+        std::ofstream stream(tempDir.getPath() / mx::FilePath(filename));
+        stream << "<materialx version=\"1.36\">\n" << content << "</materialx>\n";
+    };
+    auto include = [](const std::string& filename)
+    {
+        return "  <xi:include href=\"" + filename + "\" />\n";
+    };
+    auto nodeGraph = [](const std::string& name)
+    {
+        return "  <nodegraph name=\"" + name + "\" />\n";
+    };
+
+    // Count the reads of each included file.  Custom read functions are
+    // called serially, so the counts need no synchronization.
+    std::map<std::string, int> readCounts;
+    mx::XmlReadOptions readOptions;
+    readOptions.skipDuplicateElements = true;
+    readOptions.readXIncludeFunction = [&readCounts](mx::DocumentPtr doc, const std::string& filename,
+                                                     const std::string& searchPath, const mx::XmlReadOptions* options)
+    {
+        readCounts[filename]++;
+        mx::readFromXmlFile(doc, filename, searchPath, options);
+    };
+
+    // Verify that each file in a diamond-shaped include graph is read once,
+    // and that included elements are imported in reference order.
+    writeDocument("IncludeLeaf.mtlx", nodeGraph("leaf"));
+    writeDocument("IncludeA.mtlx", include("IncludeLeaf.mtlx") + nodeGraph("a"));
+    writeDocument("IncludeB.mtlx", include("IncludeLeaf.mtlx") + nodeGraph("b"));
+    writeDocument("IncludeTop.mtlx", nodeGraph("top") + include("IncludeA.mtlx") + include("IncludeB.mtlx"));
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "IncludeTop.mtlx", searchPath, &readOptions);
+    std::vector<std::string> childNames;
+    for (mx::ElementPtr child : doc->getChildren())
+    {
+        childNames.push_back(child->getName());
+    }
+    REQUIRE(childNames == std::vector<std::string>({ "leaf", "a", "b", "top" }));
+    REQUIRE(doc->getNodeGraph("leaf")->getSourceUri() == "IncludeLeaf.mtlx");
+    REQUIRE(readCounts.size() == 3);
+    REQUIRE(readCounts["IncludeA.mtlx"] == 1);
+    REQUIRE(readCounts["IncludeB.mtlx"] == 1);
+    REQUIRE(readCounts["IncludeLeaf.mtlx"] == 1);
+
+    // Verify that the built-in reader, which reads included files in
+    // parallel, gives the same results.
+    mx::XmlReadOptions parallelOptions;
+    parallelOptions.skipDuplicateElements = true;
+    parallelOptions.xincludeCache = std::make_shared<mx::XIncludeCache>();
+    mx::DocumentPtr parallelDoc = mx::createDocument();
+    mx::readFromXmlFile(parallelDoc, "IncludeTop.mtlx", searchPath, &parallelOptions);
+    REQUIRE(*parallelDoc == *doc);
+    REQUIRE(parallelOptions.xincludeCache->getReadCount() == 3);
+
+    // Verify that a cache may be shared by a batch of reads.
+    readCounts.clear();
+    readOptions.xincludeCache = std::make_shared<mx::XIncludeCache>();
+    for (std::string filename : { "IncludeA.mtlx", "IncludeB.mtlx" })
+    {
+        mx::DocumentPtr batchDoc = mx::createDocument();
+        mx::readFromXmlFile(batchDoc, filename, searchPath, &readOptions);
+        REQUIRE(batchDoc->getNodeGraph("leaf"));
+    }
+    REQUIRE(readOptions.xincludeCache->getReadCount() == 1);
+    REQUIRE(readCounts["IncludeLeaf.mtlx"] == 1);
+    readOptions.xincludeCache = nullptr;
+
+    // Verify that include cycles are detected, including cycles that are
+    // reached through more than one branch of the include graph.
+    writeDocument("IncludeCycleA.mtlx", include("IncludeCycleB.mtlx"));
+    writeDocument("IncludeCycleB.mtlx", include("IncludeCycleA.mtlx"));
+    REQUIRE_THROWS_AS(mx::readFromXmlFile(mx::createDocument(), "IncludeCycleA.mtlx", searchPath), mx::ExceptionParseError&);
+    writeDocument("IncludeBranchA.mtlx", include("IncludeBranchC.mtlx"));
+    writeDocument("IncludeBranchB.mtlx", include("IncludeBranchC.mtlx"));
+    writeDocument("IncludeBranchC.mtlx", include("IncludeBranchB.mtlx"));
+    writeDocument("IncludeBranchTop.mtlx", include("IncludeBranchA.mtlx") + include("IncludeBranchB.mtlx"));
+    for (int i = 0; i < 10; i++)
+    {
+        REQUIRE_THROWS_AS(mx::readFromXmlFile(mx::createDocument(), "IncludeBranchTop.mtlx", searchPath), mx::ExceptionParseError&);
+    }
+
+    // Verify that errors in included files are reported.
+    writeDocument("IncludeMissing.mtlx", include("NonExistent.mtlx"));
+    REQUIRE_THROWS_AS(mx::readFromXmlFile(mx::createDocument(), "IncludeMissing.mtlx", searchPath), mx::ExceptionFileMissing&);
+}
+
+TEST_CASE("Load libraries", "[xmlio]")
+{
+    std::vector<mx::FilePath> libraryFiles = getLibraryFiles();
+    REQUIRE(!libraryFiles.empty());
+    mx::clearLibraryCache();
+
+    // Read library files concurrently, and verify that they are returned in
+    // the order requested.
+    std::vector<mx::ConstDocumentPtr> libraryDocs = mx::readLibraryFiles(libraryFiles);
+    REQUIRE(libraryDocs.size() == libraryFiles.size());
+    for (size_t i = 0; i < libraryFiles.size(); i++)
+    {
+        REQUIRE(libraryDocs[i]->getSourceUri() == libraryFiles[i].asString());
+    }
+
+    // Verify that unmodified libraries are returned from the cache.
+    REQUIRE(mx::readLibraryFiles(libraryFiles) == libraryDocs);
+    REQUIRE(mx::readLibraryFile(libraryFiles[0]) == libraryDocs[0]);
+
+    // Verify that loaded libraries match libraries imported serially.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+    mx::loadLibraries(libraryFiles, doc, &copyOptions);
+    mx::DocumentPtr serialDoc = mx::createDocument();
+    importLibraryFiles(libraryFiles, serialDoc);
+    REQUIRE(*doc == *serialDoc);
+    REQUIRE(doc->validate());
+
+    // Verify that clearing the cache causes libraries to be parsed again.
+    mx::clearLibraryCache();
+    mx::ConstDocumentPtr reloadedDoc = mx::readLibraryFile(libraryFiles[0]);
+    REQUIRE(reloadedDoc != libraryDocs[0]);
+    REQUIRE(*reloadedDoc == *libraryDocs[0]);
+
+    // Verify that a modified library is parsed again.
+    TestUtil::TemporaryDirectory tempDir;
+    mx::FilePath libraryFile = tempDir.getPath() / mx::FilePath("LoadLibrariesTest.mtlx");
+    mx::DocumentPtr writtenDoc = mx::createDocument();
+    writtenDoc->addNodeDef("ND_test1", "float", "test1");
+    mx::writeToXmlFile(writtenDoc, libraryFile);
+    TestUtil::setModificationTime(libraryFile, 1000000000);
+    mx::ConstDocumentPtr libraryDoc = mx::readLibraryFile(libraryFile);
+    REQUIRE(libraryDoc->getNodeDefs().size() == 1);
+    writtenDoc->addNodeDef("ND_test2", "float", "test2");
+    mx::writeToXmlFile(writtenDoc, libraryFile);
+    TestUtil::setModificationTime(libraryFile, 1000000001);
+    libraryDoc = mx::readLibraryFile(libraryFile);
+    REQUIRE(libraryDoc->getNodeDefs().size() == 2);
+
+    // Read a non-existent library.
+    REQUIRE_THROWS_AS(mx::readLibraryFiles({ libraryFiles[0], mx::FilePath("NonExistent.mtlx") }), mx::ExceptionFileMissing&);
+}
@@ -1,4 +1,5 @@
 #include <MaterialXView/Viewer.h>
+#include <MaterialXFormat/Util.h>
 
 #include <MaterialXGenShader/DefaultColorManagementSystem.h>
 #include <MaterialXGenShader/Shader.h>
@@ -61,7 +62,7 @@ void writeTextFile(const std::string& text, const std::string& filePath)
 
 mx::DocumentPtr loadLibraries(const mx::StringVec& libraryFolders, const mx::FileSearchPath& searchPath)
 {
-    mx::DocumentPtr doc = mx::createDocument();
+    std::vector<mx::FilePath> libraryFiles;
     for (const std::string& libraryFolder : libraryFolders)
     {
         mx::FilePath path = searchPath.find(libraryFolder);
@@ -70,15 +71,14 @@ mx::DocumentPtr loadLibraries(const mx::StringVec& libraryFolders, const mx::Fil
 
         for (const std::string& filename : filenames)
         {
-            mx::FilePath file = path / filename;
-            mx::DocumentPtr libDoc = mx::createDocument();
-            mx::readFromXmlFile(libDoc, file);
-            libDoc->setSourceUri(file);
-            mx::CopyOptions copyOptions;
-            copyOptions.skipDuplicateElements = true;
-            doc->importLibrary(libDoc, &copyOptions);
+            libraryFiles.push_back(path / filename);
         }
     }
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::CopyOptions copyOptions;
+    copyOptions.skipDuplicateElements = true;
+    mx::loadLibraries(libraryFiles, doc, &copyOptions);
     return doc;
 }
 
@@ -324,6 +324,7 @@ void Viewer::initializeDocument(mx::DocumentPtr libraries)
     setupLights(_doc, _envRadiancePath, _envIrradiancePath);
 
     // Clear state
+    _genContext.clearShaderGraphTemplates();
     _materials.clear();
     _selectedMaterial = 0;
     _materialAssignments.clear();
@@ -502,6 +503,10 @@ void Viewer::createLoadMaterialsInterface(Widget* parent, const std::string labe
                     {
                         initializeDocument(_stdLib);
                     }
+                    else
+                    {
+                        _genContext.clearShaderGraphTemplates();
+                    }
                     size_t newRenderables = Material::loadDocument(_doc, _searchPath.find(_materialFilename), _stdLib, _modifiers, _materials);
                     if (newRenderables > 0)
                     {
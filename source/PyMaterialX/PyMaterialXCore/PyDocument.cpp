@@ -17,8 +17,13 @@ void bindPyDocument(py::module& mod)
     py::class_<mx::Document, mx::DocumentPtr, mx::GraphElement>(mod, "Document")
         .def("initialize", &mx::Document::initialize)
         .def("copy", &mx::Document::copy)
+        .def("enableArenaStorage", [](mx::Document& doc) { doc.enableArenaStorage(); })
         .def("importLibrary", &mx::Document::importLibrary, 
             py::arg("library"), py::arg("copyOptions") = (const mx::CopyOptions*) nullptr)
+        .def("referenceLibrary", &mx::Document::referenceLibrary)
+        .def("getReferencedLibraries", &mx::Document::getReferencedLibraries)
+        .def("removeReferencedLibraries", &mx::Document::removeReferencedLibraries)
+        .def("findLibraryElement", &mx::Document::findLibraryElement)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getNodeGraph", &mx::Document::getNodeGraph)
@@ -42,6 +47,7 @@ void bindPyDocument(py::module& mod)
         .def("getLook", &mx::Document::getLook)
         .def("getLooks", &mx::Document::getLooks)
         .def("removeLook", &mx::Document::removeLook)
+        .def("getGeomBindingIndex", &mx::Document::getGeomBindingIndex)
         .def("addCollection", &mx::Document::addCollection,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getCollection", &mx::Document::getCollection)
@@ -51,14 +57,22 @@ void bindPyDocument(py::module& mod)
             py::arg("name") = mx::EMPTY_STRING)
         .def("getTypeDef", &mx::Document::getTypeDef)
         .def("getTypeDefs", &mx::Document::getTypeDefs)
+        .def("findLibraryTypeDef", &mx::Document::findLibraryTypeDef)
         .def("removeTypeDef", &mx::Document::removeTypeDef)
         .def("addNodeDef", &mx::Document::addNodeDef,
             py::arg("name") = mx::EMPTY_STRING, py::arg("type") = mx::DEFAULT_TYPE_STRING, py::arg("node") = mx::EMPTY_STRING)
         .def("getNodeDef", &mx::Document::getNodeDef)
         .def("getNodeDefs", &mx::Document::getNodeDefs)
+        .def("findLibraryNodeDef", &mx::Document::findLibraryNodeDef)
         .def("removeNodeDef", &mx::Document::removeNodeDef)
         .def("getMatchingNodeDefs", &mx::Document::getMatchingNodeDefs)
+        .def("findLibraryMatchingNodeDefs", &mx::Document::findLibraryMatchingNodeDefs)
+        .def("getNodeDefForNode", &mx::Document::getNodeDefForNode,
+            py::arg("node"), py::arg("target") = mx::EMPTY_STRING)
+        .def("findLibraryNodeDefForNode", &mx::Document::findLibraryNodeDefForNode,
+            py::arg("node"), py::arg("target") = mx::EMPTY_STRING)
         .def("getMatchingImplementations", &mx::Document::getMatchingImplementations)
+        .def("findLibraryMatchingImplementations", &mx::Document::findLibraryMatchingImplementations)
         .def("addPropertySet", &mx::Document::addPropertySet,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getPropertySet", &mx::Document::getPropertySet)
@@ -73,6 +87,7 @@ void bindPyDocument(py::module& mod)
             py::arg("name") = mx::EMPTY_STRING)
         .def("getImplementation", &mx::Document::getImplementation)
         .def("getImplementations", &mx::Document::getImplementations)
+        .def("findLibraryImplementation", &mx::Document::findLibraryImplementation)
         .def("removeImplementation", &mx::Document::removeImplementation)
         .def("upgradeVersion", &mx::Document::upgradeVersion)
         .def("setColorManagementSystem", &mx::Document::setColorManagementSystem)
@@ -33,7 +33,7 @@ void bindPyElement(py::module& mod)
     py::class_<mx::Element, mx::ElementPtr>(mod, "Element")
         .def(py::self == py::self)
         .def(py::self != py::self)
-        .def("setCategory", &mx::Element::setCategory)
+        .def("setCategory", static_cast<void (mx::Element::*)(const std::string&)>(&mx::Element::setCategory))
         .def("getCategory", &mx::Element::getCategory)
         .def("setName", &mx::Element::setName)
         .def("getName", &mx::Element::getName)
@@ -71,15 +71,16 @@ void bindPyElement(py::module& mod)
         .def("getVersionIntegers", &mx::Element::getVersionIntegers)
         .def("setDefaultVersion", &mx::Element::setDefaultVersion)
         .def("getDefaultVersion", &mx::Element::getDefaultVersion)
-        .def("addChildOfCategory", &mx::Element::addChildOfCategory)
+        .def("addChildOfCategory", static_cast<mx::ElementPtr (mx::Element::*)(const std::string&, const std::string&)>(&mx::Element::addChildOfCategory))
+        .def("moveChild", &mx::Element::moveChild)
         .def("_getChild", &mx::Element::getChild)
         .def("getChildren", &mx::Element::getChildren)
         .def("setChildIndex", &mx::Element::setChildIndex)
         .def("getChildIndex", &mx::Element::getChildIndex)
         .def("removeChild", &mx::Element::removeChild)
-        .def("setAttribute", &mx::Element::setAttribute)
-        .def("hasAttribute", &mx::Element::hasAttribute)
-        .def("getAttribute", &mx::Element::getAttribute)
+        .def("setAttribute", static_cast<void (mx::Element::*)(const std::string&, const std::string&)>(&mx::Element::setAttribute))
+        .def("hasAttribute", static_cast<bool (mx::Element::*)(const std::string&) const>(&mx::Element::hasAttribute))
+        .def("getAttribute", static_cast<const std::string& (mx::Element::*)(const std::string&) const>(&mx::Element::getAttribute))
         .def("getAttributeNames", &mx::Element::getAttributeNames)
         .def("removeAttribute", &mx::Element::removeAttribute)
         .def("getSelf", static_cast<mx::ElementPtr (mx::Element::*)()>(&mx::Element::getSelf))
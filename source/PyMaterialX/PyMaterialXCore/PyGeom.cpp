@@ -83,6 +83,7 @@ void bindPyGeom(py::module& mod)
         .def("getIncludeCollections", &mx::Collection::getIncludeCollections)
         .def("hasIncludeCycle", &mx::Collection::hasIncludeCycle)
         .def("matchesGeomString", &mx::Collection::matchesGeomString)
+        .def("matchesGeomStrings", &mx::Collection::matchesGeomStrings)
         .def_readonly_static("CATEGORY", &mx::Collection::CATEGORY);
 
     mod.def("geomStringsMatch", &mx::geomStringsMatch);
@@ -5,6 +5,7 @@
 
 #include <PyMaterialX/PyMaterialX.h>
 
+#include <MaterialXCore/Document.h>
 #include <MaterialXCore/Look.h>
 
 namespace py = pybind11;
@@ -70,4 +71,12 @@ void bindPyLook(py::module& mod)
         .def("setVisible", &mx::Visibility::setVisible)
         .def("getVisible", &mx::Visibility::getVisible)
         .def_readonly_static("CATEGORY", &mx::Visibility::CATEGORY);
+
+    py::class_<mx::GeomBindingIndex, std::shared_ptr<mx::GeomBindingIndex>>(mod, "GeomBindingIndex")
+        .def(py::init<mx::ConstDocumentPtr>())
+        .def("getMaterialAssigns", static_cast<std::vector<mx::MaterialAssignPtr> (mx::GeomBindingIndex::*)(const std::string&, mx::ConstMaterialPtr) const>(&mx::GeomBindingIndex::getMaterialAssigns),
+            py::arg("geom"), py::arg("material") = mx::ConstMaterialPtr())
+        .def("getMaterialAssigns", static_cast<std::vector<std::vector<mx::MaterialAssignPtr>> (mx::GeomBindingIndex::*)(const mx::StringVec&, mx::ConstMaterialPtr) const>(&mx::GeomBindingIndex::getMaterialAssigns),
+            py::arg("geoms"), py::arg("material") = mx::ConstMaterialPtr())
+        .def("getMaterialAssignCount", &mx::GeomBindingIndex::getMaterialAssignCount);
 }
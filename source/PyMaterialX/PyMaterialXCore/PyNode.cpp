@@ -34,6 +34,8 @@ void bindPyNode(py::module& mod)
         .def("getNodes", &mx::NodeGraph::getNodes,
             py::arg("category") = mx::EMPTY_STRING)
         .def("removeNode", &mx::NodeGraph::removeNode)
+        .def("getNodeDefsForNodes", &mx::GraphElement::getNodeDefsForNodes,
+            py::arg("target") = mx::EMPTY_STRING)
         .def("flattenSubgraphs", &mx::NodeGraph::flattenSubgraphs,
             py::arg("target") = mx::EMPTY_STRING)
         .def("topologicalSort", &mx::NodeGraph::topologicalSort)
@@ -19,6 +19,7 @@ void bindPyObserver(py::module& mod)
         .def("onRemoveAttribute", &mx::Observer::onSetAttribute)
         .def("onCopyContent", &mx::Observer::onCopyContent)
         .def("onClearContent", &mx::Observer::onClearContent)
+        .def("onSetChildIndex", &mx::Observer::onSetChildIndex)
         .def("onRead", &mx::Observer::onRead)
         .def("onWrite", &mx::Observer::onWrite)
         .def("onBeginUpdate", &mx::Observer::onBeginUpdate)
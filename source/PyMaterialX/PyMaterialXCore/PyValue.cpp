@@ -10,7 +10,7 @@
 #define BIND_TYPE_INSTANCE(NAME, T)                                                                         \
 py::class_<mx::TypedValue<T>, std::shared_ptr< mx::TypedValue<T> >, mx::Value>(mod, "TypedValue_" #NAME)    \
     .def("getData", &mx::TypedValue<T>::getData)                                                            \
-    .def("getValueString", &mx::TypedValue<T>::getValueString)                                              \
+    .def("getValueString", static_cast<std::string (mx::TypedValue<T>::*)() const>(&mx::TypedValue<T>::getValueString)) \
     .def_static("createValue", &mx::Value::createValue<T>)                                                  \
     .def_readonly_static("TYPE", &mx::TypedValue<T>::TYPE);
 
@@ -20,7 +20,7 @@ namespace mx = MaterialX;
 void bindPyValue(py::module& mod)
 {
     py::class_<mx::Value, mx::ValuePtr>(mod, "Value")
-        .def("getValueString", &mx::Value::getValueString)
+        .def("getValueString", static_cast<std::string (mx::Value::*)() const>(&mx::Value::getValueString))
         .def("getTypeString", &mx::Value::getTypeString)
         .def_static("createValueFromStrings", &mx::Value::createValueFromStrings);
 
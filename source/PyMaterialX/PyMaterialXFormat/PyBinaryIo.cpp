@@ -0,0 +1,26 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyBinaryIo(py::module& mod)
+{
+    mod.def("readFromBinaryFile", &mx::readFromBinaryFile,
+        py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::EMPTY_STRING);
+    mod.def("readFromBinaryString", [](mx::DocumentPtr doc, py::bytes data)
+        {
+            mx::readFromBinaryString(doc, data);
+        });
+    mod.def("writeToBinaryFile", &mx::writeToBinaryFile);
+    mod.def("writeToBinaryString", [](mx::DocumentPtr doc)
+        {
+            return py::bytes(mx::writeToBinaryString(doc));
+        });
+}
@@ -36,7 +36,8 @@ void bindPyFile(py::module& mod)
         .def("isEmpty", &mx::FilePath::isEmpty)
         .def("isAbsolute", &mx::FilePath::isAbsolute)
         .def("getBaseName", &mx::FilePath::getBaseName)
-        .def("exists", &mx::FilePath::exists);
+        .def("exists", &mx::FilePath::exists)
+        .def("getModificationTime", &mx::FilePath::getModificationTime);
 
     mod.attr("PATH_LIST_SEPARATOR") = mx::PATH_LIST_SEPARATOR;
     mod.attr("MATERIALX_SEARCH_PATH_ENV_VAR") = mx::MATERIALX_SEARCH_PATH_ENV_VAR;
@@ -0,0 +1,20 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXFormat/Util.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyUtil(py::module& mod)
+{
+    mod.def("readLibraryFile", &mx::readLibraryFile);
+    mod.def("readLibraryFiles", &mx::readLibraryFiles);
+    mod.def("loadLibraries", &mx::loadLibraries,
+        py::arg("files"), py::arg("doc"), py::arg("copyOptions") = (mx::CopyOptions*) nullptr);
+    mod.def("clearLibraryCache", &mx::clearLibraryCache);
+}
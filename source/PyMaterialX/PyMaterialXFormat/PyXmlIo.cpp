@@ -16,7 +16,12 @@ void bindPyXmlIo(py::module& mod)
     py::class_<mx::XmlReadOptions, mx::CopyOptions>(mod, "XmlReadOptions")
         .def(py::init())
         .def_readwrite("readXIncludeFunction", &mx::XmlReadOptions::readXIncludeFunction)
-        .def_readwrite("parentFilenames", &mx::XmlReadOptions::parentFilenames);
+        .def_readwrite("parentFilenames", &mx::XmlReadOptions::parentFilenames)
+        .def_readwrite("xincludeCache", &mx::XmlReadOptions::xincludeCache);
+
+    py::class_<mx::XIncludeCache, mx::XIncludeCachePtr>(mod, "XIncludeCache")
+        .def(py::init())
+        .def("getReadCount", &mx::XIncludeCache::getReadCount);
 
     py::class_<mx::XmlWriteOptions>(mod, "XmlWriteOptions")
         .def(py::init())
@@ -27,6 +32,8 @@ void bindPyXmlIo(py::module& mod)
         py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::EMPTY_STRING, py::arg("readOptions") = (mx::XmlReadOptions*) nullptr);
     mod.def("readFromXmlString", &mx::readFromXmlString,
         py::arg("doc"), py::arg("str"), py::arg("readOptions") = (mx::XmlReadOptions*) nullptr);
+    mod.def("readFromXmlFileIncremental", &mx::readFromXmlFileIncremental,
+        py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::EMPTY_STRING, py::arg("readOptions") = (mx::XmlReadOptions*) nullptr);
     mod.def("writeToXmlFile", mx::writeToXmlFile,
         py::arg("doc"), py::arg("filename"), py::arg("writeOptions") = (mx::XmlWriteOptions*) nullptr);
     mod.def("writeToXmlString", mx::writeToXmlString,
@@ -16,6 +16,7 @@ void bindPyHwShaderGenerator(py::module& mod);
 void bindPyGenOptions(py::module& mod);
 void bindPyShaderStage(py::module& mod);
 void bindPyUtil(py::module& mod);
+void bindPyShaderCache(py::module& mod);
 
 PYBIND11_MODULE(PyMaterialXGenShader, mod)
 {
@@ -30,4 +31,5 @@ PYBIND11_MODULE(PyMaterialXGenShader, mod)
     bindPyGenOptions(mod);
     bindPyShaderStage(mod);
     bindPyUtil(mod);
+    bindPyShaderCache(mod);
 }
@@ -0,0 +1,29 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyShaderCache(py::module& mod)
+{
+    py::class_<mx::ShaderCache, mx::ShaderCachePtr>(mod, "ShaderCache")
+        .def_static("create", &mx::ShaderCache::create,
+            py::arg("directory") = mx::FilePath(), py::arg("salt") = mx::EMPTY_STRING)
+        .def(py::init<const mx::FilePath&, const std::string&>(),
+            py::arg("directory") = mx::FilePath(), py::arg("salt") = mx::EMPTY_STRING)
+        .def("getDirectory", &mx::ShaderCache::getDirectory)
+        .def("getKey", &mx::ShaderCache::getKey)
+        .def("getShader", &mx::ShaderCache::getShader)
+        .def("getSourceCode", &mx::ShaderCache::getSourceCode)
+        .def("getFileHash", &mx::ShaderCache::getFileHash)
+        .def("clear", &mx::ShaderCache::clear)
+        .def("getMemoryHitCount", &mx::ShaderCache::getMemoryHitCount)
+        .def("getDiskHitCount", &mx::ShaderCache::getDiskHitCount)
+        .def("getMissCount", &mx::ShaderCache::getMissCount);
+}